@@ -81,12 +81,14 @@ class GenXlaLazyNativeFuncDefinition(GenLazyNativeFuncDefinition):
   def shape_inference(self, func: NativeFunction, schema: LazyIrSchema) -> str:
     return ""
 
+  # Nodes go through MakeXlaNode so that they come out of the NodePool when
+  # XLA_IR_NODE_POOL is set.
   def build_ir_node(self, func: NativeFunction, schema: LazyIrSchema) -> str:
     node_ctor_input_str = node_ctor_inputs(schema)
     return f"""torch::lazy::NodePtr node = torch::lazy::ReuseNode<{schema.node_name}>({node_ctor_input_str});
       if (!node) {{
           {self.shape_inference(func, schema)}
-          node = torch::lazy::MakeNode<{schema.node_name}>({node_ctor_input_str});
+          node = MakeXlaNode<{schema.node_name}>({node_ctor_input_str});
           CacheNode(node);
       }}
       """
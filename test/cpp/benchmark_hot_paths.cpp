@@ -0,0 +1,421 @@
+// Microbenchmarks of the host side hot paths of a training step: tracing,
+// hashing, post order, lowering, data transfers and the element type and
+// layout conversions they do, cache lookups and metrics.
+// They run on whatever PJRT_DEVICE is set, the CPU plugin being the reference
+// for tracking regressions across releases:
+//
+//   PJRT_DEVICE=CPU bazel run //test/cpp:benchmark_hot_paths -- \
+//     --benchmark_format=json --benchmark_out=hot_paths.json
+
+#include <benchmark/benchmark.h>
+#include <torch/csrc/lazy/core/util.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "torch_xla/csrc/aten_xla_bridge.h"
+#include "torch_xla/csrc/ir.h"
+#include "torch_xla/csrc/lowering_context.h"
+#include "torch_xla/csrc/ops/arithmetic_ir_ops.h"
+#include "torch_xla/csrc/ops/ops.h"
+#include "torch_xla/csrc/runtime/cache.h"
+#include "torch_xla/csrc/runtime/convert_kernels.h"
+#include "torch_xla/csrc/runtime/metrics.h"
+#include "torch_xla/csrc/runtime/tiled_copy.h"
+#include "torch_xla/csrc/runtime/xla_util.h"
+#include "torch_xla/csrc/tensor_util.h"
+#include "torch_xla/csrc/xla_backend_impl.h"
+#include "tsl/platform/bfloat16.h"
+#include "xla/shape_util.h"
+#include "xla/types.h"
+
+namespace torch_xla {
+namespace cpp_test {
+namespace {
+
+static bool xla_backend_inited = InitXlaBackend();
+
+// Builds a chain of num_nodes additions of scalars, the shape of a traced
+// elementwise graph.
+torch::lazy::Value BuildAddChain(int64_t num_nodes) {
+  torch::lazy::Value value(ScalarOp(1.0, xla::F32), 0);
+  for (int64_t i = 1; i < num_nodes; i += 2) {
+    value = torch::lazy::Value(
+        value + torch::lazy::Value(ScalarOp(static_cast<double>(i), xla::F32)),
+        0);
+  }
+  return value;
+}
+
+std::vector<const torch::lazy::Node*> PostOrder(
+    const torch::lazy::Value& root) {
+  std::vector<const torch::lazy::Node*> roots = {root.node.get()};
+  return torch::lazy::Util::ComputePostOrder(roots);
+}
+
+void BM_IrNodeConstruction(benchmark::State& state) {
+  for (auto _ : state) {
+    torch::lazy::Value root = BuildAddChain(state.range(0));
+    benchmark::DoNotOptimize(root.node);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IrNodeConstruction)->Arg(64)->Arg(1024)->Arg(16384);
+
+// Recomputes the node hash of existing nodes the way XlaNode does when it is
+// constructed: op and shape, then the operand hashes.
+void BM_XlaNodeHash(benchmark::State& state) {
+  torch::lazy::Value root = BuildAddChain(state.range(0));
+  std::vector<const torch::lazy::Node*> post_order = PostOrder(root);
+  for (auto _ : state) {
+    for (const torch::lazy::Node* node : post_order) {
+      const XlaNode* xla_node = dynamic_cast<const XlaNode*>(node);
+      torch::lazy::hash_t hash = torch::lazy::HashCombine(
+          node->op().hash(),
+          runtime::util::ShapeHash(xla_node->xla_shape()));
+      for (const torch::lazy::Output& operand : node->operands()) {
+        hash = torch::lazy::HashCombine(hash, operand.hash());
+      }
+      benchmark::DoNotOptimize(hash);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * post_order.size());
+}
+BENCHMARK(BM_XlaNodeHash)->Arg(1024)->Arg(16384);
+
+// Typical shapes of the nodes of a transformer layer.
+const std::vector<xla::Shape>& TransformerShapes() {
+  static const std::vector<xla::Shape>* shapes = []() {
+    xla::Shape activations =
+        xla::ShapeUtil::MakeShape(xla::PrimitiveType::BF16, {8, 2048, 4096});
+    xla::Shape scalar = xla::ShapeUtil::MakeShape(xla::PrimitiveType::F32, {});
+    return new std::vector<xla::Shape>(
+        {activations,
+         xla::ShapeUtil::MakeShape(xla::PrimitiveType::BF16, {4096, 4096}),
+         scalar,
+         xla::ShapeUtil::MakeShape(xla::PrimitiveType::F32,
+                                   {8, 32, 2048, 2048}),
+         xla::ShapeUtil::MakeTupleShape({activations, scalar})});
+  }();
+  return *shapes;
+}
+
+// Hashing shape.ToString(), which is what the IR nodes used to do.
+void BM_ShapeStringHash(benchmark::State& state) {
+  const std::vector<xla::Shape>& shapes = TransformerShapes();
+  for (auto _ : state) {
+    for (const xla::Shape& shape : shapes) {
+      benchmark::DoNotOptimize(torch::lazy::Hash(shape.ToString()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.size());
+}
+BENCHMARK(BM_ShapeStringHash);
+
+void BM_ShapeHash(benchmark::State& state) {
+  const std::vector<xla::Shape>& shapes = TransformerShapes();
+  for (auto _ : state) {
+    for (const xla::Shape& shape : shapes) {
+      benchmark::DoNotOptimize(runtime::util::ShapeHash(shape));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.size());
+}
+BENCHMARK(BM_ShapeHash);
+
+void BM_RunPostOrder(benchmark::State& state) {
+  torch::lazy::Value root = BuildAddChain(state.range(0));
+  for (auto _ : state) {
+    std::vector<const torch::lazy::Node*> post_order = PostOrder(root);
+    benchmark::DoNotOptimize(post_order.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RunPostOrder)->Arg(1024)->Arg(16384);
+
+void BM_Lowering(benchmark::State& state) {
+  const torch::lazy::BackendDevice& device = *bridge::GetDefaultDevice();
+  torch::lazy::Value root = BuildAddChain(state.range(0));
+  for (auto _ : state) {
+    torch::lazy::Util::EmissionMap emit_status;
+    std::vector<const torch::lazy::Node*> roots = {root.node.get()};
+    std::vector<const torch::lazy::Node*> post_order =
+        torch::lazy::Util::ComputePostOrder(roots, &emit_status);
+    LoweringContext lowering_ctx("BenchmarkLowering", device, post_order,
+                                 std::move(emit_status));
+    lowering_ctx.AddResult(torch::lazy::Output(root.node.get(), 0));
+    xla::XlaComputation computation = lowering_ctx.BuildXla().value();
+    benchmark::DoNotOptimize(computation);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Lowering)->Arg(64)->Arg(1024);
+
+void BM_TensorToXlaData(benchmark::State& state) {
+  const torch::lazy::BackendDevice& device = *bridge::GetDefaultDevice();
+  at::Tensor tensor = at::rand({state.range(0)}, at::kFloat);
+  for (auto _ : state) {
+    torch::lazy::BackendDataPtr data = TensorToXlaData(tensor, device);
+    benchmark::DoNotOptimize(data);
+  }
+  state.SetBytesProcessed(state.iterations() * tensor.nbytes());
+}
+BENCHMARK(BM_TensorToXlaData)->Arg(1)->Arg(1 << 10)->Arg(1 << 20);
+
+void BM_XlaDataToTensors(benchmark::State& state) {
+  const torch::lazy::BackendDevice& device = *bridge::GetDefaultDevice();
+  at::Tensor tensor = at::rand({state.range(0)}, at::kFloat);
+  std::vector<torch::lazy::BackendDataPtr> data = {
+      TensorToXlaData(tensor, device)};
+  for (auto _ : state) {
+    std::vector<at::Tensor> tensors = XlaDataToTensors(data, {at::kFloat});
+    benchmark::DoNotOptimize(tensors);
+  }
+  state.SetBytesProcessed(state.iterations() * tensor.nbytes());
+}
+BENCHMARK(BM_XlaDataToTensors)->Arg(1)->Arg(1 << 10)->Arg(1 << 20);
+
+// The argument of the conversion benchmarks selecting the per element
+// static_cast<> loop rather than one of the runtime::ConvertIsa kernels.
+constexpr int64_t kStaticCastLoop = -1;
+
+// Converts S to D with the kernel of the ISA given by the benchmark argument,
+// where KS/KD are the types the kernel is declared with.
+template <typename S, typename D, typename KS, typename KD>
+void RunConvert(benchmark::State& state,
+                void (*runtime::ConvertKernels::*kernel)(const KS*, KD*,
+                                                         int64_t)) {
+  static_assert(sizeof(S) == sizeof(KS) && sizeof(D) == sizeof(KD),
+                "Kernel types size mismatch");
+  constexpr int64_t kNumElements = 4 << 20;
+  // Not std::vector, whose bool specialization is not contiguous.
+  std::unique_ptr<S[]> src(new S[kNumElements]());
+  std::unique_ptr<D[]> dest(new D[kNumElements]());
+  if (state.range(0) == kStaticCastLoop) {
+    state.SetLabel("static_cast");
+    for (auto _ : state) {
+      for (int64_t i = 0; i < kNumElements; ++i) {
+        dest[i] = static_cast<D>(src[i]);
+      }
+      benchmark::DoNotOptimize(dest.get());
+    }
+  } else {
+    auto isa = static_cast<runtime::ConvertIsa>(state.range(0));
+    if (!runtime::IsConvertIsaSupported(isa)) {
+      state.SkipWithError("ISA not supported by the host");
+      return;
+    }
+    state.SetLabel(runtime::ConvertIsaName(isa));
+    auto fn = runtime::GetConvertKernels(isa).*kernel;
+    for (auto _ : state) {
+      fn(reinterpret_cast<const KS*>(src.get()),
+         reinterpret_cast<KD*>(dest.get()), kNumElements);
+      benchmark::DoNotOptimize(dest.get());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumElements);
+}
+
+void BM_ConvertF32ToBF16(benchmark::State& state) {
+  RunConvert<float, tsl::bfloat16>(
+      state, &runtime::ConvertKernels::float_to_bfloat16);
+}
+void BM_ConvertBF16ToF32(benchmark::State& state) {
+  RunConvert<tsl::bfloat16, float>(
+      state, &runtime::ConvertKernels::bfloat16_to_float);
+}
+void BM_ConvertF32ToF16(benchmark::State& state) {
+  RunConvert<float, xla::half>(state, &runtime::ConvertKernels::float_to_half);
+}
+void BM_ConvertF16ToF32(benchmark::State& state) {
+  RunConvert<xla::half, float>(state, &runtime::ConvertKernels::half_to_float);
+}
+void BM_ConvertF64ToF32(benchmark::State& state) {
+  RunConvert<double, float>(state, &runtime::ConvertKernels::double_to_float);
+}
+void BM_ConvertS64ToS32(benchmark::State& state) {
+  RunConvert<int64_t, int32_t>(state,
+                               &runtime::ConvertKernels::int64_to_int32);
+}
+void BM_ConvertU8ToPred(benchmark::State& state) {
+  RunConvert<uint8_t, bool>(state, &runtime::ConvertKernels::uint8_to_bool);
+}
+
+void ConvertArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("isa")->Arg(kStaticCastLoop);
+  for (runtime::ConvertIsa isa :
+       {runtime::ConvertIsa::kScalar, runtime::ConvertIsa::kAvx2,
+        runtime::ConvertIsa::kAvx512}) {
+    benchmark->Arg(static_cast<int64_t>(isa));
+  }
+}
+BENCHMARK(BM_ConvertF32ToBF16)->Apply(ConvertArgs);
+BENCHMARK(BM_ConvertBF16ToF32)->Apply(ConvertArgs);
+BENCHMARK(BM_ConvertF32ToF16)->Apply(ConvertArgs);
+BENCHMARK(BM_ConvertF16ToF32)->Apply(ConvertArgs);
+BENCHMARK(BM_ConvertF64ToF32)->Apply(ConvertArgs);
+BENCHMARK(BM_ConvertS64ToS32)->Apply(ConvertArgs);
+BENCHMARK(BM_ConvertU8ToPred)->Apply(ConvertArgs);
+
+// Layout changing copies of image and embedding shapes.
+struct LayoutCopyCase {
+  const char* name;
+  std::vector<int64_t> dimensions;
+  std::vector<int64_t> src_minor_to_major;
+  std::vector<int64_t> dest_minor_to_major;
+};
+
+const std::vector<LayoutCopyCase>& LayoutCopyCases() {
+  static const std::vector<LayoutCopyCase>* cases =
+      new std::vector<LayoutCopyCase>({
+          {"NCHW->NHWC 32x3x224x224",
+           {32, 3, 224, 224},
+           {3, 2, 1, 0},
+           {1, 3, 2, 0}},
+          {"NCHW->NHWC 32x64x56x56",
+           {32, 64, 56, 56},
+           {3, 2, 1, 0},
+           {1, 3, 2, 0}},
+          {"NHWC->NCHW 32x64x56x56",
+           {32, 64, 56, 56},
+           {1, 3, 2, 0},
+           {3, 2, 1, 0}},
+          {"embedding^T 32768x1024", {32768, 1024}, {1, 0}, {0, 1}},
+      });
+  return *cases;
+}
+
+std::vector<int64_t> LayoutStrides(const std::vector<int64_t>& dimensions,
+                                   const std::vector<int64_t>& minor_to_major) {
+  std::vector<int64_t> strides(dimensions.size());
+  int64_t stride = 1;
+  for (int64_t dim : minor_to_major) {
+    strides[dim] = stride;
+    stride *= dimensions[dim];
+  }
+  return strides;
+}
+
+// Walks the destination layout from its most minor dimension, doing strided
+// copies from the source, which is what the tensor copies used to do.
+void StridedWalk(const LayoutCopyCase& c, const float* src, float* dest) {
+  std::vector<int64_t> src_strides =
+      LayoutStrides(c.dimensions, c.src_minor_to_major);
+  std::vector<int64_t> dest_strides =
+      LayoutStrides(c.dimensions, c.dest_minor_to_major);
+  const std::vector<int64_t>& iter_dims = c.dest_minor_to_major;
+  int64_t inner_dim = iter_dims.front();
+  std::vector<int64_t> indices(c.dimensions.size(), 0);
+  size_t n = 0;
+  while (n < indices.size()) {
+    int64_t src_offset = 0;
+    int64_t dest_offset = 0;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      src_offset += indices[i] * src_strides[i];
+      dest_offset += indices[i] * dest_strides[i];
+    }
+    for (int64_t i = 0; i < c.dimensions[inner_dim]; ++i) {
+      dest[dest_offset + i * dest_strides[inner_dim]] =
+          src[src_offset + i * src_strides[inner_dim]];
+    }
+    for (n = 1; n < indices.size(); ++n) {
+      int64_t dim = iter_dims[n];
+      if (++indices[dim] < c.dimensions[dim]) {
+        break;
+      }
+      indices[dim] = 0;
+    }
+  }
+}
+
+// Arguments are the index of the case and the tile size, 0 running the
+// strided walk instead of the tiled copy.
+void BM_LayoutCopy(benchmark::State& state) {
+  const LayoutCopyCase& c = LayoutCopyCases()[state.range(0)];
+  int64_t tile_size = state.range(1);
+  int64_t num_elements = 1;
+  for (int64_t size : c.dimensions) {
+    num_elements *= size;
+  }
+  std::vector<float> src(num_elements, 1.0f);
+  std::vector<float> dest(num_elements);
+  state.SetLabel(c.name);
+  if (tile_size == 0) {
+    for (auto _ : state) {
+      StridedWalk(c, src.data(), dest.data());
+      benchmark::DoNotOptimize(dest.data());
+    }
+  } else {
+    runtime::TiledCopyPlan plan(
+        c.dimensions, LayoutStrides(c.dimensions, c.src_minor_to_major),
+        LayoutStrides(c.dimensions, c.dest_minor_to_major), tile_size);
+    int64_t src_stride = plan.row_src_stride();
+    int64_t dest_stride = plan.row_dest_stride();
+    for (auto _ : state) {
+      plan.ForEachRow(0, plan.num_tiles(),
+                      [&](int64_t dest_offset, int64_t src_offset, int64_t n) {
+                        for (int64_t i = 0; i < n; ++i) {
+                          dest[dest_offset + i * dest_stride] =
+                              src[src_offset + i * src_stride];
+                        }
+                      });
+      benchmark::DoNotOptimize(dest.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * num_elements * sizeof(float));
+}
+BENCHMARK(BM_LayoutCopy)
+    ->ArgNames({"case", "tile_size"})
+    ->ArgsProduct({{0, 1, 2, 3}, {0, 16, 32, 64}});
+
+// Hits on the cache kinds used for the compiled graphs, from several threads.
+template <typename CacheType>
+void BM_CacheHit(benchmark::State& state) {
+  constexpr int kNumKeys = 2048;
+  static CacheType* cache = nullptr;
+  if (state.thread_index() == 0) {
+    cache = new CacheType(kNumKeys);
+    for (int i = 0; i < kNumKeys; ++i) {
+      cache->Add(i, std::make_shared<std::string>(std::to_string(i)));
+    }
+  }
+  unsigned key = state.thread_index() * 7919;
+  for (auto _ : state) {
+    key = key * 1103515245 + 12345;
+    benchmark::DoNotOptimize(cache->Get(key % kNumKeys));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete cache;
+  }
+}
+BENCHMARK_TEMPLATE(BM_CacheHit, runtime::util::Cache<int, std::string>)
+    ->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(BM_CacheHit,
+                   runtime::util::ConcurrentCache<int, std::string>)
+    ->ThreadRange(1, 8);
+
+void BM_MetricAddSample(benchmark::State& state) {
+  static runtime::metrics::MetricData* data = nullptr;
+  if (state.thread_index() == 0) {
+    data = new runtime::metrics::MetricData(
+        runtime::metrics::MetricFnValue, /*max_samples=*/1024,
+        /*lifetime_histogram=*/state.range(0) != 0);
+  }
+  int64_t timestamp_ns = 0;
+  for (auto _ : state) {
+    data->AddSample(++timestamp_ns, 1000.0);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete data;
+  }
+}
+BENCHMARK(BM_MetricAddSample)->ArgName("lifetime_histogram")->Arg(0)->Arg(1)
+    ->ThreadRange(1, 8);
+
+}  // namespace
+}  // namespace cpp_test
+}  // namespace torch_xla
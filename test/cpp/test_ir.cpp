@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
+#include <torch/csrc/lazy/core/metrics.h>
 
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "test/cpp/cpp_test_util.h"
 #include "test/cpp/torch_xla_test.h"
@@ -15,6 +18,7 @@
 #include "torch_xla/csrc/ops/select.h"
 #include "torch_xla/csrc/ops/unselect.h"
 #include "torch_xla/csrc/ops/update_slice.h"
+#include "xla/shape_util.h"
 
 namespace torch_xla {
 namespace cpp_test {
@@ -51,6 +55,19 @@ TEST_F(IrTest, TestHash) {
   EXPECT_NE(add1->hash(), sub->hash());
 }
 
+TEST_F(IrTest, TestHashIgnoresLayout) {
+  xla::Shape row_major = xla::ShapeUtil::MakeShapeWithDenseLayout(
+      xla::PrimitiveType::F32, {2, 3}, /*minor_to_major=*/{1, 0});
+  xla::Shape column_major = xla::ShapeUtil::MakeShapeWithDenseLayout(
+      xla::PrimitiveType::F32, {2, 3}, /*minor_to_major=*/{0, 1});
+  torch::lazy::NodePtr scalar1 = ScalarOp(1.0, row_major);
+  torch::lazy::NodePtr scalar2 = ScalarOp(1.0, column_major);
+  torch::lazy::NodePtr scalar3 =
+      ScalarOp(1.0, xla::ShapeUtil::MakeShape(xla::PrimitiveType::F32, {3, 2}));
+  EXPECT_EQ(scalar1->hash(), scalar2->hash());
+  EXPECT_NE(scalar1->hash(), scalar3->hash());
+}
+
 TEST_F(IrTest, TestSelectUnselect) {
   ForEachDevice([&](const torch::lazy::BackendDevice& device) {
     at::Tensor a =
@@ -361,5 +378,47 @@ TEST_F(IrTest, TestSizeDivNodeDynamicByZero) {
   EXPECT_THROW(dim_node_div->getDynamicValue(), std::runtime_error);
 }
 
+TEST_F(IrTest, TestNodePool) {
+  auto counter_value = [](const std::string& name) -> int64_t {
+    torch::lazy::CounterData* counter = torch::lazy::GetCounter(name);
+    return counter != nullptr ? counter->Value() : 0;
+  };
+  // Start from a fresh chunk, so that the ones below only hold these nodes.
+  NodePool::MarkStep();
+  int64_t allocations = counter_value("IrNodePoolAllocations");
+  int64_t chunks = counter_value("IrNodePoolChunks");
+  int64_t released_chunks = counter_value("IrNodePoolReleasedChunks");
+
+  std::vector<torch::lazy::NodePtr> nodes;
+  for (int i = 0; i < 1000; ++i) {
+    nodes.push_back(std::allocate_shared<Scalar>(
+        NodePoolAllocator<Scalar>(), static_cast<double>(i), xla::F32));
+  }
+  int64_t new_chunks = counter_value("IrNodePoolChunks") - chunks;
+  EXPECT_GT(new_chunks, 1);
+  // The current chunk is held by the arena until the step is marked.
+  nodes.pop_back();
+  EXPECT_EQ(counter_value("IrNodePoolReleasedChunks") - released_chunks, 0);
+
+  torch::lazy::NodePtr survivor = nodes[10];
+  NodePool::MarkStep();
+  // The allocations are counted as their chunk is handed over.
+  EXPECT_EQ(counter_value("IrNodePoolAllocations") - allocations, 1000);
+  nodes.clear();
+  // Every chunk but the one of the surviving node went back to the system,
+  // and the surviving node is still valid.
+  EXPECT_EQ(counter_value("IrNodePoolReleasedChunks") - released_chunks,
+            new_chunks - 1);
+  torch::lazy::NodePtr scalar = ScalarOp(10.0, xla::F32);
+  EXPECT_EQ(survivor->hash(), scalar->hash());
+
+  survivor.reset();
+  EXPECT_EQ(counter_value("IrNodePoolReleasedChunks") - released_chunks,
+            new_chunks);
+
+  torch::lazy::NodePtr pooled = MakeXlaNode<Scalar>(10.0, xla::F32);
+  EXPECT_EQ(pooled->hash(), scalar->hash());
+}
+
 }  // namespace cpp_test
 }  // namespace torch_xla
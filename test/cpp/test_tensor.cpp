@@ -1,13 +1,17 @@
 #include <ATen/ATen.h>
 #include <gtest/gtest.h>
 
+#include <future>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include "test/cpp/cpp_test_util.h"
 #include "test/cpp/torch_xla_test.h"
 #include "torch/csrc/autograd/variable.h"
 #include "torch_xla/csrc/aten_xla_bridge.h"
+#include "torch_xla/csrc/runtime/runtime.h"
+#include "torch_xla/csrc/runtime/tensor_source.h"
 #include "torch_xla/csrc/tensor.h"
 #include "torch_xla/csrc/tensor_methods.h"
 #include "torch_xla/csrc/tensor_util.h"
@@ -87,6 +91,43 @@ TEST_F(TensorTest, TestAdd) {
   });
 }
 
+TEST_F(TensorTest, TestTransferToDeviceAsyncSnapshotsSource) {
+  ForEachDevice([&](const torch::lazy::BackendDevice& device) {
+    // A double tensor is converted by the AtenSource before its transfer.
+    at::Tensor tensor = at::rand({64, 64}, at::TensorOptions(at::kDouble));
+    at::Tensor expected = tensor.clone();
+    xla::Shape shape = CreateComputationShapeFromTensor(tensor, &device);
+    std::vector<std::shared_ptr<const runtime::TensorSource>> sources = {
+        std::make_shared<runtime::AtenSource>(tensor, std::move(shape),
+                                              device.toString())};
+    std::vector<std::shared_future<runtime::ComputationClient::DataPtr>>
+        futures = runtime::GetComputationClient()->TransferToDeviceAsync(
+            std::move(sources));
+    // Modifying the tensor once the call returned does not change the upload.
+    tensor.fill_(0);
+    std::vector<at::Tensor> results =
+        XlaDataToTensors({futures[0].get()}, {at::kDouble});
+    AllClose(results[0], expected);
+  });
+}
+
+TEST_F(TensorTest, TestTransferToDeviceConvertKernel) {
+  ForEachDevice([&](const torch::lazy::BackendDevice& device) {
+    at::Tensor tensor = at::rand({128, 64}, at::TensorOptions(at::kFloat));
+    xla::Shape shape =
+        xla::ShapeUtil::MakeShape(xla::PrimitiveType::BF16, {128, 64});
+    std::vector<std::shared_ptr<const runtime::TensorSource>> sources = {
+        std::make_shared<runtime::AtenSource>(tensor, std::move(shape),
+                                              device.toString())};
+    std::vector<runtime::ComputationClient::DataPtr> datas =
+        runtime::GetComputationClient()->TransferToDevice(sources);
+    std::vector<at::Tensor> results =
+        XlaDataToTensors({datas[0]}, {at::kBFloat16});
+    EXPECT_TRUE(torch::equal(results[0], tensor.to(at::kBFloat16)));
+  });
+  ExpectCounterChanged("AtenSourceConvertKernel", GetIgnoredCounters());
+}
+
 TEST_F(TensorTest, TestIntegerAdd) {
   std::vector<at::ScalarType> types(
       {at::kByte, at::kChar, at::kShort, at::kInt, at::kLong});
@@ -222,6 +222,35 @@ TEST_F(XLAShardingTest, ShardTensor) {
   EXPECT_EQ(shards[7].sizes(), c10::ArrayRef<long>({10, 1, 4, 4, 2}));
 }
 
+TEST_F(XLAShardingTest, ShardTensorValues) {
+  std::vector<std::string> devices = {"TPU:0", "TPU:1", "TPU:2", "TPU:3",
+                                      "TPU:4", "TPU:5", "TPU:6", "TPU:7"};
+  at::Tensor tensor =
+      at::arange(5 * 7 * 3, at::TensorOptions(at::kFloat)).reshape({5, 7, 3});
+  xla::Shape tensor_shape =
+      CreateComputationShapeFromTensor(tensor, bridge::GetDefaultDevice());
+  // The second dim is split in 4 and the last in 2, both unevenly.
+  xla::Array3D<int64_t> cube({{{0, 1}, {2, 3}, {4, 5}, {6, 7}}});
+  auto sharding_spec = std::make_shared<XLATensor::ShardingSpec>(
+      xla::HloSharding::Tile(cube).ToProto(), tensor_shape);
+  auto shards = ShardingUtil::ShardTensor(tensor, sharding_spec, devices,
+                                          /*padded=*/true);
+  ASSERT_EQ(shards.size(), 8);
+  for (int64_t i = 0; i < shards.size(); ++i) {
+    ASSERT_EQ(shards[i].sizes(), c10::ArrayRef<long>({5, 2, 2}));
+    EXPECT_TRUE(shards[i].is_contiguous());
+    int64_t start1 = (i / 2) * 2;
+    int64_t size1 = std::min<int64_t>(2, 7 - start1);
+    int64_t start2 = (i % 2) * 2;
+    int64_t size2 = std::min<int64_t>(2, 3 - start2);
+    at::Tensor expected = at::zeros({5, 2, 2}, at::TensorOptions(at::kFloat));
+    expected.narrow(1, 0, size1)
+        .narrow(2, 0, size2)
+        .copy_(tensor.narrow(1, start1, size1).narrow(2, start2, size2));
+    EXPECT_TRUE(at::equal(shards[i], expected)) << "shard " << i;
+  }
+}
+
 TEST_F(XLAShardingTest, ShardTensorMultiHost) {
   std::vector<std::string> devices = {"TPU:4", "TPU:5", "TPU:6", "TPU:7"};
 
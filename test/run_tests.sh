@@ -174,6 +174,7 @@ function run_xla_op_tests1 {
   run_test "$CDIR/test_python_ops.py"
   run_test "$CDIR/test_ops.py"
   run_test "$CDIR/test_metrics.py"
+  XLA_CPU_FALLBACK_HOST_RESULTS=1 run_test "$CDIR/test_metrics.py" MetricsTest.test_cpu_fallback_host_copies
   run_test "$CDIR/dynamo/test_dynamo_integrations_util.py"
   run_test "$CDIR/dynamo/test_dynamo_aliasing.py"
   run_test "$CDIR/dynamo/test_dynamo.py"
@@ -216,6 +217,7 @@ function run_xla_op_tests3 {
   run_test "$CDIR/quantized_ops/test_quantized_matmul.py"
   run_test "$CDIR/spmd/test_xla_sharding.py"
   run_test "$CDIR/spmd/test_xla_sharding_hlo.py"
+  run_test "$CDIR/spmd/test_host_shard_reassembly.py"
   run_test "$CDIR/spmd/test_xla_virtual_device.py"
   run_test "$CDIR/spmd/test_dynamo_spmd.py"
   run_test "$CDIR/spmd/test_spmd_debugging.py"
@@ -229,6 +231,14 @@ function run_xla_op_tests3 {
   run_test "$CDIR/test_torch_distributed_xla_backend.py"
   run_torchrun "$CDIR/pjrt/test_torchrun.py"
   run_test "$CDIR/test_persistent_cache.py"
+  run_test "$CDIR/test_async_compilation.py"
+  run_pt_xla_debug "$CDIR/test_async_compilation.py" AsyncCompilationTest.test_async_compile_execution_analysis
+  run_test "$CDIR/test_incremental_post_order.py"
+  run_test "$CDIR/test_zero_copy_transfer.py"
+  run_test "$CDIR/test_device_constant_pool.py"
+  XLA_CONSTANT_POOL_MAX_TENSOR_BYTES=4096 run_test "$CDIR/test_device_constant_pool.py"
+  run_test "$CDIR/test_async_transfer.py"
+  run_test "$CDIR/test_step_timeline.py"
   run_test "$CDIR/test_devices.py"
   run_device_detection_test "$CDIR/test_gpu_device_detection.py"
   # NOTE: this line below is testing export and don't care about GPU
@@ -0,0 +1,58 @@
+import os
+import sys
+
+import unittest
+
+# Must be set before the first transfer from the devices reads it.
+os.environ['XLA_HOST_SHARD_REASSEMBLY'] = '1'
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+import torch_xla.debug.metrics as met
+import torch_xla.distributed.spmd as xs
+import test_xla_sharding_base
+
+
+class HostShardReassemblyTest(test_xla_sharding_base.XlaShardingTest):
+
+  def _check_reassembled(self, t, mesh, partition_spec):
+    xt = t.to(xm.xla_device())
+    xs.mark_sharding(xt, mesh, partition_spec)
+    met.clear_all()
+    self.assertTrue(torch.equal(xt.cpu(), t))
+    if self.n_devices > 1:
+      self.assertEqual(met.counter_value("ReassembleShardsOnHost"), 1)
+      self.assertIsNone(met.counter_value("ReplicateShardedData"))
+
+  def test_tiled_2d(self):
+    t = torch.arange(16 * 8, dtype=torch.float32).reshape(16, 8)
+    self._check_reassembled(t, self._get_mesh((1, self.n_devices)), (0, 1))
+    self._check_reassembled(t, self._get_mesh((self.n_devices, 1)), (0, 1))
+
+  def test_uneven_shards(self):
+    # The trailing shards are padded on the devices.
+    t = torch.arange(3 * (self.n_devices + 1)).reshape(3, -1)
+    self._check_reassembled(t, self._get_mesh((1, self.n_devices)), (0, 1))
+
+  def test_partial_replication(self):
+    if self.n_devices < 4 or self.n_devices % 2 != 0:
+      self.skipTest("needs a 2D mesh")
+    t = torch.randn(8, 4, 6)
+    mesh = self._get_mesh((2, self.n_devices // 2))
+    self._check_reassembled(t, mesh, (None, 0, None))
+
+  def test_async_transfer(self):
+    t = torch.randn(32, 16)
+    xt = t.to(xm.xla_device())
+    xs.mark_sharding(xt, self._get_mesh((self.n_devices, 1)), (0, 1))
+    met.clear_all()
+    future, = torch_xla._XLAC._xla_get_cpu_tensors_async([xt])
+    self.assertTrue(torch.equal(future.wait(), t))
+    if self.n_devices > 1:
+      self.assertEqual(met.counter_value("ReassembleShardsOnHost"), 1)
+
+
+if __name__ == '__main__':
+  test = unittest.main()
+  sys.exit(0 if test.result.wasSuccessful() else 1)
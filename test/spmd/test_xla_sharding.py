@@ -16,6 +16,7 @@ import torch_xla.runtime as xr
 import torch_xla.core.xla_model as xm
 import torch_xla.debug.metrics as met
 import torch_xla.distributed.spmd as xs
+import torch_xla.utils.dlpack as xdlpack
 from torch_xla.distributed.spmd import XLAShardedTensor
 import test_xla_sharding_base
 
@@ -603,6 +604,21 @@ class BasicXlaShardingTest(test_xla_sharding_base.XlaShardingTest):
     output.to('cpu')
     self.assertEqual(met.counter_value("ReplicateShardedData"), 2)
 
+  def test_replicate_sharded_data_is_cached(self):
+    if self.n_devices == 1:
+      self.skipTest("sharding is replicated on a single device")
+    t = torch.randn(8, 8)
+    xt = t.to(xm.xla_device())
+    xs.mark_sharding(xt, self._get_mesh((1, self.n_devices)), (0, 1))
+    met.clear_all()
+    for _ in range(3):
+      self.assertTrue(torch.allclose(xt.cpu(), t))
+    self.assertEqual(met.counter_value("ReplicateShardedData"), 3)
+    # Other tests may have replicated the same shape and sharding already.
+    misses = met.counter_value("UtilityComputationCacheMiss") or 0
+    self.assertLessEqual(misses, 1)
+    self.assertEqual(met.counter_value("UtilityComputationCacheHit"), 3 - misses)
+
   def test_inplace_add_with_sharding(self):
     xt = torch.ones(2, 2).to(xm.xla_device())
     xs.mark_sharding(xt, self._get_mesh((1, self.n_devices)), (0, 1))
@@ -923,6 +939,50 @@ class BasicXlaShardingTest(test_xla_sharding_base.XlaShardingTest):
     xs.mark_sharding(v, mesh, (0, None))
     self.assertEqual(met.counter_value("CreateOpSharding"), 2)
 
+  @unittest.skipUnless(xr.device_type() in ('CPU', 'CUDA'),
+                       "DLPack is only supported on CPU and CUDA devices")
+  def test_dlpack_shards_roundtrip(self):
+    mesh = self._get_mesh((self.n_devices,))
+    t = torch.arange(self.n_devices * 4, dtype=torch.float).reshape(
+        self.n_devices, 4)
+    xt = xs.mark_sharding(t.to(xm.xla_device()), mesh, (0, None)).global_tensor
+    xm.mark_step()
+
+    shards, sharding, global_shape = xdlpack.to_dlpack_shards(xt)
+    self.assertEqual(len(shards), xr.addressable_runtime_device_count())
+    self.assertEqual(global_shape, list(t.shape))
+    xt2 = xdlpack.from_dlpack_shards(shards, sharding, global_shape)
+    self.assertEqual(
+        torch_xla._XLAC._get_xla_sharding_spec(xt),
+        torch_xla._XLAC._get_xla_sharding_spec(xt2))
+    self.assertTrue(torch.allclose(xt2.cpu(), t))
+    with self.assertRaisesRegex(RuntimeError,
+                                "DLTensor capsule can be consumed only once"):
+      xdlpack.from_dlpack_shards(shards, sharding, global_shape)
+
+    # The shards must be given in the order of the local devices.
+    shards, sharding, global_shape = xdlpack.to_dlpack_shards(xt)
+    if len(shards) > 1:
+      with self.assertRaises(RuntimeError):
+        xdlpack.from_dlpack_shards(shards[::-1], sharding, global_shape)
+
+  @unittest.skipUnless(xr.device_type() in ('CPU', 'CUDA'),
+                       "DLPack is only supported on CPU and CUDA devices")
+  def test_dlpack_shards_of_pending_result(self):
+    mesh = self._get_mesh((self.n_devices,))
+    t = torch.arange(self.n_devices * 4, dtype=torch.float).reshape(
+        self.n_devices, 4)
+    xt = xs.mark_sharding(t.to(xm.xla_device()), mesh, (0, None)).global_tensor
+    xm.mark_step()
+    xt = xt * 2 + 1
+    # The execution may still be in flight when the shards are exported.
+    xm.mark_step()
+
+    shards, sharding, global_shape = xdlpack.to_dlpack_shards(xt)
+    self.assertEqual(len(shards), xr.addressable_runtime_device_count())
+    xt2 = xdlpack.from_dlpack_shards(shards, sharding, global_shape)
+    self.assertTrue(torch.allclose(xt2.cpu(), t * 2 + 1))
+
   def test_from_cpu_shards_replicated(self):
     from_cpu_shards = torch_xla._XLAC._global_tensor_from_cpu_shards
 
@@ -0,0 +1,92 @@
+import os
+import sys
+import unittest
+
+# Must be set before the runtime reads it on the first compilation.
+os.environ['XLA_ASYNC_COMPILATION'] = '1'
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+import torch_xla.debug.metrics as met
+
+
+class AsyncCompilationTest(unittest.TestCase):
+
+  def test_async_compile_result(self):
+    device = xm.xla_device()
+    met.clear_all()
+    t = torch.randn(4, 4)
+    xt = t.to(device)
+    xs = xt @ xt + 1
+    xm.mark_step()
+    self.assertTrue(torch.allclose(xs.cpu(), t @ t + 1, atol=1e-4))
+    self.assertEqual(met.counter_value('AsyncCompile'), 1)
+    self.assertIn('AsyncCompileWait', met.metric_names())
+
+  def test_async_compile_is_cached(self):
+    device = xm.xla_device()
+    t = torch.randn(8)
+    xt = t.to(device)
+    for _ in range(3):
+      xs = xt * 2 - 3
+      xm.mark_step()
+    met.clear_all()
+    xs = xt * 2 - 3
+    xm.mark_step()
+    self.assertTrue(torch.allclose(xs.cpu(), t * 2 - 3))
+    self.assertIsNone(met.counter_value('AsyncCompile'))
+    self.assertEqual(met.counter_value('CachedCompile'), 1)
+
+  def test_async_compile_dedup(self):
+    device = xm.xla_device()
+    met.clear_all()
+    t = torch.randn(8)
+    xt = t.to(device)
+    xs = torch.sin(xt) + 5
+    # The second warm up either finds the first compilation in flight or
+    # already in the cache, and in neither case compiles the graph again.
+    torch_xla._XLAC._xla_warm_up_cache([xs], [])
+    torch_xla._XLAC._xla_warm_up_cache([xs], [])
+    self.assertEqual(met.counter_value('AsyncCompile'), 1)
+    xm.mark_step()
+    self.assertTrue(torch.allclose(xs.cpu(), torch.sin(t) + 5, atol=1e-5))
+
+  def test_async_compile_dedup_keeps_aliasing(self):
+    device = xm.xla_device()
+    t = torch.randn(64, 64)
+    xt = t.to(device)
+    met.clear_all()
+    for _ in range(2):
+      xt.add_(1)
+      xm.mark_step()
+    # The second step finds the computation of the first one either still in
+    # flight or already in the cache, and reuses it in both cases.
+    self.assertEqual(met.counter_value('AsyncCompile'), 1)
+    reused = ((met.counter_value('AsyncCompileDedup') or 0) +
+              (met.counter_value('CachedCompile') or 0))
+    self.assertEqual(reused, 1)
+    # The shared computation donates the buffer of xt, as a compilation of its
+    # own would.
+    num_samples, total, _ = met.metric_data('InputOutputAliasCount')
+    self.assertGreaterEqual(num_samples, 1)
+    self.assertEqual(total, num_samples)
+    self.assertTrue(torch.allclose(xt.cpu(), t + 2))
+
+  @unittest.skipUnless(
+      os.environ.get('PT_XLA_DEBUG_FILE'), 'Needs PT_XLA_DEBUG_FILE')
+  def test_async_compile_execution_analysis(self):
+    debug_file_name = os.environ['PT_XLA_DEBUG_FILE']
+    open(debug_file_name, 'w').close()
+    device = xm.xla_device()
+    xs = torch.randn(3, 5, device=device) * 7
+    xm.mark_step()
+    with open(debug_file_name) as f:
+      content = f.read()
+    self.assertIn('Compilation Analysis: ', content)
+    self.assertIn('Execution Analysis: ', content)
+
+
+if __name__ == '__main__':
+  test = unittest.main(exit=False)
+  sys.exit(0 if test.result.wasSuccessful() else 1)
@@ -0,0 +1,40 @@
+import sys
+import unittest
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+
+
+class AsyncTransferTest(unittest.TestCase):
+
+  def test_get_cpu_tensors_async(self):
+    device = xm.xla_device()
+    cpu_tensors = [torch.randn(4, 8), torch.randn(16), torch.randn(0, 3)]
+    xla_tensors = [t.to(device) * 2 for t in cpu_tensors]
+    futures = torch_xla._XLAC._xla_get_cpu_tensors_async(xla_tensors)
+    self.assertEqual(len(futures), len(cpu_tensors))
+    for future, expected in zip(futures, cpu_tensors):
+      result = future.wait()
+      self.assertTrue(future.done())
+      self.assertEqual(result.dtype, expected.dtype)
+      self.assertTrue(torch.allclose(result, expected * 2))
+
+  def test_get_cpu_tensors_async_dtypes(self):
+    device = xm.xla_device()
+    cpu_tensors = [
+        torch.arange(6, dtype=torch.int64).reshape(2, 3),
+        torch.tensor([True, False]),
+        torch.randn(3, 2).to(torch.bfloat16),
+    ]
+    xla_tensors = [t.to(device) for t in cpu_tensors]
+    futures = torch_xla._XLAC._xla_get_cpu_tensors_async(xla_tensors)
+    for future, expected in zip(futures, cpu_tensors):
+      result = future.wait()
+      self.assertEqual(result.dtype, expected.dtype)
+      self.assertTrue(torch.equal(result, expected))
+
+
+if __name__ == '__main__':
+  test = unittest.main(exit=False)
+  sys.exit(0 if test.result.wasSuccessful() else 1)
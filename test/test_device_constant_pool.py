@@ -0,0 +1,76 @@
+import os
+import sys
+import unittest
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+import torch_xla.debug.metrics as met
+
+# The pool is disabled by default, run_tests.sh runs this file both ways.
+POOL_ENABLED = int(os.environ.get('XLA_CONSTANT_POOL_MAX_TENSOR_BYTES',
+                                  '0')) > 0
+
+
+class DeviceConstantPoolTest(unittest.TestCase):
+
+  @unittest.skipIf(POOL_ENABLED, 'The pool is enabled')
+  def test_disabled_by_default(self):
+    met.clear_all()
+    mask = torch.tensor([True, False, True, True])
+    xla_masks = [mask.to(xm.xla_device()) for _ in range(2)]
+    for xla_mask in xla_masks:
+      xla_mask.logical_and(xla_mask)
+    self.assertIsNone(met.counter_value('DeviceConstantPoolMiss'))
+    self.assertIsNone(met.counter_value('DeviceConstantPoolHit'))
+
+    xla_masks[0].logical_not_()
+    xm.mark_step()
+    self.assertTrue(torch.equal(xla_masks[0].cpu(), ~mask))
+    self.assertTrue(torch.equal(xla_masks[1].cpu(), mask))
+
+  @unittest.skipIf(not POOL_ENABLED, 'The pool is disabled')
+  def test_equal_tensors_share_data(self):
+    met.clear_all()
+    mask = torch.tensor([True, False, True, True])
+    xla_masks = [mask.to(xm.xla_device()) for _ in range(3)]
+    # The tensors are uploaded when the graph first uses them.
+    for xla_mask in xla_masks:
+      xla_mask.logical_and(xla_mask)
+    self.assertEqual(met.counter_value('DeviceConstantPoolMiss'), 1)
+    self.assertEqual(met.counter_value('DeviceConstantPoolHit'), 2)
+
+    # Updating a tensor must not change the pooled value the others share.
+    xla_masks[0].logical_not_()
+    xm.mark_step()
+    self.assertTrue(torch.equal(xla_masks[0].cpu(), ~mask))
+    self.assertTrue(torch.equal(xla_masks[1].cpu(), mask))
+
+  @unittest.skipIf(not POOL_ENABLED, 'The pool is disabled')
+  def test_in_place_update_after_sync(self):
+    met.clear_all()
+    t = torch.arange(8, dtype=torch.float32)
+    xt = t.to(xm.xla_device())
+    self.assertTrue(torch.equal((xt * 1).cpu(), t))
+    # The tensor holds the pooled data once the step is marked.
+    xm.mark_step()
+    # The pooled buffer must not be donated to the in-place update.
+    xt.add_(1)
+    xm.mark_step()
+    self.assertTrue(torch.equal(xt.cpu(), t + 1))
+
+    xt2 = t.to(xm.xla_device())
+    self.assertTrue(torch.equal((xt2 * 1).cpu(), t))
+    self.assertEqual(met.counter_value('DeviceConstantPoolMiss'), 1)
+    self.assertEqual(met.counter_value('DeviceConstantPoolHit'), 1)
+
+  def test_inline_constants_disabled(self):
+    met.clear_all()
+    xt = torch.ones(4).to(xm.xla_device())
+    self.assertTrue(torch.equal((xt * 1).cpu(), torch.ones(4)))
+    self.assertIsNone(met.counter_value('InlinedConstant'))
+
+
+if __name__ == '__main__':
+  test = unittest.main(exit=False)
+  sys.exit(0 if test.result.wasSuccessful() else 1)
@@ -0,0 +1,75 @@
+import os
+import sys
+import unittest
+
+# Must be set before the first graph is synced.
+os.environ['XLA_INCREMENTAL_POST_ORDER'] = '1'
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+import torch_xla.debug.metrics as met
+
+
+class IncrementalPostOrderTest(unittest.TestCase):
+
+  def _step(self, w, x):
+    y = torch.relu(x @ w) + x
+    return y.sum(), y
+
+  def test_steady_state_steps_reuse_post_order(self):
+    device = xm.xla_device()
+    w = torch.randn(8, 8, device=device)
+    x = torch.randn(4, 8, device=device)
+    # The first step also materializes `w` and `x`, and the second one records
+    # the post order of the steady state graph.
+    for _ in range(2):
+      loss, x = self._step(w, x)
+      xm.mark_step()
+    met.clear_all()
+    expected_w = w.cpu()
+    expected_x = x.cpu()
+    for _ in range(3):
+      loss, x = self._step(w, x)
+      xm.mark_step()
+      expected_x = torch.relu(expected_x @ expected_w) + expected_x
+    self.assertEqual(met.counter_value('IncrementalPostOrderHit'), 3)
+    self.assertIsNone(met.counter_value('IncrementalPostOrderMiss'))
+    # Each step traces new nodes, so the post order is rebuilt from the plan
+    # rather than reused as is.
+    self.assertEqual(met.counter_value('IncrementalPostOrderReplay'), 3)
+    self.assertIsNone(met.counter_value('IncrementalPostOrderReuse'))
+    self.assertTrue(torch.allclose(x.cpu(), expected_x, atol=1e-4))
+    self.assertTrue(torch.allclose(loss.cpu(), expected_x.sum(), atol=1e-3))
+
+  def test_shared_parameter_is_not_merged(self):
+    device = xm.xla_device()
+    a = torch.randn(4, device=device)
+    b = torch.randn(4, device=device)
+    xm.mark_step()
+    out = a * 2 + b * 2
+    xm.mark_step()
+    met.clear_all()
+    # Same roots hashes, but a single device data node in both operands.
+    out = a * 2 + a * 2
+    xm.mark_step()
+    self.assertTrue(torch.allclose(out.cpu(), a.cpu() * 4))
+    self.assertIsNone(met.counter_value('IncrementalPostOrderHit'))
+    self.assertIsNone(met.counter_value('IncrementalPostOrderReplay'))
+
+  def test_changed_graph_misses(self):
+    device = xm.xla_device()
+    t = torch.randn(16, device=device)
+    xm.mark_step()
+    out = torch.sin(t)
+    xm.mark_step()
+    met.clear_all()
+    out = torch.cos(t)
+    xm.mark_step()
+    self.assertTrue(torch.allclose(out.cpu(), torch.cos(t.cpu()), atol=1e-5))
+    self.assertEqual(met.counter_value('IncrementalPostOrderMiss'), 1)
+
+
+if __name__ == '__main__':
+  test = unittest.main(exit=False)
+  sys.exit(0 if test.result.wasSuccessful() else 1)
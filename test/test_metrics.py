@@ -216,6 +216,19 @@ class MetricsTest(unittest.TestCase):
     # of `ExecuteComputation`, but the actual async time.
     self.assertGreater(execute_time_ns, .5 * wall_time_ns)
 
+  def test_openmetrics_report(self):
+    met.clear_all()
+    xla_device = xm.xla_device()
+    t1 = torch.tensor(100, device=xla_device)
+    t2 = t1 + 2
+    xm.mark_step()
+    report = met.openmetrics_report()
+    # Both the torch::lazy and the runtime counters and metrics are reported.
+    self.assertIn("xla_uncached_compile_total 1\n", report)
+    self.assertIn("# TYPE xla_lazy_tracing_seconds summary\n", report)
+    self.assertIn("xla_execute_time_seconds_count", report)
+    self.assertTrue(report.endswith("# EOF\n"))
+
   def test_pybind_increment_counter(self):
     met.clear_all()
     xla_device = xm.xla_device()
@@ -277,6 +290,38 @@ class MetricsTest(unittest.TestCase):
       self.assertEqual(
           set(ops), {"aten::nonzero", "aten::median", "torchvision::nms"})
 
+  def test_cpu_fallback_host_copies(self):
+    host_results = os.environ.get('XLA_CPU_FALLBACK_HOST_RESULTS', '0') == '1'
+    met.clear_all()
+    x = torch.rand(10).to(xm.xla_device())
+    xm.mark_step()
+    torch.median(x)
+    torch.median(x)
+    self.assertEqual(met.metric_data('CpuFallbackTime.aten::median')[0], 2)
+    x_bytes = x.numel() * x.element_size()
+    inbound_bytes = met.metric_data('CpuFallbackInboundData.aten::median')[1]
+    if host_results:
+      # The second fallback reuses the host copy of x made for the first one.
+      self.assertEqual(met.counter_value('FallbackHostCacheMiss'), 1)
+      self.assertEqual(met.counter_value('FallbackHostCacheHit'), 1)
+      self.assertEqual(inbound_bytes, x_bytes)
+    else:
+      # Host copies are only cached along with the host results.
+      self.assertIsNone(met.counter_value('FallbackHostCacheMiss'))
+      self.assertIsNone(met.counter_value('FallbackHostCacheHit'))
+      self.assertEqual(inbound_bytes, 2 * x_bytes)
+
+    # The results of a fallback go back to the device, unless
+    # XLA_CPU_FALLBACK_HOST_RESULTS keeps them on the host for the next one.
+    if not XLAExperimentalContains("nonzero"):
+      met.clear_all()
+      torch.median(torch.nonzero(x > 0.5))
+      inbound_bytes = met.metric_data('CpuFallbackInboundData.aten::median')[1]
+      if host_results:
+        self.assertEqual(inbound_bytes, 0)
+      else:
+        self.assertGreater(inbound_bytes, 0)
+
 
 if __name__ == '__main__':
   test = unittest.main()
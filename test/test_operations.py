@@ -2805,6 +2805,43 @@ class TestDLPack(parameterized.TestCase):
     cuda_t1[0] = cuda_t1[0] + 20
     self.assertTrue(torch.allclose(xla_t1.cpu(), cuda_t1.cpu()))
 
+  @onlyIfTorchSupportsCUDA
+  @onlyIfPJRTDeviceIsCUDA
+  def test_dlpack_batch_and_async_export(self):
+    xla_device = xm.xla_device()
+    xla_ts = [torch.arange(5).to(xla_device) * i for i in range(3)]
+    xm.mark_step()
+    cuda_ts = [
+        torch.utils.dlpack.from_dlpack(dlt)
+        for dlt in xdlpack.to_dlpack_batch(xla_ts)
+    ]
+    for xla_t, cuda_t in zip(xla_ts, cuda_ts):
+      self.assertTrue(torch.allclose(xla_t.cpu(), cuda_t.cpu()))
+
+    xla_ts = [t + 1 for t in xla_ts]
+    xm.mark_step()
+    dlts, ready = xdlpack.to_dlpack_async(xla_ts)
+    ready.wait()
+    self.assertTrue(ready.done())
+    for xla_t, dlt in zip(xla_ts, dlts):
+      self.assertTrue(
+          torch.allclose(xla_t.cpu(),
+                         torch.utils.dlpack.from_dlpack(dlt).cpu()))
+
+  @onlyIfTorchSupportsCUDA
+  @onlyIfPJRTDeviceIsCUDA
+  def test_dlpack_export_without_wait(self):
+    xla_device = xm.xla_device()
+    xla_t = torch.arange(5).to(xla_device) * 3
+    xm.mark_step()
+    with self.assertRaises(ValueError):
+      xdlpack.to_dlpack(xla_t, stream=-1)
+    dlts, ready = xdlpack.to_dlpack_async([xla_t])
+    ready.wait()
+    self.assertTrue(ready.done())
+    cuda_t = torch.utils.dlpack.from_dlpack(dlts[0])
+    self.assertTrue(torch.allclose(xla_t.cpu(), cuda_t.cpu()))
+
   @onlyIfTorchSupportsCUDA
   @onlyIfPJRTDeviceIsCUDA
   def test_dlpack_non_default_layout(self):
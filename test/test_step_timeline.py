@@ -0,0 +1,67 @@
+import json
+import os
+import sys
+import tempfile
+import unittest
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+import torch_xla.debug.metrics as met
+
+
+class StepTimelineTest(unittest.TestCase):
+
+  def test_records_steps(self):
+    device = xm.xla_device()
+    t = torch.randn(4, 4)
+    xt = t.to(device)
+    met.clear_step_timeline()
+    for _ in range(3):
+      xs = xt @ xt + 1
+      xm.mark_step()
+    xm.wait_device_ops()
+    steps = met.step_timeline()
+    self.assertEqual(len(steps), 3)
+    self.assertFalse(steps[0]['cache_hit'])
+    self.assertTrue(steps[-1]['cache_hit'])
+    self.assertEqual(len(set(step['graph_hash'] for step in steps)), 1)
+    for step in steps:
+      self.assertGreater(step['node_count'], 0)
+      self.assertGreaterEqual(step['parameter_count'], 1)
+      self.assertGreaterEqual(step['parameter_bytes'], 4 * 4 * 4)
+      self.assertLessEqual(step['start_ns'], step['end_ns'])
+      for phase in ('CollectSyncTensors', 'RunPostOrder',
+                    'TensorCollectionBarrier', 'ExecuteComputation'):
+        start_ns, end_ns = step['phases'][phase]
+        self.assertLessEqual(step['start_ns'], start_ns)
+        self.assertLessEqual(start_ns, end_ns)
+        self.assertLessEqual(step['phase_durations_ns'][phase],
+                             end_ns - start_ns)
+    self.assertIn('Compile', steps[0]['phases'])
+    self.assertNotIn('Compile', steps[-1]['phases'])
+
+  def test_empty_syncs_are_not_recorded(self):
+    met.clear_step_timeline()
+    xm.mark_step()
+    self.assertEqual(met.step_timeline(), [])
+
+  def test_chrome_trace(self):
+    device = xm.xla_device()
+    met.clear_step_timeline()
+    xs = torch.ones(8, device=device) * 2
+    xm.mark_step()
+    xm.wait_device_ops()
+    with tempfile.TemporaryDirectory() as tmpdir:
+      path = os.path.join(tmpdir, 'timeline.json')
+      met.save_step_timeline(path)
+      with open(path) as f:
+        trace = json.load(f)
+    names = [event['name'] for event in trace['traceEvents']]
+    self.assertEqual(names.count('Step'), 1)
+    self.assertIn('ExecuteComputation', names)
+
+
+if __name__ == '__main__':
+  test = unittest.main(exit=False)
+  sys.exit(0 if test.result.wasSuccessful() else 1)
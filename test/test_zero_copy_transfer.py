@@ -0,0 +1,55 @@
+import os
+import sys
+import unittest
+
+# Must be set before the first transfer reads it.
+os.environ['XLA_ZERO_COPY_TRANSFER'] = '1'
+
+import torch
+import torch_xla
+import torch_xla.core.xla_model as xm
+import torch_xla.debug.metrics as met
+import torch_xla.runtime as xr
+
+
+def expected_zero_copy_transfers():
+  # Only the CPU client aliases host memory, the others always copy.
+  return 1 if xr.device_type() == 'CPU' else None
+
+
+class ZeroCopyTransferTest(unittest.TestCase):
+
+  def test_zero_copy_transfer(self):
+    met.clear_all()
+    t = torch.arange(16, dtype=torch.float32).reshape(4, 4)
+    xt = t.to(xm.xla_device())
+    self.assertEqual(
+        met.counter_value('ZeroCopyTransfer'), expected_zero_copy_transfers())
+    self.assertTrue(torch.equal(xt.cpu(), t))
+
+  def test_in_place_update_does_not_write_to_source(self):
+    met.clear_all()
+    t = torch.arange(16, dtype=torch.float32).reshape(4, 4)
+    expected = t.clone()
+    xt = t.to(xm.xla_device())
+    self.assertEqual(
+        met.counter_value('ZeroCopyTransfer'), expected_zero_copy_transfers())
+    # The step barrier would donate the input buffer of the in-place update,
+    # but it aliases the CPU tensor.
+    xt += 1
+    xm.mark_step()
+    self.assertTrue(torch.equal(t, expected))
+    self.assertTrue(torch.equal(xt.cpu(), expected + 1))
+
+  def test_incompatible_tensors_are_copied(self):
+    met.clear_all()
+    # Not contiguous.
+    t = torch.arange(16, dtype=torch.float32).reshape(4, 4).t()
+    xt = t.to(xm.xla_device())
+    self.assertIsNone(met.counter_value('ZeroCopyTransfer'))
+    self.assertTrue(torch.equal(xt.cpu(), t))
+
+
+if __name__ == '__main__':
+  test = unittest.main(exit=False)
+  sys.exit(0 if test.result.wasSuccessful() else 1)
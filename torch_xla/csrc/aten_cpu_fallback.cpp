@@ -1,33 +1,113 @@
 #include "torch_xla/csrc/aten_cpu_fallback.h"
 
+#include <mutex>
 #include <unordered_map>
 
 #include "torch_xla/csrc/function_call_tracker.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
 #include "torch_xla/csrc/runtime/metrics.h"
+#include "torch_xla/csrc/runtime/sys_util.h"
 #include "torch_xla/csrc/runtime/tf_logging.h"
 
 namespace torch_xla {
+namespace {
+
+struct FallbackOpMetrics {
+  explicit FallbackOpMetrics(const std::string& name)
+      : counter(name),
+        time("CpuFallbackTime." + name, runtime::metrics::MetricFnTime),
+        inbound_data("CpuFallbackInboundData." + name,
+                     runtime::metrics::MetricFnBytes) {}
+
+  runtime::metrics::Counter counter;
+  runtime::metrics::Metric time;
+  runtime::metrics::Metric inbound_data;
+};
 
 // TODO(jwtan): Replace this with torch::lazy::Counter. We need
 // _cpu_fallback_counters to remain as torch_xla::runtime::metrics::Counter to
 // support torch_xla::runtime::metrics::CreatePerformanceReport(). For more
 // information, see NOTE: [TORCH_LAZY_COUNTER v.s. XLA_COUNTER].
-static std::unordered_map<std::string, ::torch_xla::runtime::metrics::Counter*>
-    _cpu_fallback_counters;
+std::mutex _cpu_fallback_lock;
+std::unordered_map<std::string, FallbackOpMetrics*> _cpu_fallback_counters;
+
+FallbackOpMetrics* GetFallbackOpMetrics(const std::string& name) {
+  std::lock_guard<std::mutex> lock(_cpu_fallback_lock);
+  FallbackOpMetrics*& metrics = _cpu_fallback_counters[name];
+  if (metrics == nullptr) {
+    metrics = new FallbackOpMetrics(name);
+  }
+  return metrics;
+}
+
+// The CPU fallback being run by the calling thread.
+struct FallbackState {
+  bool writes_inputs = false;
+  int64_t inbound_bytes = 0;
+};
+
+thread_local FallbackState* current_fallback = nullptr;
+
+// Makes a fallback the one of the calling thread while in scope.
+class FallbackScope {
+ public:
+  explicit FallbackScope(FallbackState* state) : previous_(current_fallback) {
+    current_fallback = state;
+  }
+
+  ~FallbackScope() { current_fallback = previous_; }
+
+ private:
+  FallbackState* previous_;
+};
+
+bool WritesArguments(const c10::FunctionSchema& schema) {
+  for (const c10::Argument& argument : schema.arguments()) {
+    if (argument.alias_info() != nullptr && argument.alias_info()->isWrite()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
 
 // Get all the executed fallback operations.
 // In other words, get all of them whose counters are not zero.
 std::vector<std::string> GetFallbackOperations() {
+  std::lock_guard<std::mutex> lock(_cpu_fallback_lock);
   std::vector<std::string> fallback;
   for (auto const& pair : _cpu_fallback_counters) {
-    if (pair.second->Value() != 0) {
+    if (pair.second->counter.Value() != 0) {
       fallback.push_back(pair.first);
     }
   }
   return fallback;
 }
 
+bool InCpuFallback() { return current_fallback != nullptr; }
+
+bool CpuFallbackHostResultsEnabled() {
+  static const bool host_results =
+      runtime::sys_util::GetEnvBool("XLA_CPU_FALLBACK_HOST_RESULTS", false);
+  return host_results;
+}
+
+bool CpuFallbackKeepsResultsOnHost() {
+  return CpuFallbackHostResultsEnabled() && InCpuFallback();
+}
+
+bool CpuFallbackCanShareHostCopies() {
+  return CpuFallbackHostResultsEnabled() && InCpuFallback() &&
+         !current_fallback->writes_inputs;
+}
+
+void RecordCpuFallbackInboundBytes(int64_t bytes) {
+  if (current_fallback != nullptr) {
+    current_fallback->inbound_bytes += bytes;
+  }
+}
+
 void xla_cpu_fallback(const c10::OperatorHandle& op, torch::jit::Stack* stack) {
   XLA_FN_TRACK(3);
   const auto name = c10::toString(op.operator_name());
@@ -37,11 +117,8 @@ void xla_cpu_fallback(const c10::OperatorHandle& op, torch::jit::Stack* stack) {
   // because this boxed fallback kernel is used by multiple operators,
   // and the macro stamps out a static Counter object with a fixed name
   // at the code location that it was called.
-  if (_cpu_fallback_counters.find(name) == _cpu_fallback_counters.end()) {
-    _cpu_fallback_counters[name] =
-        new ::torch_xla::runtime::metrics::Counter(name);
-  }
-  _cpu_fallback_counters[name]->AddValue(1);
+  FallbackOpMetrics* metrics = GetFallbackOpMetrics(name);
+  metrics->counter.AddValue(1);
 
   auto& args = op.schema().arguments();
   auto arguments = torch::jit::last(stack, args.size());
@@ -54,10 +131,17 @@ void xla_cpu_fallback(const c10::OperatorHandle& op, torch::jit::Stack* stack) {
     }
   }
 
-  // Call the actual boxed CPU fallback.
-  // Set error_on_views as XLA should take care
-  // of all view ops after functionalization.
-  at::native::cpu_fallback(op, stack, true);
+  FallbackState state;
+  state.writes_inputs = WritesArguments(op.schema());
+  {
+    FallbackScope scope(&state);
+    runtime::metrics::TimedSection timed(&metrics->time);
+    // Call the actual boxed CPU fallback.
+    // Set error_on_views as XLA should take care
+    // of all view ops after functionalization.
+    at::native::cpu_fallback(op, stack, true);
+  }
+  metrics->inbound_data.AddSample(state.inbound_bytes);
 }
 
 TORCH_LIBRARY_IMPL(_, XLA, m) {
@@ -9,6 +9,28 @@ void xla_cpu_fallback(const c10::OperatorHandle& op, torch::jit::Stack* stack);
 
 std::vector<std::string> GetFallbackOperations();
 
+// Whether the calling thread is running an operation on CPU through
+// xla_cpu_fallback().
+bool InCpuFallback();
+
+// Whether the results of CPU fallbacks stay on the host until a device
+// operation uses them (XLA_CPU_FALLBACK_HOST_RESULTS). Fallback operations
+// still run one at a time, but the next one reads them without a round trip
+// through the device.
+bool CpuFallbackHostResultsEnabled();
+
+// Whether the results of the running CPU fallback should stay on the host
+// rather than being uploaded right away.
+bool CpuFallbackKeepsResultsOnHost();
+
+// Whether the host copies of the inputs of the running CPU fallback can be
+// shared with other fallbacks, which is the case when host results are enabled
+// and the operation does not write to any of its inputs.
+bool CpuFallbackCanShareHostCopies();
+
+// Accounts bytes transferred from the device for the running CPU fallback.
+void RecordCpuFallbackInboundBytes(int64_t bytes);
+
 }  // namespace torch_xla
 
 #endif  // XLA_TORCH_XLA_CSRC_ATEN_CPU_FALLBACK_H_
@@ -27,6 +27,7 @@
 #include "torch_xla/csrc/debug_util.h"
 #include "torch_xla/csrc/device.h"
 #include "torch_xla/csrc/dtype.h"
+#include "torch_xla/csrc/fallback_host_cache.h"
 #include "torch_xla/csrc/helpers.h"
 #include "torch_xla/csrc/ops/as_strided.h"
 #include "torch_xla/csrc/ops/as_strided_view_update.h"
@@ -645,7 +646,8 @@ at::Tensor XLANativeFunctions::_copy_from(const at::Tensor& self,
     static bool sync_update =
         runtime::sys_util::GetEnvBool("XLA_TENSOR_UPDATE_SYNC", true) &&
         !UseVirtualDevice();
-    dst_tensor->UpdateFromTensor(self, /*sync=*/sync_update);
+    dst_tensor->UpdateFromTensor(
+        self, /*sync=*/sync_update && !CpuFallbackKeepsResultsOnHost());
     XLA_CHECK(dst_tensor);
   } else if (!dst_tensor) {
     at::Tensor tensor = self_tensor->ToTensor(/*detached=*/true);
@@ -684,6 +686,9 @@ at::Tensor XLANativeFunctions::_copy_from_and_resize(const at::Tensor& self,
 
 std::vector<at::Tensor> XLANativeFunctions::_to_cpu(at::TensorList tensors) {
   TORCH_LAZY_FN_COUNTER_TIMED_TRACING("xla::");
+  if (InCpuFallback()) {
+    return FallbackTensorsToCpu(tensors);
+  }
   return bridge::XlaCreateTensorList(tensors);
 }
 
@@ -0,0 +1,68 @@
+#include "torch_xla/csrc/device_constant_pool.h"
+
+#include <torch/csrc/lazy/core/lazy_graph_executor.h>
+#include <torch/csrc/lazy/core/metrics.h>
+#include <torch/csrc/lazy/core/tensor_util.h>
+
+#include "torch_xla/csrc/runtime/sys_util.h"
+#include "torch_xla/csrc/tensor_util.h"
+
+namespace torch_xla {
+
+bool IsSharedDeviceData(const torch::lazy::BackendDataPtr& data) {
+  auto* info = dynamic_cast<torch::lazy::LazyGraphExecutor::DeviceDataInfo*>(
+      data->info());
+  return info != nullptr && info->read_only;
+}
+
+void MarkSharedDeviceData(const torch::lazy::BackendDataPtr& data) {
+  data->SetInfo(
+      std::make_shared<torch::lazy::LazyGraphExecutor::DeviceDataInfo>(
+          /*tensor_id=*/-1, /*read_only=*/true));
+}
+
+DeviceConstantPool* DeviceConstantPool::Get() {
+  static DeviceConstantPool* pool = new DeviceConstantPool(
+      runtime::sys_util::GetEnvInt("XLA_CONSTANT_POOL_MAX_TENSOR_BYTES", 0),
+      runtime::sys_util::GetEnvInt("XLA_CONSTANT_POOL_SIZE", 4096),
+      runtime::sys_util::GetEnvInt("XLA_CONSTANT_POOL_MAX_BYTES",
+                                   64 * 1024 * 1024));
+  return pool;
+}
+
+DeviceConstantPool::DeviceConstantPool(int64_t max_tensor_bytes,
+                                       size_t max_size, size_t max_bytes)
+    : max_tensor_bytes_(max_tensor_bytes),
+      cache_(max_size, max_bytes, [](const Entry& entry) {
+        return Cache::EntryCost{static_cast<size_t>(entry.tensor.nbytes()),
+                                /*cost=*/1.0};
+      }) {}
+
+bool DeviceConstantPool::IsPoolable(const at::Tensor& tensor) const {
+  return tensor.numel() > 0 && tensor.nbytes() <= max_tensor_bytes_;
+}
+
+torch::lazy::BackendDataPtr DeviceConstantPool::GetDeviceData(
+    const at::Tensor& tensor, const torch::lazy::BackendDevice& device) {
+  torch::lazy::hash_t key = torch::lazy::HashCombine(
+      TensorHash(tensor),
+      torch::lazy::MHash(tensor.sizes().vec(),
+                         static_cast<int>(tensor.scalar_type()),
+                         device.toString()));
+  std::shared_ptr<Entry> entry = cache_.Get(key);
+  if (entry != nullptr && entry->tensor.scalar_type() == tensor.scalar_type() &&
+      entry->tensor.sizes() == tensor.sizes() && entry->tensor.equal(tensor)) {
+    TORCH_LAZY_COUNTER("DeviceConstantPoolHit", 1);
+    return entry->data;
+  }
+  TORCH_LAZY_COUNTER("DeviceConstantPoolMiss", 1);
+  entry = std::make_shared<Entry>();
+  entry->tensor = torch::lazy::CopyTensor(tensor);
+  entry->data = TensorToXlaData(entry->tensor, device);
+  MarkSharedDeviceData(entry->data);
+  // On a hash collision, the pooled tensor is kept and this one is not pooled.
+  cache_.Add(key, entry);
+  return entry->data;
+}
+
+}  // namespace torch_xla
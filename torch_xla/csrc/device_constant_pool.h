@@ -0,0 +1,59 @@
+#ifndef XLA_TORCH_XLA_CSRC_DEVICE_CONSTANT_POOL_H_
+#define XLA_TORCH_XLA_CSRC_DEVICE_CONSTANT_POOL_H_
+
+#include <ATen/Tensor.h>
+#include <torch/csrc/lazy/backend/backend_data.h>
+#include <torch/csrc/lazy/backend/backend_device.h>
+#include <torch/csrc/lazy/core/hash.h>
+
+#include "torch_xla/csrc/runtime/cache.h"
+
+namespace torch_xla {
+
+// Whether data is shared by several tensors, like the data of the device
+// constant pool and of the scalar data cache, which is read only. The tensors
+// using shared data leave its info alone, so that it is never made writable
+// and donated to a computation.
+bool IsSharedDeviceData(const torch::lazy::BackendDataPtr& data);
+
+// Marks data as shared, and owned by no tensor ID.
+void MarkSharedDeviceData(const torch::lazy::BackendDataPtr& data);
+
+// Device data of the small tensors uploaded by
+// XLATensor::GetIrValueForTensor(), keyed by their content, type and device.
+// The constants a program creates on every step, like masks, are then
+// uploaded once and shared by all the graphs using them. Pooling is disabled
+// by default (XLA_CONSTANT_POOL_MAX_TENSOR_BYTES), as the tensors whose data
+// is pooled share it, and cannot be told apart by tensor ID.
+class DeviceConstantPool {
+ public:
+  static DeviceConstantPool* Get();
+
+  // Tensors of up to max_tensor_bytes bytes are pooled. The pool holds up to
+  // max_size tensors and max_bytes bytes.
+  DeviceConstantPool(int64_t max_tensor_bytes, size_t max_size,
+                     size_t max_bytes);
+
+  bool IsPoolable(const at::Tensor& tensor) const;
+
+  // Returns the shared device data holding the value of tensor, uploading it
+  // only if the pool holds no equal tensor.
+  torch::lazy::BackendDataPtr GetDeviceData(
+      const at::Tensor& tensor, const torch::lazy::BackendDevice& device);
+
+ private:
+  struct Entry {
+    // A copy of the uploaded tensor, to rule out hash collisions.
+    at::Tensor tensor;
+    torch::lazy::BackendDataPtr data;
+  };
+  using Cache = runtime::util::Cache<torch::lazy::hash_t, Entry,
+                                     torch::lazy::HashReducer>;
+
+  const int64_t max_tensor_bytes_;
+  Cache cache_;
+};
+
+}  // namespace torch_xla
+
+#endif  // XLA_TORCH_XLA_CSRC_DEVICE_CONSTANT_POOL_H_
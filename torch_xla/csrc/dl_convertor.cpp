@@ -2,8 +2,13 @@
 
 #include <ATen/DLConvertor.h>
 
+#include <chrono>
+#include <mutex>
+
 #include "absl/types/span.h"
 #include "torch_xla/csrc/aten_xla_bridge.h"
+#include "torch_xla/csrc/device.h"
+#include "torch_xla/csrc/layout_manager.h"
 #include "torch_xla/csrc/ops/device_data.h"
 #include "torch_xla/csrc/runtime/computation_client.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
@@ -13,6 +18,7 @@
 #include "torch_xla/csrc/tensor.h"
 #include "torch_xla/csrc/tensor_util.h"
 #include "torch_xla/csrc/unwrap_data.h"
+#include "torch_xla/csrc/xla_sharding_util.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/pjrt/pjrt_future.h"
 #include "xla/pjrt/pjrt_layout.h"
@@ -113,8 +119,8 @@ std::vector<int64_t> StridesForShape(xla::PrimitiveType element_type,
   return strides;
 }
 
-// Convert an XLA tensor to a dlPack tensor.
-DLManagedTensor* toDLPack(const at::Tensor& input) {
+std::shared_ptr<xla::PjRtBuffer> GetPjRtBufferForExport(
+    const at::Tensor& input) {
   XLA_CHECK(bridge::IsXlaTensor(input)) << "The input should be an XLA tensor";
   std::shared_ptr<runtime::ComputationClient::Data> handle =
       get_data_handle(input);
@@ -130,7 +136,12 @@ DLManagedTensor* toDLPack(const at::Tensor& input) {
          "implemented for tuple buffers.";
   XLA_CHECK(!pjrt_buffer->has_dynamic_dimensions())
       << "Unimplemented. DynamicShape is not implemented in DLPack.";
+  return pjrt_buffer;
+}
 
+// Wraps a buffer into a DLPack tensor, without waiting for it to be ready.
+std::unique_ptr<DLPackTensor> PackPjRtBuffer(
+    std::shared_ptr<xla::PjRtBuffer> pjrt_buffer) {
   auto pack = std::make_unique<DLPackTensor>();
   DLTensor& dt = pack->tensor.dl_tensor;
   {
@@ -138,9 +149,6 @@ DLManagedTensor* toDLPack(const at::Tensor& input) {
     auto external_ref = pjrt_buffer->AcquireExternalReference();
     XLA_CHECK_OK(external_ref.status());
     pack->external_reference = std::move(external_ref.value());
-    xla::PjRtFuture<> future = pjrt_buffer->GetReadyFuture();
-    absl::Status status = future.Await();
-    XLA_CHECK_OK(status);
   }
   pack->buffer_reference = pjrt_buffer;
 
@@ -160,8 +168,138 @@ DLManagedTensor* toDLPack(const at::Tensor& input) {
   dt.shape = reinterpret_cast<std::int64_t*>(pack->shape.data());
   dt.strides = reinterpret_cast<std::int64_t*>(pack->strides.data());
   dt.byte_offset = 0;
+  return pack;
+}
+
+std::vector<std::unique_ptr<DLPackTensor>> PackPjRtBuffers(
+    absl::Span<const std::shared_ptr<xla::PjRtBuffer>> pjrt_buffers,
+    std::vector<xla::PjRtFuture<>>* futures) {
+  std::vector<std::unique_ptr<DLPackTensor>> packs;
+  packs.reserve(pjrt_buffers.size());
+  futures->reserve(futures->size() + pjrt_buffers.size());
+  for (auto& pjrt_buffer : pjrt_buffers) {
+    packs.push_back(PackPjRtBuffer(pjrt_buffer));
+    futures->push_back(pjrt_buffer->GetReadyFuture());
+  }
+  return packs;
+}
+
+// Packs the buffers of the inputs, appending their ready futures to futures.
+// All the buffers are looked up before any is packed, so that a pending
+// execution is waited for once rather than once per tensor.
+std::vector<std::unique_ptr<DLPackTensor>> PackTensors(
+    absl::Span<const at::Tensor> inputs,
+    std::vector<xla::PjRtFuture<>>* futures) {
+  std::vector<std::shared_ptr<xla::PjRtBuffer>> pjrt_buffers;
+  pjrt_buffers.reserve(inputs.size());
+  for (const at::Tensor& input : inputs) {
+    pjrt_buffers.push_back(GetPjRtBufferForExport(input));
+  }
+  return PackPjRtBuffers(pjrt_buffers, futures);
+}
+
+std::vector<DLManagedTensor*> ReleasePacks(
+    std::vector<std::unique_ptr<DLPackTensor>> packs) {
+  std::vector<DLManagedTensor*> tensors;
+  tensors.reserve(packs.size());
+  for (auto& pack : packs) {
+    tensors.push_back(&(pack.release()->tensor));
+  }
+  return tensors;
+}
+
+DLPackReadyEvent::DLPackReadyEvent(std::vector<xla::PjRtFuture<>> futures) {
+  struct State {
+    std::mutex mutex;
+    size_t pending = 0;
+    absl::Status status;
+    std::promise<absl::Status> promise;
+  };
+  auto state = std::make_shared<State>();
+  ready_ = state->promise.get_future().share();
+  if (futures.empty()) {
+    state->promise.set_value(absl::OkStatus());
+    return;
+  }
+  state->pending = futures.size();
+  for (auto& future : futures) {
+    future.OnReady([state](absl::Status status) {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->status.Update(status);
+      if (--state->pending == 0) {
+        state->promise.set_value(state->status);
+      }
+    });
+  }
+}
+
+bool DLPackReadyEvent::IsReady() const {
+  return ready_.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+void DLPackReadyEvent::Wait() const { XLA_CHECK_OK(ready_.get()); }
+
+// Convert an XLA tensor to a dlPack tensor.
+DLManagedTensor* toDLPack(const at::Tensor& input) {
+  return toDLPackBatch(absl::MakeConstSpan(&input, 1)).front();
+}
+
+std::vector<DLManagedTensor*> AwaitAndReleasePacks(
+    std::vector<std::unique_ptr<DLPackTensor>> packs,
+    std::vector<xla::PjRtFuture<>> futures) {
+  for (auto& future : futures) {
+    absl::Status status = future.Await();
+    XLA_CHECK_OK(status);
+  }
+  return ReleasePacks(std::move(packs));
+}
 
-  return &(pack.release()->tensor);
+std::vector<DLManagedTensor*> toDLPackBatch(
+    absl::Span<const at::Tensor> inputs) {
+  std::vector<xla::PjRtFuture<>> futures;
+  std::vector<std::unique_ptr<DLPackTensor>> packs =
+      PackTensors(inputs, &futures);
+  return AwaitAndReleasePacks(std::move(packs), std::move(futures));
+}
+
+DLPackExport toDLPackAsync(absl::Span<const at::Tensor> inputs) {
+  std::vector<xla::PjRtFuture<>> futures;
+  std::vector<std::unique_ptr<DLPackTensor>> packs =
+      PackTensors(inputs, &futures);
+  DLPackExport exported;
+  exported.tensors = ReleasePacks(std::move(packs));
+  exported.ready = std::make_shared<DLPackReadyEvent>(std::move(futures));
+  return exported;
+}
+
+std::vector<DLManagedTensor*> toDLPackShards(const at::Tensor& input) {
+  XLA_CHECK(bridge::IsXlaTensor(input)) << "The input should be an XLA tensor";
+  XLATensorPtr xtensor = bridge::GetXlaTensor(input);
+  XLA_CHECK(xtensor->sharding_spec() != nullptr) << "Tensor is not sharded";
+  runtime::ComputationClient::DataPtr handle = get_data_handle(input);
+  XLA_CHECK(handle != nullptr)
+      << "Could not extract a valid data handle from the input tensor";
+  if (!handle->HasValue()) {
+    // The shards are only known once the pending execution producing them
+    // is done, like the buffer waited for by GetPjRtBuffer().
+    runtime::GetComputationClient()->WaitDeviceOps({});
+  }
+
+  std::vector<runtime::ComputationClient::DataPtr> shards =
+      runtime::GetComputationClient()->GetDataShards(handle);
+  std::vector<std::shared_ptr<xla::PjRtBuffer>> pjrt_buffers;
+  pjrt_buffers.reserve(shards.size());
+  for (auto& shard : shards) {
+    std::shared_ptr<xla::PjRtBuffer> pjrt_buffer =
+        runtime::GetComputationClient()->GetPjRtBuffer(shard);
+    XLA_CHECK(pjrt_buffer != nullptr) << "Could not get a valid pjrt_buffer";
+    pjrt_buffers.push_back(std::move(pjrt_buffer));
+  }
+  std::vector<xla::PjRtFuture<>> futures;
+  std::vector<std::unique_ptr<DLPackTensor>> packs =
+      PackPjRtBuffers(pjrt_buffers, &futures);
+  return AwaitAndReleasePacks(std::move(packs), std::move(futures));
 }
 
 // Reference: https://github.com/openxla/xla/blob/main/xla/python/dlpack.cc
@@ -298,13 +436,19 @@ absl::StatusOr<std::vector<int64_t>> StridesToLayout(
   return minor_to_major;
 }
 
-at::Tensor fromDLPack(DLManagedTensor* dlmt) {
+absl::Span<int64_t const> DLPackDimensions(DLManagedTensor* dlmt) {
   XLA_CHECK(dlmt->dl_tensor.ndim >= 0)
       << "Number of dimensions in DLManagedTensor must be nonnegative, got "
       << dlmt->dl_tensor.ndim;
+  return absl::Span<int64_t const>(const_cast<int64_t*>(dlmt->dl_tensor.shape),
+                                   dlmt->dl_tensor.ndim);
+}
+
+// Creates device data viewing the memory of a DLPack tensor, which is released
+// along with the data.
+runtime::ComputationClient::DataPtr DataFromDLPack(DLManagedTensor* dlmt) {
+  absl::Span<int64_t const> dimensions = DLPackDimensions(dlmt);
   xla::PjRtDevice* device = DeviceForDLDevice(dlmt->dl_tensor.device).value();
-  absl::Span<int64_t const> dimensions(
-      const_cast<int64_t*>(dlmt->dl_tensor.shape), dlmt->dl_tensor.ndim);
   xla::PrimitiveType element_type =
       DLDataTypeToPrimitiveType(dlmt->dl_tensor.dtype).value();
 
@@ -333,14 +477,69 @@ at::Tensor fromDLPack(DLManagedTensor* dlmt) {
   XLA_CHECK_OK(pjrt_buffer.status()) << "Failed to create a pjrt buffer.";
   XLA_CHECK(pjrt_buffer.value() != nullptr) << "pjrt buffer is null.";
 
-  runtime::ComputationClient::DataPtr data =
-      runtime::PjRtComputationClient::CreateData(
-          runtime::GetComputationClient()->PjRtDeviceToString(device), shape,
-          std::move(pjrt_buffer.value()));
+  return runtime::PjRtComputationClient::CreateData(
+      runtime::GetComputationClient()->PjRtDeviceToString(device), shape,
+      std::move(pjrt_buffer.value()));
+}
 
+at::Tensor fromDLPack(DLManagedTensor* dlmt) {
+  runtime::ComputationClient::DataPtr data = DataFromDLPack(dlmt);
   at::ScalarType tensor_type = at::toScalarType(dlmt->dl_tensor.dtype);
   XLATensorPtr xla_tensor = XLATensor::Create(data, tensor_type);
   return bridge::AtenFromXlaTensor(xla_tensor);
 }
 
+at::Tensor fromDLPackShards(absl::Span<DLManagedTensor* const> shards,
+                            const xla::OpSharding& sharding,
+                            absl::Span<const int64_t> global_shape) {
+  XLA_CHECK(UseVirtualDevice())
+      << "Please enable SPMD via `torch_xla.runtime.use_spmd()`";
+  std::vector<std::string> local_devices =
+      runtime::GetComputationClient()->GetLocalDevices();
+  XLA_CHECK_EQ(shards.size(), local_devices.size())
+      << "Must specify a shard for each local device";
+
+  torch::lazy::BackendDevice virtual_device = GetVirtualDevice();
+  xla::PrimitiveType element_type =
+      DLDataTypeToPrimitiveType(shards[0]->dl_tensor.dtype).value();
+  xla::Shape tensor_shape = MakeArrayShapeFromDimensions(
+      global_shape, /*dynamic_dimensions=*/{}, element_type,
+      static_cast<XlaDeviceType>(virtual_device.type()));
+  auto sharding_spec =
+      std::make_shared<XLATensor::ShardingSpec>(sharding, tensor_shape);
+
+  // Check all the shards before any is wrapped: the views release the DLPack
+  // tensors, which the caller still owns if this fails.
+  std::vector<int64_t> expected_shard_shape =
+      ShardingUtil::GetShardShape(sharding_spec);
+  for (size_t i = 0; i < shards.size(); ++i) {
+    XLA_CHECK_EQ(DLDataTypeToPrimitiveType(shards[i]->dl_tensor.dtype).value(),
+                 element_type)
+        << "All the shards must have the same type";
+    absl::Span<int64_t const> dimensions = DLPackDimensions(shards[i]);
+    XLA_CHECK(dimensions == absl::MakeConstSpan(expected_shard_shape))
+        << "Shard shape must include padding: ["
+        << absl::StrJoin(dimensions, ",") << "] vs ["
+        << absl::StrJoin(expected_shard_shape, ",") << "]";
+    xla::PjRtDevice* device =
+        DeviceForDLDevice(shards[i]->dl_tensor.device).value();
+    XLA_CHECK_EQ(runtime::GetComputationClient()->PjRtDeviceToString(device),
+                 local_devices[i])
+        << "Shards must be ordered as the local devices";
+  }
+
+  std::vector<runtime::ComputationClient::DataPtr> shard_data;
+  shard_data.reserve(shards.size());
+  for (DLManagedTensor* shard : shards) {
+    shard_data.push_back(DataFromDLPack(shard));
+  }
+  runtime::ComputationClient::DataPtr data =
+      runtime::GetComputationClient()->WrapDataShards(
+          shard_data, virtual_device.toString(), tensor_shape, sharding);
+  XLATensorPtr xla_tensor = XLATensor::Create(
+      std::move(data), at::toScalarType(shards[0]->dl_tensor.dtype));
+  xla_tensor->SetShardingSpec(*sharding_spec);
+  return bridge::AtenFromXlaTensor(std::move(xla_tensor));
+}
+
 }  // namespace torch_xla
@@ -4,11 +4,64 @@
 #include <ATen/Tensor.h>
 #include <ATen/dlpack.h>
 
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "xla/pjrt/pjrt_future.h"
+#include "xla/xla_data.pb.h"
+
 namespace torch_xla {
 
+// Becomes ready once the device buffers exported by toDLPackAsync() hold their
+// values. The exported memory must not be read before.
+class DLPackReadyEvent {
+ public:
+  explicit DLPackReadyEvent(std::vector<xla::PjRtFuture<>> futures);
+
+  // Whether all the buffers are ready, in which case Wait() won't block.
+  bool IsReady() const;
+
+  // Waits for all the buffers to be ready.
+  void Wait() const;
+
+ private:
+  std::shared_future<absl::Status> ready_;
+};
+
+struct DLPackExport {
+  std::vector<DLManagedTensor*> tensors;
+  std::shared_ptr<DLPackReadyEvent> ready;
+};
+
+// Exports an XLA tensor, waiting for the device work that produces it.
 DLManagedTensor* toDLPack(const at::Tensor& src);
+
+// Same as toDLPack(), for several tensors whose buffers are looked up and
+// referenced in one pass and waited for together.
+std::vector<DLManagedTensor*> toDLPackBatch(absl::Span<const at::Tensor> srcs);
+
+// Same as toDLPackBatch(), but returns as soon as the buffers are referenced.
+// The consumer must wait on the returned event, or synchronize with the
+// producer stream, before reading them.
+DLPackExport toDLPackAsync(absl::Span<const at::Tensor> srcs);
+
 at::Tensor fromDLPack(DLManagedTensor* src);
 
+// Exports the local shards of a sharded XLA tensor, without gathering them, in
+// the order of ComputationClient::GetLocalDevices(). The shards include any
+// padding, see ShardingUtil::GetShardShape().
+std::vector<DLManagedTensor*> toDLPackShards(const at::Tensor& src);
+
+// Creates a sharded XLA tensor of the given global shape on the SPMD virtual
+// device, viewing the memory of its local shards ordered as in
+// toDLPackShards().
+at::Tensor fromDLPackShards(absl::Span<DLManagedTensor* const> shards,
+                            const xla::OpSharding& sharding,
+                            absl::Span<const int64_t> global_shape);
+
 }  // namespace torch_xla
 
 #endif  // XLA_TORCH_XLA_CSRC_DL_CONVERTOR_H_
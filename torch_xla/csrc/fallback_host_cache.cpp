@@ -0,0 +1,158 @@
+#include "torch_xla/csrc/fallback_host_cache.h"
+
+#include <torch/csrc/lazy/core/metrics.h>
+
+#include "torch_xla/csrc/aten_cpu_fallback.h"
+#include "torch_xla/csrc/aten_xla_bridge.h"
+#include "torch_xla/csrc/ops/device_data.h"
+#include "torch_xla/csrc/runtime/sys_util.h"
+#include "torch_xla/csrc/tensor.h"
+
+namespace torch_xla {
+namespace {
+
+// The device data holding the value of a tensor, if it has one.
+torch::lazy::BackendDataPtr CurrentDeviceData(const XLATensorPtr& xtensor) {
+  torch::lazy::BackendDataPtr data;
+  torch::lazy::Value ir_value = xtensor->CurrentIrValue();
+  if (ir_value) {
+    DeviceData* device_data = DeviceData::Cast(ir_value.node.get());
+    if (device_data == nullptr) {
+      return nullptr;
+    }
+    data = device_data->data();
+  } else {
+    data = xtensor->CurrentDataHandle();
+  }
+  return data != nullptr && data->HasValue() ? data : nullptr;
+}
+
+}  // namespace
+
+FallbackHostCache* FallbackHostCache::Get() {
+  static FallbackHostCache* cache =
+      new FallbackHostCache(runtime::sys_util::GetEnvInt(
+          "XLA_CPU_FALLBACK_CACHE_MAX_BYTES", 256 * 1024 * 1024));
+  return cache;
+}
+
+FallbackHostCache::FallbackHostCache(int64_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+std::optional<at::Tensor> FallbackHostCache::Get(
+    const torch::lazy::BackendDataPtr& data, at::ScalarType scalar_type) {
+  std::lock_guard<std::mutex> lock(lock_);
+  // The copies of the data which went away are swept once every as many
+  // lookups as there are entries, so that they do not stay pinned until the
+  // next Add() runs out of room, at a constant amortized cost.
+  if (++lookups_since_sweep_ >= entries_.size()) {
+    EraseExpired();
+    lookups_since_sweep_ = 0;
+  }
+  auto it = entries_.find(data.get());
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  // The address may have been reused by new data since the copy was made.
+  if (it->second.data.lock() != data) {
+    Erase(it->first);
+    return std::nullopt;
+  }
+  if (it->second.tensor.scalar_type() != scalar_type) {
+    return std::nullopt;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+  return it->second.tensor;
+}
+
+void FallbackHostCache::Add(const torch::lazy::BackendDataPtr& data,
+                            at::Tensor tensor) {
+  int64_t bytes = tensor.nbytes();
+  if (bytes > max_bytes_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(lock_);
+  Erase(data.get());
+  if (bytes_ + bytes > max_bytes_) {
+    EraseExpired();
+  }
+  while (bytes_ + bytes > max_bytes_) {
+    Erase(lru_.back());
+  }
+  lru_.push_front(data.get());
+  entries_.emplace(data.get(), Entry{data, std::move(tensor), lru_.begin()});
+  bytes_ += bytes;
+}
+
+void FallbackHostCache::Erase(const torch::lazy::BackendData* key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  bytes_ -= it->second.tensor.nbytes();
+  lru_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+void FallbackHostCache::EraseExpired() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.data.expired()) {
+      bytes_ -= it->second.tensor.nbytes();
+      lru_.erase(it->second.lru_position);
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+std::vector<at::Tensor> FallbackTensorsToCpu(
+    const at::ITensorListRef& tensors) {
+  bool share_host_copies = CpuFallbackCanShareHostCopies();
+  FallbackHostCache* cache = FallbackHostCache::Get();
+  std::vector<at::Tensor> results(tensors.size());
+  std::vector<at::Tensor> fetched_tensors;
+  std::vector<size_t> fetched_indices;
+  // Per fetched tensor, the device data it comes from if the copy is to be
+  // cached, and whether its value was on the device.
+  std::vector<torch::lazy::BackendDataPtr> fetched_data;
+  std::vector<bool> fetched_from_device;
+  size_t index = 0;
+  for (const at::Tensor& tensor : tensors) {
+    XLATensorPtr xtensor =
+        tensor.defined() ? bridge::TryGetXlaTensor(tensor) : XLATensorPtr();
+    torch::lazy::BackendDataPtr data;
+    if (xtensor && share_host_copies) {
+      data = CurrentDeviceData(xtensor);
+    }
+    if (data != nullptr) {
+      std::optional<at::Tensor> host_copy = cache->Get(data, xtensor->dtype());
+      if (host_copy) {
+        TORCH_LAZY_COUNTER("FallbackHostCacheHit", 1);
+        results[index++] = std::move(*host_copy);
+        continue;
+      }
+      TORCH_LAZY_COUNTER("FallbackHostCacheMiss", 1);
+    }
+    fetched_tensors.push_back(tensor);
+    fetched_indices.push_back(index++);
+    fetched_data.push_back(std::move(data));
+    fetched_from_device.push_back(xtensor &&
+                                  !xtensor->CurrentTensorData().has_value());
+  }
+
+  std::vector<at::Tensor> fetched =
+      bridge::XlaCreateTensorList(fetched_tensors);
+  for (size_t i = 0; i < fetched.size(); ++i) {
+    if (fetched_from_device[i]) {
+      RecordCpuFallbackInboundBytes(fetched[i].nbytes());
+    }
+    if (fetched_data[i] != nullptr) {
+      cache->Add(fetched_data[i], fetched[i]);
+    }
+    results[fetched_indices[i]] = std::move(fetched[i]);
+  }
+  return results;
+}
+
+}  // namespace torch_xla
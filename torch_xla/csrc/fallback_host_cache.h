@@ -0,0 +1,61 @@
+#ifndef XLA_TORCH_XLA_CSRC_FALLBACK_HOST_CACHE_H_
+#define XLA_TORCH_XLA_CSRC_FALLBACK_HOST_CACHE_H_
+
+#include <ATen/Tensor.h>
+#include <ATen/core/ITensorListRef.h>
+#include <torch/csrc/lazy/backend/backend_data.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace torch_xla {
+
+// Host copies of device data fetched by CPU fallbacks, so that an input used
+// by several fallback operations is transferred once. The cache is only filled
+// when XLA_CPU_FALLBACK_HOST_RESULTS is enabled. Device data is
+// not modified once it holds a value, so a copy stays valid as long as the
+// data it was fetched from is alive. The copies of the data which went away
+// are dropped along the lookups, and the least recently used ones beyond
+// max_bytes.
+class FallbackHostCache {
+ public:
+  static FallbackHostCache* Get();
+
+  explicit FallbackHostCache(int64_t max_bytes);
+
+  std::optional<at::Tensor> Get(const torch::lazy::BackendDataPtr& data,
+                                at::ScalarType scalar_type);
+
+  void Add(const torch::lazy::BackendDataPtr& data, at::Tensor tensor);
+
+ private:
+  struct Entry {
+    std::weak_ptr<torch::lazy::BackendData> data;
+    at::Tensor tensor;
+    std::list<const torch::lazy::BackendData*>::iterator lru_position;
+  };
+
+  void Erase(const torch::lazy::BackendData* key);
+
+  void EraseExpired();
+
+  const int64_t max_bytes_;
+  std::mutex lock_;
+  int64_t bytes_ = 0;
+  size_t lookups_since_sweep_ = 0;
+  // From the most to the least recently used.
+  std::list<const torch::lazy::BackendData*> lru_;
+  std::unordered_map<const torch::lazy::BackendData*, Entry> entries_;
+};
+
+// Returns the host values of tensors for the running CPU fallback, reusing
+// the host copies of the device data fetched by the previous fallbacks.
+std::vector<at::Tensor> FallbackTensorsToCpu(const at::ITensorListRef& tensors);
+
+}  // namespace torch_xla
+
+#endif  // XLA_TORCH_XLA_CSRC_FALLBACK_HOST_CACHE_H_
@@ -9,6 +9,7 @@
 #include <torch/csrc/lazy/core/config.h>
 #include <torch/csrc/lazy/core/ir_util.h>
 #include <torch/csrc/lazy/core/lazy_graph_executor.h>
+#include <torch/csrc/lazy/core/metrics.h>
 
 #include <cstring>
 #include <fstream>
@@ -48,6 +49,7 @@
 #include "torch_xla/csrc/runtime/env_vars.h"
 #include "torch_xla/csrc/runtime/metrics.h"
 #include "torch_xla/csrc/runtime/metrics_analysis.h"
+#include "torch_xla/csrc/runtime/metrics_exporter.h"
 #include "torch_xla/csrc/runtime/metrics_reader.h"
 #include "torch_xla/csrc/runtime/pjrt_computation_client.h"
 #include "torch_xla/csrc/runtime/pjrt_registry.h"
@@ -58,6 +60,7 @@
 #include "torch_xla/csrc/runtime/xla_coordinator.h"
 #include "torch_xla/csrc/runtime/xla_util.h"
 #include "torch_xla/csrc/shape_helper.h"
+#include "torch_xla/csrc/step_timeline.h"
 #include "torch_xla/csrc/tensor_impl.h"
 #include "torch_xla/csrc/tensor_methods.h"
 #include "torch_xla/csrc/tensor_util.h"
@@ -133,6 +136,10 @@ void PrepareToExit() {
     SetAllReduceToken(xla_device, nullptr);
     XLAGraphExecutor::Get()->WaitDeviceOps({});
   }
+  if (XLAGraphExecutor::Get()->IsComputationCacheInitialized()) {
+    XLAGraphExecutor::Get()->GetComputationCache()->Flush();
+  }
+  runtime::metrics::MetricsExporter::Shutdown();
 }
 
 std::string GetTensorsDump(
@@ -702,6 +709,89 @@ py::object GetMetricData(const std::string& name) {
   return py::none();
 }
 
+// Appends the torch::lazy metrics and counters to the OpenMetrics reports of
+// the runtime, which cannot depend on PyTorch.
+void EmitLazyOpenMetrics(std::stringstream* ss) {
+  // The torch::lazy metrics only expose their pretty-printing function, so the
+  // unit is found by comparing its output on a probe value.
+  static const double kProbe = 1.0;
+  for (const std::string& name : torch::lazy::GetMetricNames()) {
+    torch::lazy::MetricData* data = torch::lazy::GetMetric(name);
+    if (data == nullptr) {
+      continue;
+    }
+    runtime::metrics::OpenMetricsUnit unit =
+        runtime::metrics::OpenMetricsUnit::kNone;
+    std::string repr = data->Repr(kProbe);
+    if (repr == torch::lazy::MetricFnTime(kProbe)) {
+      unit = runtime::metrics::OpenMetricsUnit::kSeconds;
+    } else if (repr == torch::lazy::MetricFnBytes(kProbe)) {
+      unit = runtime::metrics::OpenMetricsUnit::kBytes;
+    }
+    double accumulator = 0.0;
+    size_t total_samples = 0;
+    std::vector<torch::lazy::Sample> samples =
+        data->Samples(&accumulator, &total_samples);
+    std::vector<runtime::metrics::Sample> runtime_samples;
+    runtime_samples.reserve(samples.size());
+    for (const torch::lazy::Sample& sample : samples) {
+      runtime_samples.emplace_back(sample.timestamp_ns, sample.value);
+    }
+    runtime::metrics::EmitOpenMetricsSummary(
+        name, unit, std::move(runtime_samples), accumulator, total_samples, ss);
+  }
+  for (const std::string& name : torch::lazy::GetCounterNames()) {
+    torch::lazy::CounterData* data = torch::lazy::GetCounter(name);
+    if (data != nullptr) {
+      runtime::metrics::EmitOpenMetricsCounter(name, data->Value(), ss);
+    }
+  }
+}
+
+py::object GetMetricLifetimePercentiles(const std::string& name,
+                                        const std::vector<double>& quantiles) {
+  runtime::metrics::MetricData* data = runtime::metrics::GetMetric(name);
+  if (data == nullptr || !data->HasLifetimeHistogram()) {
+    return py::none();
+  }
+  runtime::metrics::Histogram histogram = data->LifetimeHistogram();
+  auto py_values = py::tuple(quantiles.size());
+  for (size_t i = 0; i < quantiles.size(); ++i) {
+    py_values[i] = histogram.Quantile(quantiles[i]);
+  }
+  return py_values;
+}
+
+py::list GetStepTimeline() {
+  py::list py_steps;
+  for (const StepRecord& step : StepTimeline::Get()->GetSteps()) {
+    py::dict py_step;
+    py_step["step_id"] = step.step_id;
+    py_step["device"] = step.device;
+    py_step["graph_hash"] = torch::lazy::HashToString(step.graph_hash);
+    py_step["node_count"] = step.node_count;
+    py_step["parameter_count"] = step.parameter_count;
+    py_step["parameter_bytes"] = step.parameter_bytes;
+    py_step["cache_hit"] = step.cache_hit;
+    py_step["start_ns"] = step.start_ns;
+    py_step["end_ns"] = step.end_ns;
+    py::dict py_phases;
+    py::dict py_phase_durations;
+    for (size_t i = 0; i < StepRecord::kNumPhases; ++i) {
+      if (step.phase_start_ns[i] != 0 && step.phase_end_ns[i] != 0) {
+        const char* name = StepPhaseName(static_cast<StepPhase>(i));
+        py_phases[name] =
+            py::make_tuple(step.phase_start_ns[i], step.phase_end_ns[i]);
+        py_phase_durations[name] = step.phase_duration_ns[i];
+      }
+    }
+    py_step["phases"] = py_phases;
+    py_step["phase_durations_ns"] = py_phase_durations;
+    py_steps.append(py_step);
+  }
+  return py_steps;
+}
+
 py::object GetRevisions() {
   auto py_dict = py::dict();
   py_dict["xla"] = std::string(XLA_GITREV);
@@ -1153,21 +1243,39 @@ void dlPack_Capsule_Destructor(PyObject* data) {
   }
 }
 
-at::Tensor tensor_fromDLPack(PyObject* data) {
+DLManagedTensor* DLPackFromCapsule(PyObject* data) {
   DLManagedTensor* dlMTensor =
       (DLManagedTensor*)PyCapsule_GetPointer(data, "dltensor");
   XLA_CHECK(dlMTensor != nullptr)
       << "from_dlpack received an invalid capsule. Note that a DLTensor "
          "capsule can be consumed only once. You may have already constructed "
          "a tensor from it once.";
+  return dlMTensor;
+}
 
-  at::Tensor tensor = torch_xla::fromDLPack(dlMTensor);
+// Hands the ownership of the DLPack tensor of a capsule over to its consumer.
+void ConsumeDLPackCapsule(PyObject* data) {
   PyCapsule_SetName(data, "used_dltensor");
   PyCapsule_SetDestructor(data, nullptr);
+}
+
+py::list DLPackCapsules(absl::Span<DLManagedTensor* const> dlMTensors) {
+  py::list capsules;
+  for (DLManagedTensor* dlMTensor : dlMTensors) {
+    capsules.append(py::reinterpret_steal<py::object>(
+        PyCapsule_New(dlMTensor, "dltensor", dlPack_Capsule_Destructor)));
+  }
+  return capsules;
+}
+
+at::Tensor tensor_fromDLPack(PyObject* data) {
+  at::Tensor tensor = torch_xla::fromDLPack(DLPackFromCapsule(data));
+  ConsumeDLPackCapsule(data);
   return tensor;
 }
 
 void InitXlaModuleBindings(py::module m) {
+  runtime::metrics::SetOpenMetricsCollector(EmitLazyOpenMetrics);
   m.def("_prepare_to_exit", []() { PrepareToExit(); });
   m.def("_xla_runtime_is_initialized", []() {
     return runtime::GetComputationClientIfInitialized() != nullptr;
@@ -1787,6 +1895,34 @@ void InitXlaModuleBindings(py::module m) {
       },
       py::arg("tensors"), py::arg("devices"), py::arg("wait") = true,
       py::arg("sync_xla_data") = true);
+  py::class_<TensorFuture>(m, "TensorFuture")
+      .def("done", &TensorFuture::IsReady)
+      .def("wait", [](const TensorFuture& future) {
+        at::Tensor tensor;
+        {
+          NoGilSection nogil;
+          tensor = future.Get();
+        }
+        return tensor;
+      });
+  m.def("_xla_get_cpu_tensors_async",
+        [](const std::vector<at::Tensor>& tensors) {
+          NoGilSection nogil;
+          std::vector<XLATensorPtr> xtensors =
+              GetXlaTensors(tensors, /*want_all=*/true);
+          XLAGraphExecutor::Get()->SyncTensorsGraph(&xtensors, {},
+                                                    /*wait=*/true,
+                                                    /*sync_ltc_data=*/true);
+          std::vector<torch::lazy::BackendDataPtr> xla_data;
+          std::vector<at::ScalarType> element_types;
+          for (auto& xtensor : xtensors) {
+            xla_data.push_back(xtensor->GetXlaData());
+            XLA_CHECK(xla_data.back() != nullptr)
+                << "Tensor has no device data after sync";
+            element_types.push_back(xtensor->dtype());
+          }
+          return XlaDataToTensorsAsync(xla_data, element_types);
+        });
   m.def(
       "_xla_warm_up_cache",
       [](const std::vector<at::Tensor>& tensors,
@@ -1896,6 +2032,11 @@ void InitXlaModuleBindings(py::module m) {
   m.def("_xla_metric_data", [](const std::string& name) -> py::object {
     return GetMetricData(name);
   });
+  m.def("_xla_metric_lifetime_percentiles",
+        [](const std::string& name,
+           const std::vector<double>& quantiles) -> py::object {
+          return GetMetricLifetimePercentiles(name, quantiles);
+        });
   m.def("_xla_metrics_report", []() {
     // NOTE: [TORCH_LAZY_COUNTER v.s. XLA_COUNTER]
     // Counters and Metrics are divided into two groups: one in PyTorch/XLA and
@@ -1910,6 +2051,8 @@ void InitXlaModuleBindings(py::module m) {
            runtime::metrics_reader::CreateMetricReport(
                runtime::GetComputationClient()->GetMetrics());
   });
+  m.def("_xla_openmetrics_report",
+        []() { return runtime::metrics::CreateOpenMetricsReport(); });
   m.def("_short_xla_metrics_report", [](const py::list& counter_names,
                                         const py::list& metric_names) {
     std::vector<std::string> counter_name_vec;
@@ -1925,6 +2068,11 @@ void InitXlaModuleBindings(py::module m) {
            runtime::metrics_reader::CreateMetricReport(counter_name_vec,
                                                        metric_name_vec);
   });
+  m.def("_xla_step_timeline", []() { return GetStepTimeline(); });
+  m.def("_xla_step_timeline_chrome_trace", []() {
+    return StepTimeline::ToChromeTrace(StepTimeline::Get()->GetSteps());
+  });
+  m.def("_clear_xla_step_timeline", []() { StepTimeline::Get()->Clear(); });
   m.def("_clear_xla_counters", []() {
     torch::lazy::MetricsArena::Get()->ResetCounters();
     runtime::metrics::ClearCounters();
@@ -2709,6 +2857,29 @@ void InitXlaModuleBindings(py::module m) {
     }
     return PyCapsule_New(dlMTensor, "dltensor", dlPack_Capsule_Destructor);
   });
+  m.def("_to_dlpack_batch", [](const std::vector<at::Tensor>& inputs) {
+    std::vector<DLManagedTensor*> dlMTensors;
+    {
+      NoGilSection nogil;
+      dlMTensors = torch_xla::toDLPackBatch(inputs);
+    }
+    return DLPackCapsules(dlMTensors);
+  });
+  py::class_<DLPackReadyEvent, std::shared_ptr<DLPackReadyEvent>>(
+      m, "DLPackReadyEvent")
+      .def("done", &DLPackReadyEvent::IsReady)
+      .def("wait", [](const DLPackReadyEvent& event) {
+        NoGilSection nogil;
+        event.Wait();
+      });
+  m.def("_to_dlpack_async", [](const std::vector<at::Tensor>& inputs) {
+    DLPackExport exported;
+    {
+      NoGilSection nogil;
+      exported = torch_xla::toDLPackAsync(inputs);
+    }
+    return py::make_tuple(DLPackCapsules(exported.tensors), exported.ready);
+  });
 
   // from a dlpack PyCapsule to an XLA tensor
   // If ext_data is the result of an CUDA computation, we should synchronize
@@ -2720,6 +2891,33 @@ void InitXlaModuleBindings(py::module m) {
     return tensor_fromDLPack(ext_data.ptr());
   });
 
+  // The local shards of a sharded XLA tensor, ordered as the local devices, to
+  // a list of PyCapsules, and back. No data is moved between devices.
+  m.def("_to_dlpack_shards", [](const at::Tensor& input) {
+    std::vector<DLManagedTensor*> dlMTensors;
+    {
+      NoGilSection nogil;
+      dlMTensors = torch_xla::toDLPackShards(input);
+    }
+    return DLPackCapsules(dlMTensors);
+  });
+  m.def("_from_dlpack_shards",
+        [](const std::vector<py::handle>& shards,
+           const xla::OpSharding& sharding,
+           const std::vector<int64_t>& global_shape) -> at::Tensor {
+          std::vector<DLManagedTensor*> dlMTensors;
+          dlMTensors.reserve(shards.size());
+          for (const py::handle& shard : shards) {
+            dlMTensors.push_back(DLPackFromCapsule(shard.ptr()));
+          }
+          at::Tensor tensor =
+              torch_xla::fromDLPackShards(dlMTensors, sharding, global_shape);
+          for (const py::handle& shard : shards) {
+            ConsumeDLPackCapsule(shard.ptr());
+          }
+          return tensor;
+        });
+
   // -------------Dynamo Integration API Start-------------------------
   /*
    * Return tensor ids and at::tensors for all DeviceData nodes that is needed
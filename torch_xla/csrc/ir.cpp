@@ -13,6 +13,7 @@
 #include "torch_xla/csrc/runtime/cache.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
 #include "torch_xla/csrc/runtime/sys_util.h"
+#include "torch_xla/csrc/runtime/xla_util.h"
 
 namespace torch_xla {
 namespace {
@@ -146,8 +147,10 @@ XlaOpVector XlaNode::Lower(LoweringContext* loctx) const {
 torch::lazy::hash_t XlaNode::GetOpHash(torch::lazy::OpKind op,
                                        const xla::Shape& shape,
                                        torch::lazy::hash_t hash_seed) {
-  torch::lazy::hash_t h =
-      torch::lazy::HashCombine(op.hash(), torch::lazy::Hash(shape.ToString()));
+  // Like the shape.ToString() it replaces, this leaves the layout out, so that
+  // nodes only differing in their layout keep sharing their hash.
+  torch::lazy::hash_t h = torch::lazy::HashCombine(
+      op.hash(), runtime::util::ShapeHash(shape, /*hash_layout=*/false));
   return torch::lazy::HashCombine(h, hash_seed);
 }
 
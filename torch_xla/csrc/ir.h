@@ -19,6 +19,7 @@
 #include "absl/container/inlined_vector.h"
 #include "absl/hash/hash.h"
 #include "absl/types/span.h"
+#include "torch_xla/csrc/node_pool.h"
 #include "torch_xla/csrc/runtime/types.h"
 #include "xla/client/xla_builder.h"
 
@@ -180,6 +181,19 @@ inline std::ostream& operator<<(std::ostream& stream, const XlaNode& node) {
 
 const xla::Shape& GetXlaShape(const torch::lazy::Value& value);
 
+// Like torch::lazy::MakeNode(), but allocates the node out of the per step
+// NodePool when XLA_IR_NODE_POOL is enabled. Not to be used for DeviceData
+// nodes: they stay around as the IR values of the tensors across steps, and
+// each one would pin a whole chunk.
+template <typename T, typename... Args>
+torch::lazy::NodePtr MakeXlaNode(Args&&... args) {
+  if (NodePool::IsEnabled()) {
+    return std::allocate_shared<T>(NodePoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+  }
+  return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
 template <typename T>
 T* NodeCast(const torch::lazy::Node* node, torch::lazy::OpKind op) {
   if (op != node->op()) {
@@ -27,20 +27,20 @@ struct XLAIrBuilder : torch::lazy::IrBuilder {
 
   torch::lazy::NodePtr MakeScalar(const at::Scalar& value,
                                   const at::ScalarType& type) const override {
-    return torch::lazy::MakeNode<Scalar>(
+    return MakeXlaNode<Scalar>(
         value, MakeXlaPrimitiveType(type, bridge::GetDefaultDevice()));
   }
   torch::lazy::NodePtr MakeExpand(const torch::lazy::Value& input0,
                                   const std::vector<int64_t>& size,
                                   const bool& is_scalar_expand) const override {
     // TODO(JackCaoG): handle is_scalar_expand
-    return torch::lazy::MakeNode<Expand>(input0, size);
+    return MakeXlaNode<Expand>(input0, size);
   }
   torch::lazy::NodePtr MakeCast(const torch::lazy::Value& input0,
                                 const at::ScalarType& dtype,
                                 const std::optional<at::ScalarType>& stype =
                                     std::nullopt) const override {
-    return torch::lazy::MakeNode<Cast>(input0, dtype, stype);
+    return MakeXlaNode<Cast>(input0, dtype, stype);
   }
   torch::lazy::NodePtr MakeTensorList(
       const torch::lazy::OpList& inputs) const override {
@@ -62,19 +62,19 @@ struct XLAIrBuilder : torch::lazy::IrBuilder {
 
   torch::lazy::NodePtr MakeSizeNode(const torch::lazy::Value& input,
                                     size_t dim) const override {
-    return torch::lazy::MakeNode<SizeNode>(input, dim);
+    return MakeXlaNode<SizeNode>(input, dim);
   }
   torch::lazy::NodePtr MakeSizeAdd(const torch::lazy::Value& a,
                                    const torch::lazy::Value& b) const override {
-    return torch::lazy::MakeNode<SizeAdd>(a, b);
+    return MakeXlaNode<SizeAdd>(a, b);
   }
   torch::lazy::NodePtr MakeSizeMul(const torch::lazy::Value& a,
                                    const torch::lazy::Value& b) const override {
-    return torch::lazy::MakeNode<SizeMul>(a, b);
+    return MakeXlaNode<SizeMul>(a, b);
   }
   torch::lazy::NodePtr MakeSizeDiv(const torch::lazy::Value& a,
                                    const torch::lazy::Value& b) const override {
-    return torch::lazy::MakeNode<SizeDiv>(a, b);
+    return MakeXlaNode<SizeDiv>(a, b);
   }
 };
 
@@ -0,0 +1,128 @@
+#include "torch_xla/csrc/node_pool.h"
+
+#include <torch/csrc/lazy/core/metrics.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#include "torch_xla/csrc/runtime/debug_macros.h"
+#include "torch_xla/csrc/runtime/sys_util.h"
+
+namespace torch_xla {
+namespace {
+
+// Sits at the start of each chunk. Chunks are aligned to their size, so the
+// chunk of a block is found by masking its address.
+struct Chunk {
+  // One reference per live block, plus the one of the arena while the chunk
+  // is the current one of its thread.
+  std::atomic<int64_t> refs{1};
+};
+
+constexpr size_t kChunkSize = NodePool::kChunkSize;
+constexpr size_t kHeaderSize = 64;
+static_assert(sizeof(Chunk) <= kHeaderSize, "Chunk header too big");
+static_assert(kHeaderSize % NodePool::kAlignment == 0,
+              "Chunk header breaks the block alignment");
+
+std::atomic<uint64_t> step_generation{0};
+
+size_t BlockSize(size_t size) {
+  return (size + NodePool::kAlignment - 1) & ~(NodePool::kAlignment - 1);
+}
+
+Chunk* ChunkOf(void* ptr) {
+  return reinterpret_cast<Chunk*>(reinterpret_cast<uintptr_t>(ptr) &
+                                  ~(kChunkSize - 1));
+}
+
+void Unref(Chunk* chunk) {
+  if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    chunk->~Chunk();
+    std::free(chunk);
+    TORCH_LAZY_COUNTER("IrNodePoolReleasedChunks", 1);
+  }
+}
+
+struct ThreadArena {
+  ~ThreadArena() { Release(); }
+
+  void Release() {
+    if (chunk != nullptr) {
+      // Counted once per chunk, to keep the shared counter off the per node
+      // path.
+      TORCH_LAZY_COUNTER("IrNodePoolAllocations", allocations);
+      allocations = 0;
+      Unref(chunk);
+      chunk = nullptr;
+    }
+  }
+
+  void NewChunk(uint64_t step) {
+    Release();
+    void* memory = std::aligned_alloc(kChunkSize, kChunkSize);
+    XLA_CHECK(memory != nullptr) << "Failed to allocate an IR node chunk";
+    TORCH_LAZY_COUNTER("IrNodePoolChunks", 1);
+    chunk = new (memory) Chunk();
+    next = static_cast<char*>(memory) + kHeaderSize;
+    end = static_cast<char*>(memory) + kChunkSize;
+    generation = step;
+  }
+
+  Chunk* chunk = nullptr;
+  char* next = nullptr;
+  char* end = nullptr;
+  uint64_t generation = 0;
+  // Blocks allocated out of the current chunk.
+  int64_t allocations = 0;
+};
+
+ThreadArena& GetThreadArena() {
+  static thread_local ThreadArena arena;
+  return arena;
+}
+
+}  // namespace
+
+bool NodePool::IsEnabled() {
+  static const bool enabled =
+      runtime::sys_util::GetEnvBool("XLA_IR_NODE_POOL", false);
+  return enabled;
+}
+
+void* NodePool::Allocate(size_t size) {
+  size_t block_size = BlockSize(size);
+  if (block_size > kMaxBlockSize) {
+    TORCH_LAZY_COUNTER("IrNodePoolOversizedAllocations", 1);
+    return ::operator new(size);
+  }
+  ThreadArena& arena = GetThreadArena();
+  uint64_t step = step_generation.load(std::memory_order_relaxed);
+  if (arena.chunk == nullptr || arena.generation != step ||
+      arena.end - arena.next < static_cast<ptrdiff_t>(block_size)) {
+    arena.NewChunk(step);
+  }
+  // The arena reference keeps the count positive, so no other thread can
+  // release the chunk under us.
+  arena.chunk->refs.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = arena.next;
+  arena.next += block_size;
+  ++arena.allocations;
+  return ptr;
+}
+
+void NodePool::Deallocate(void* ptr, size_t size) {
+  if (BlockSize(size) > kMaxBlockSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  Unref(ChunkOf(ptr));
+}
+
+void NodePool::MarkStep() {
+  step_generation.fetch_add(1, std::memory_order_relaxed);
+  GetThreadArena().Release();
+}
+
+}  // namespace torch_xla
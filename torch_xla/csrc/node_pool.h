@@ -0,0 +1,69 @@
+#ifndef XLA_TORCH_XLA_CSRC_NODE_POOL_H_
+#define XLA_TORCH_XLA_CSRC_NODE_POOL_H_
+
+#include <cstddef>
+#include <new>
+
+namespace torch_xla {
+
+// Per step arena for the IR nodes created while tracing, enabled with
+// XLA_IR_NODE_POOL. Each thread bump allocates its nodes out of its own
+// chunk, and every chunk counts the blocks which are still alive in it. Chunks
+// are never recycled block by block: MarkStep() drops the reference the arena
+// holds on the chunks handed out so far, so that each one is returned to the
+// system in bulk as soon as the last node allocated from it goes away. Nodes
+// which outlive their step keep their chunk alive, but stay valid.
+class NodePool {
+ public:
+  static constexpr size_t kChunkSize = 32 * 1024;
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+  // Bigger blocks are left to the system allocator.
+  static constexpr size_t kMaxBlockSize = kChunkSize / 8;
+
+  static bool IsEnabled();
+
+  static void* Allocate(size_t size);
+
+  static void Deallocate(void* ptr, size_t size);
+
+  // Ends the current step. The chunk of the calling thread is released right
+  // away, the other threads move to new chunks at their next allocation.
+  static void MarkStep();
+};
+
+// Allocator handing out NodePool blocks, to be used with
+// std::allocate_shared() so that the node and its control block share one.
+template <typename T>
+class NodePoolAllocator {
+ public:
+  using value_type = T;
+
+  NodePoolAllocator() = default;
+
+  template <typename U>
+  NodePoolAllocator(const NodePoolAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    static_assert(alignof(T) <= NodePool::kAlignment,
+                  "Over aligned types are not supported");
+    return static_cast<T*>(NodePool::Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    NodePool::Deallocate(ptr, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const NodePoolAllocator<U>&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const NodePoolAllocator<U>&) const {
+    return false;
+  }
+};
+
+}  // namespace torch_xla
+
+#endif  // XLA_TORCH_XLA_CSRC_NODE_POOL_H_
@@ -4,6 +4,7 @@
 #include "torch_xla/csrc/ops/infer_output_shape.h"
 #include "torch_xla/csrc/ops/xla_ops.h"
 #include "torch_xla/csrc/runtime/util.h"
+#include "torch_xla/csrc/torch_util.h"
 
 namespace torch_xla {
 namespace ir {
@@ -28,7 +29,8 @@ Recv::Recv(const torch::lazy::Value& token, const xla::Shape& recv_shape,
           xla_recv, {token},
           [&]() { return NodeOutputShape(token, recv_shape, channel_id); },
           /*num_outputs=*/2,
-          torch::lazy::MHash(channel_id, recv_shape.ToString())),
+          torch::lazy::HashCombine(torch::lazy::MHash(channel_id),
+                                   torch::lazy::Hash(recv_shape))),
       recv_shape_(recv_shape.ToProto()),
       channel_id_(channel_id) {}
 
@@ -1,18 +1,32 @@
 #ifndef XLA_CLIENT_CACHE_H_
 #define XLA_CLIENT_CACHE_H_
 
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <torch/csrc/lazy/core/metrics.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <filesystem>
 #include <fstream>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace torch_xla {
 namespace runtime {
@@ -27,36 +41,85 @@ class AbstractCache {
   virtual TypePtr Get(const K& key) = 0;
   virtual bool Erase(const K& key) = 0;
   virtual void Clear() = 0;
+  // Persists the state which is only kept in memory, if any.
+  virtual void Flush() {}
 };
 
 // Generic key and object cache with LRU expiration policy. The objects of type
 // T will be stored as std::shared_ptr<T> and taken and returned as such, by the
 // cache API.
+//
+// When constructed with a cost function, the cache also tracks the size in
+// bytes and the cost of recreating each object, and evicts objects following
+// the GreedyDual-Size policy: each object gets a priority of cost / bytes on
+// top of an inflation value, which is raised to the priority of every evicted
+// object. Cheap and large objects are evicted first, while objects which have
+// not been used for a while eventually age out. Objects are evicted while the
+// cache holds more than max_size objects or more than max_bytes bytes (if non
+// zero), but the most recently added object is always kept.
 template <typename K, typename T, typename H = std::hash<K>,
           typename E = std::equal_to<K>>
 class Cache : public AbstractCache<K, T, H, E> {
  public:
   using TypePtr = std::shared_ptr<T>;
   using Element = std::pair<K, TypePtr>;
+
+  struct EntryCost {
+    size_t bytes = 0;
+    // The cost of recreating the object, in arbitrary units (e.g., seconds).
+    double cost = 0;
+  };
+  using CostFn = std::function<EntryCost(const T&)>;
+  // Called for every evicted object, outside of the cache lock.
+  using EvictionFn = std::function<void(const K&, const TypePtr&)>;
+
   explicit Cache(size_t max_size) : max_size_(max_size) {}
 
+  Cache(size_t max_size, size_t max_bytes, CostFn cost_fn)
+      : max_size_(max_size),
+        max_bytes_(max_bytes),
+        cost_fn_(std::move(cost_fn)) {}
+
+  void SetEvictionCallback(EvictionFn eviction_fn) {
+    std::lock_guard<std::mutex> slock(lock_);
+    eviction_fn_ = std::move(eviction_fn);
+  }
+
   // Adds an object to the cache, unless it already exists. If the cache grows
   // beyond the limit set during construction, the oldest used object will be
   // removed from the cache.
   TypePtr Add(K key, TypePtr object) override {
-    std::lock_guard<std::mutex> slock(lock_);
-    element_list_.emplace_front(Element(std::move(key), std::move(object)));
-    auto it = element_list_.begin();
-    auto emplace_result = element_map_.emplace(&it->first, it);
-    if (!emplace_result.second) {
-      element_list_.erase(it);
-      DoLRU(emplace_result.first->second);
-    } else if (element_list_.size() > max_size_) {
-      Element* last = &element_list_.back();
-      element_map_.erase(&last->first);
-      element_list_.pop_back();
+    std::vector<Element> evicted;
+    EvictionFn eviction_fn;
+    TypePtr result;
+    // The cost function can be expensive, so it runs outside of the lock.
+    EntryCost cost;
+    if (cost_fn_ && object != nullptr) {
+      cost = cost_fn_(*object);
+    }
+    {
+      std::lock_guard<std::mutex> slock(lock_);
+      element_list_.emplace_front(
+          Entry{Element(std::move(key), std::move(object)), cost, 0});
+      auto it = element_list_.begin();
+      auto emplace_result = element_map_.emplace(&it->element.first, it);
+      if (!emplace_result.second) {
+        element_list_.erase(it);
+        DoLRU(emplace_result.first->second);
+      } else {
+        total_bytes_ += cost.bytes;
+        it->priority = Priority(cost);
+        evicted = EvictLocked();
+        eviction_fn = eviction_fn_;
+      }
+      result = emplace_result.first->second->element.second;
+    }
+    if (eviction_fn) {
+      for (auto& element : evicted) {
+        eviction_fn(element.first, element.second);
+      }
     }
-    return emplace_result.first->second->second;
+    return result;
   }
 
   // Retrieves the existing object if it exists. If it does, it's position in
@@ -70,7 +133,7 @@ class Cache : public AbstractCache<K, T, H, E> {
       return nullptr;
     }
     DoLRU(it->second);
-    return it->second->second;
+    return it->second->element.second;
   }
 
   bool Erase(const K& key) override {
@@ -80,6 +143,7 @@ class Cache : public AbstractCache<K, T, H, E> {
       return false;
     }
     auto lit = it->second;
+    total_bytes_ -= lit->cost.bytes;
     element_map_.erase(it);
     element_list_.erase(lit);
     return true;
@@ -89,10 +153,28 @@ class Cache : public AbstractCache<K, T, H, E> {
     std::lock_guard<std::mutex> slock(lock_);
     element_map_.clear();
     element_list_.clear();
+    total_bytes_ = 0;
+    inflation_ = 0;
+  }
+
+  // Returns the byte budget of the cache, zero if it has none.
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  // Returns the sum of the sizes of the cached objects, as reported by the
+  // cost function.
+  size_t GetTotalBytes() {
+    std::lock_guard<std::mutex> slock(lock_);
+    return total_bytes_;
   }
 
  private:
-  using ElementList = std::list<Element>;
+  struct Entry {
+    Element element;
+    EntryCost cost;
+    double priority;
+  };
+
+  using ElementList = std::list<Entry>;
 
   struct Hasher {
     size_t operator()(const K* key) const { return hasher(*key); }
@@ -112,19 +194,217 @@ class Cache : public AbstractCache<K, T, H, E> {
       std::unordered_map<const K*, typename ElementList::iterator, Hasher,
                          Equaler>;
 
+  double Priority(const EntryCost& cost) const {
+    return inflation_ + cost.cost / std::max<size_t>(cost.bytes, 1);
+  }
+
   void DoLRU(typename ElementList::iterator it) {
     element_list_.splice(element_list_.begin(), element_list_, it);
+    if (cost_fn_) {
+      it->priority = Priority(it->cost);
+    }
+  }
+
+  bool OverBudget() const {
+    return element_list_.size() > max_size_ ||
+           (max_bytes_ > 0 && total_bytes_ > max_bytes_);
+  }
+
+  // Evicts objects until the cache is within its limits, and returns them so
+  // that they are released outside of the lock.
+  std::vector<Element> EvictLocked() {
+    std::vector<Element> evicted;
+    while (element_list_.size() > 1 && OverBudget()) {
+      auto victim = std::prev(element_list_.end());
+      if (cost_fn_) {
+        // Scan from the least recently used object, so that ties are broken
+        // in LRU order. The most recently added object is never evicted.
+        for (auto it = victim; it != element_list_.begin(); --it) {
+          if (it->priority < victim->priority) {
+            victim = it;
+          }
+        }
+        inflation_ = std::max(inflation_, victim->priority);
+      }
+      total_bytes_ -= victim->cost.bytes;
+      element_map_.erase(&victim->element.first);
+      evicted.push_back(std::move(victim->element));
+      element_list_.erase(victim);
+    }
+    return evicted;
   }
 
   std::mutex lock_;
   size_t max_size_ = 0;
+  size_t max_bytes_ = 0;
+  CostFn cost_fn_;
+  EvictionFn eviction_fn_;
+  size_t total_bytes_ = 0;
+  double inflation_ = 0;
   ElementList element_list_;
   ElementMap element_map_;
 };
 
+// Concurrent key and object cache, for caches which are read from many
+// threads. Keys are distributed over independent shards, each one guarded by
+// its own reader/writer lock. Recency is approximated with the CLOCK policy:
+// a hit only sets the reference bit of the object, so lookups proceed in
+// parallel under a shared lock, and an insertion into a full shard evicts the
+// first object found without its reference bit set, clearing the bits it
+// sweeps past.
+template <typename K, typename T, typename H = std::hash<K>,
+          typename E = std::equal_to<K>>
+class ConcurrentCache : public AbstractCache<K, T, H, E> {
+ public:
+  using TypePtr = std::shared_ptr<T>;
+
+  explicit ConcurrentCache(size_t max_size, size_t num_shards = 16)
+      : shards_(std::max<size_t>(num_shards, 1)) {
+    size_t shard_size = std::max<size_t>(
+        (max_size + shards_.size() - 1) / shards_.size(), 1);
+    for (auto& shard : shards_) {
+      shard = std::make_unique<Shard>(shard_size);
+    }
+  }
+
+  // Adds an object to the cache, unless it already exists, in which case the
+  // existing object is returned.
+  TypePtr Add(K key, TypePtr object) override {
+    Shard& shard = GetShard(key);
+    std::unique_lock<std::shared_mutex> slock(shard.lock);
+    auto it = shard.slot_map.find(key);
+    if (it != shard.slot_map.end()) {
+      Slot& slot = shard.slots[it->second];
+      slot.referenced.store(true, std::memory_order_relaxed);
+      return slot.object;
+    }
+    size_t index = shard.slot_map.size();
+    if (index == shard.capacity) {
+      index = shard.Evict();
+    }
+    Slot& slot = shard.slots[index];
+    slot.key = key;
+    slot.object = std::move(object);
+    slot.referenced.store(false, std::memory_order_relaxed);
+    shard.slot_map.emplace(std::move(key), index);
+    return slot.object;
+  }
+
+  // Retrieves the existing object if it exists, marking it as recently used.
+  // Returns nullptr if no object with the specified key is found within the
+  // cache.
+  TypePtr Get(const K& key) override {
+    Shard& shard = GetShard(key);
+    std::shared_lock<std::shared_mutex> slock(shard.lock);
+    auto it = shard.slot_map.find(key);
+    if (it == shard.slot_map.end()) {
+      return nullptr;
+    }
+    Slot& slot = shard.slots[it->second];
+    // Avoid dirtying the cache line when the bit is already set.
+    if (!slot.referenced.load(std::memory_order_relaxed)) {
+      slot.referenced.store(true, std::memory_order_relaxed);
+    }
+    return slot.object;
+  }
+
+  bool Erase(const K& key) override {
+    Shard& shard = GetShard(key);
+    std::unique_lock<std::shared_mutex> slock(shard.lock);
+    auto it = shard.slot_map.find(key);
+    if (it == shard.slot_map.end()) {
+      return false;
+    }
+    // Keep the occupied slots packed at the front of the array, by moving the
+    // last occupied slot into the erased one.
+    size_t index = it->second;
+    size_t last = shard.slot_map.size() - 1;
+    shard.slot_map.erase(it);
+    if (index != last) {
+      Slot& slot = shard.slots[index];
+      Slot& last_slot = shard.slots[last];
+      slot.key = std::move(last_slot.key);
+      slot.object = std::move(last_slot.object);
+      slot.referenced.store(last_slot.referenced.load());
+      shard.slot_map[slot.key] = index;
+    }
+    shard.slots[last].object = nullptr;
+    return true;
+  }
+
+  void Clear() override {
+    for (auto& shard : shards_) {
+      std::unique_lock<std::shared_mutex> slock(shard->lock);
+      shard->slot_map.clear();
+      for (size_t i = 0; i < shard->capacity; ++i) {
+        shard->slots[i].object = nullptr;
+      }
+      shard->hand = 0;
+    }
+  }
+
+ private:
+  struct Slot {
+    K key;
+    TypePtr object;
+    std::atomic<bool> referenced{false};
+  };
+
+  struct Shard {
+    explicit Shard(size_t capacity)
+        : capacity(capacity), slots(new Slot[capacity]) {
+      slot_map.reserve(capacity);
+    }
+
+    // Returns the index of the evicted slot. Must be called with the lock held
+    // in exclusive mode on a full shard.
+    size_t Evict() {
+      while (slots[hand].referenced.exchange(false,
+                                             std::memory_order_relaxed)) {
+        hand = (hand + 1) % capacity;
+      }
+      size_t index = hand;
+      hand = (hand + 1) % capacity;
+      slot_map.erase(slots[index].key);
+      return index;
+    }
+
+    std::shared_mutex lock;
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::unordered_map<K, size_t, H, E> slot_map;
+    size_t hand = 0;
+  };
+
+  Shard& GetShard(const K& key) {
+    // Mix the bits, so that the shard is not correlated with the bucket used
+    // by the shard's map.
+    uint64_t hash = static_cast<uint64_t>(hasher_(key));
+    hash *= 0x9e3779b97f4a7c15ULL;
+    return *shards_[(hash >> 32) % shards_.size()];
+  }
+
+  H hasher_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
 // A persistent cache which serializes values to disk. This wraps a Cache
 // instance, so values will only be read from disk once and subsequent reads
 // will go through the wrapped Cache.
+//
+// Entries are stored in a directory sharded layout (cache_dir/<shard>/<key>)
+// to keep directories small on shared file systems. New entries are written
+// to a temporary file and published with a rename, so concurrent writers,
+// possibly from different processes, never expose partially written entries.
+// An index file tracking the size and last access time of each entry is kept
+// in cache_dir, and is used to evict the least recently used entries once the
+// entries on disk exceed max_disk_bytes (if non zero).
+//
+// The index is only written by the process holding the lock on
+// cache_dir/index.lock, at most once per kIndexSaveIntervalNs and on Flush().
+// Every process counts the entries on disk when it opens the cache, using the
+// index only for their last access time, and then tracks the entries it adds
+// or reads in memory, evicting within the same budget.
 template <typename K, typename T, typename H = std::hash<K>,
           typename E = std::equal_to<K>>
 class PersistentCache : public AbstractCache<K, T, H, E> {
@@ -134,13 +414,32 @@ class PersistentCache : public AbstractCache<K, T, H, E> {
   explicit PersistentCache(
       int kMaxMemoryCacheSize, std::string cache_dir, bool readonly_storage,
       std::function<std::string(const TypePtr&)> serialize,
-      std::function<TypePtr(const std::string&)> deserialize)
+      std::function<TypePtr(std::string_view)> deserialize,
+      size_t max_disk_bytes = 0)
       : memory_cache_(kMaxMemoryCacheSize),
+        serialize_(serialize),
+        deserialize_(deserialize),
         cache_dir_(cache_dir),
         readonly_storage_(readonly_storage),
-        serialize_(serialize),
-        deserialize_(deserialize) {
+        max_disk_bytes_(max_disk_bytes) {
     std::filesystem::create_directories(cache_dir);
+    if (!readonly_storage_) {
+      index_lock_fd_ = open((cache_dir_ / kIndexLockFile).c_str(),
+                            O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+      if (index_lock_fd_ >= 0 &&
+          flock(index_lock_fd_, LOCK_EX | LOCK_NB) != 0) {
+        close(index_lock_fd_);
+        index_lock_fd_ = -1;
+      }
+      LoadIndex();
+    }
+  }
+
+  ~PersistentCache() {
+    Flush();
+    if (index_lock_fd_ >= 0) {
+      close(index_lock_fd_);
+    }
   }
 
   // Add the value to the persistent cache. This only writes to disk if no
@@ -149,37 +448,68 @@ class PersistentCache : public AbstractCache<K, T, H, E> {
   // incur deserialization.
   // If the cache is readonly, nothing is written to disk.
   TypePtr Add(K key, TypePtr obj) override {
-    std::lock_guard<std::mutex> slock(lock_);
-    std::string path = GetPath(key);
-    if (!Exists(path) && !readonly_storage_) {
-      std::ofstream out(path, std::ios::binary);
-      out << serialize_(obj);
+    std::string name = GetName(key);
+    std::filesystem::path path = GetPath(name);
+    if (!readonly_storage_) {
+      std::optional<size_t> existing_size = FileSize(path);
+      if (existing_size) {
+        // Written by another process sharing the cache directory.
+        std::lock_guard<std::mutex> slock(lock_);
+        TrackLocked(name, *existing_size);
+        RemoveEntriesLocked(SelectEvictionsLocked(name));
+      } else {
+        {
+          std::lock_guard<std::mutex> slock(lock_);
+          ++writing_[name];
+        }
+        std::string serialization = serialize_(obj);
+        bool written = WriteAtomically(path, serialization);
+        std::lock_guard<std::mutex> slock(lock_);
+        if (--writing_[name] == 0) {
+          writing_.erase(name);
+        }
+        if (written) {
+          TrackLocked(name, serialization.size());
+          RemoveEntriesLocked(SelectEvictionsLocked(name));
+        } else {
+          TORCH_LAZY_COUNTER("PersistentCacheWriteFailure", 1);
+        }
+      }
+      SaveIndex(/*force=*/false);
     }
-    return memory_cache_.Add(key, obj);
+    return memory_cache_.Add(std::move(key), std::move(obj));
   }
 
   // Get the TypePtr associated with the key. This method will first check
   // if the key is tracked in memory, and if not it will check for a persisted
   // version on disk.
   TypePtr Get(const K& key) override {
-    std::lock_guard<std::mutex> slock(lock_);
     TypePtr mem = memory_cache_.Get(key);
     if (mem) {
       return mem;
     }
 
-    std::string path = GetPath(key);
-    if (!Exists(path)) {
+    std::string name = GetName(key);
+    std::filesystem::path path = GetPath(name);
+    std::unique_ptr<MappedFile> file = MapFile(path);
+    if (!file) {
+      // Entries written by older versions live directly within cache_dir.
+      file = MapFile(cache_dir_ / name);
+    }
+    if (!file) {
       TORCH_LAZY_COUNTER("PersistentCacheMiss", 1);
+      if (!readonly_storage_) {
+        // The entry might have been evicted by another process.
+        std::lock_guard<std::mutex> slock(lock_);
+        UntrackLocked(name);
+      }
       return nullptr;
     }
-    TORCH_LAZY_TIMED("PersistentCacheLoad");
-    std::stringstream ss;
-    std::ifstream in(path, std::ios::binary);
-    ss << in.rdbuf();
-    std::string serialization = ss.str();
-
-    TypePtr val = deserialize_(serialization);
+    TypePtr val;
+    {
+      TORCH_LAZY_TIMED("PersistentCacheLoad");
+      val = deserialize_(file->data());
+    }
     if (!val) {
       TORCH_LAZY_COUNTER("PersistentCacheDeserializeFailure", 1);
       // Remove the serialized value from disk to allow a new value to be stored
@@ -187,54 +517,380 @@ class PersistentCache : public AbstractCache<K, T, H, E> {
       return nullptr;
     }
     TORCH_LAZY_COUNTER("PersistentCacheHit", 1);
+    if (!readonly_storage_) {
+      {
+        std::lock_guard<std::mutex> slock(lock_);
+        TrackLocked(name, file->data().size());
+      }
+      SaveIndex(/*force=*/false);
+    }
     // Make sure the memory_cache_ tracks the value to prevent multiple loads
     return memory_cache_.Add(key, val);
   }
 
   void Clear() override {
-    std::lock_guard<std::mutex> slock(lock_);
     memory_cache_.Clear();
-    // Delete and recreate the cache directory on disk.
+    // Delete the entries on disk, keeping the index lock file, which other
+    // processes might hold.
     if (!readonly_storage_) {
-      std::filesystem::remove_all(cache_dir_);
-      std::filesystem::create_directories(cache_dir_);
+      {
+        std::lock_guard<std::mutex> slock(lock_);
+        index_.clear();
+        disk_bytes_ = 0;
+        index_dirty_ = true;
+      }
+      std::error_code ec;
+      for (auto it = std::filesystem::directory_iterator(cache_dir_, ec);
+           !ec && it != std::filesystem::directory_iterator();
+           it.increment(ec)) {
+        if (it->path().filename() != kIndexLockFile) {
+          std::filesystem::remove_all(it->path(), ec);
+        }
+      }
+      SaveIndex(/*force=*/true);
     }
   }
 
-  bool Erase(const K& key) override {
-    std::lock_guard<std::mutex> slock(lock_);
-    return EraseImpl(key);
+  bool Erase(const K& key) override { return EraseImpl(key); }
+
+  // Writes the index to disk if it changed since it was last written.
+  void Flush() override {
+    if (!readonly_storage_) {
+      SaveIndex(/*force=*/true);
+    }
   }
 
   Cache<K, T, H, E>& GetMemoryCache() { return memory_cache_; }
 
+  // Returns the number of bytes used by the entries tracked on disk.
+  size_t GetDiskBytes() {
+    std::lock_guard<std::mutex> slock(lock_);
+    return disk_bytes_;
+  }
+
  private:
-  std::string GetPath(K key) {
+  struct IndexEntry {
+    size_t size = 0;
+    int64_t last_access = 0;
+  };
+
+  // A read only mapping of a file in memory.
+  class MappedFile {
+   public:
+    MappedFile(void* addr, size_t size) : addr_(addr), size_(size) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+      if (size_ > 0) {
+        munmap(addr_, size_);
+      }
+    }
+
+    std::string_view data() const {
+      return std::string_view(static_cast<const char*>(addr_), size_);
+    }
+
+   private:
+    void* addr_;
+    size_t size_;
+  };
+
+  static constexpr const char* kIndexFile = "index";
+  static constexpr const char* kIndexLockFile = "index.lock";
+  static constexpr const char* kIndexVersion = "v1";
+  static constexpr size_t kNumShards = 256;
+  static constexpr int64_t kIndexSaveIntervalNs = 10'000'000'000;
+
+  static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  std::string GetName(const K& key) {
     std::stringstream ss;
     ss << key;
-    return cache_dir_ / ss.str();
+    return ss.str();
   }
 
-  bool Exists(std::string path) {
+  // Shards entries by a FNV-1a hash of their name, which is stable across
+  // processes and builds sharing the same cache directory.
+  std::filesystem::path GetPath(const std::string& name) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : name) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    char shard[3];
+    std::snprintf(shard, sizeof(shard), "%02x",
+                  static_cast<unsigned>(hash % kNumShards));
+    return cache_dir_ / shard / name;
+  }
+
+  std::optional<size_t> FileSize(const std::filesystem::path& path) {
     struct stat buffer;
-    return stat(path.c_str(), &buffer) == 0;
+    if (stat(path.c_str(), &buffer) != 0) {
+      return std::nullopt;
+    }
+    return buffer.st_size;
+  }
+
+  // Writes data into a temporary file next to path, and renames it into path
+  // once complete. rename() is atomic within a file system, so readers observe
+  // either no entry or a complete one.
+  bool WriteAtomically(const std::filesystem::path& path,
+                       const std::string& data) {
+    static std::atomic<uint64_t> tmp_counter(0);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::filesystem::path tmp_path = path;
+    tmp_path += ".tmp." + std::to_string(getpid()) + "." +
+                std::to_string(tmp_counter++);
+    {
+      std::ofstream out(tmp_path, std::ios::binary);
+      out.write(data.data(), data.size());
+      out.close();
+      if (!out) {
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+      }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+      std::filesystem::remove(tmp_path, ec);
+      return false;
+    }
+    return true;
+  }
+
+  // Maps the file in memory. Returns nullptr if the file is missing.
+  std::unique_ptr<MappedFile> MapFile(const std::filesystem::path& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return nullptr;
+    }
+    std::unique_ptr<MappedFile> file;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      if (st.st_size == 0) {
+        file = std::make_unique<MappedFile>(nullptr, 0);
+      } else {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+          file = std::make_unique<MappedFile>(addr, st.st_size);
+        }
+      }
+    }
+    // The mapping outlives the file descriptor.
+    close(fd);
+    return file;
+  }
+
+  void TrackLocked(const std::string& name, size_t size) {
+    IndexEntry& entry = index_[name];
+    disk_bytes_ += size;
+    disk_bytes_ -= entry.size;
+    entry.size = size;
+    entry.last_access = NowNs();
+    index_dirty_ = true;
+  }
+
+  void UntrackLocked(const std::string& name) {
+    auto it = index_.find(name);
+    if (it != index_.end()) {
+      disk_bytes_ -= it->second.size;
+      index_.erase(it);
+      index_dirty_ = true;
+    }
+  }
+
+  // Removes the least recently used entries from the index until the disk
+  // usage fits within max_disk_bytes_, and returns their names. The entry
+  // named `keep` is never selected.
+  std::vector<std::string> SelectEvictionsLocked(const std::string& keep) {
+    std::vector<std::string> evicted;
+    if (max_disk_bytes_ > 0 && disk_bytes_ > max_disk_bytes_) {
+      std::vector<std::pair<int64_t, std::string>> lru;
+      lru.reserve(index_.size());
+      for (auto& [name, entry] : index_) {
+        if (name != keep) {
+          lru.emplace_back(entry.last_access, name);
+        }
+      }
+      std::sort(lru.begin(), lru.end());
+      size_t evicted_bytes = 0;
+      for (size_t i = 0; i < lru.size() && disk_bytes_ > max_disk_bytes_;
+           ++i) {
+        evicted_bytes += index_[lru[i].second].size;
+        UntrackLocked(lru[i].second);
+        evicted.push_back(std::move(lru[i].second));
+      }
+      TORCH_LAZY_COUNTER("PersistentCacheEviction", evicted.size());
+      TORCH_LAZY_COUNTER("PersistentCacheEvictedBytes", evicted_bytes);
+    }
+    return evicted;
+  }
+
+  // Removes the evicted entries from disk. This happens under lock_, so that
+  // entries which are tracked again, or being written by Add(), since they
+  // were selected keep their file.
+  void RemoveEntriesLocked(const std::vector<std::string>& names) {
+    std::error_code ec;
+    for (auto& name : names) {
+      if (index_.count(name) > 0 || writing_.count(name) > 0) {
+        continue;
+      }
+      std::filesystem::remove(GetPath(name), ec);
+      std::filesystem::remove(cache_dir_ / name, ec);
+    }
+  }
+
+  bool IsEntryFile(const std::filesystem::directory_entry& entry) {
+    std::error_code ec;
+    std::string filename = entry.path().filename().string();
+    return entry.is_regular_file(ec) && filename != kIndexFile &&
+           filename != kIndexLockFile &&
+           filename.find(".tmp.") == std::string::npos;
+  }
+
+  // Uses the modification time of the entry as its last access. It comes
+  // from stat(), as the epoch of std::filesystem::file_time_type is not the
+  // one of the system clock used by NowNs().
+  IndexEntry MakeIndexEntry(const std::filesystem::directory_entry& entry) {
+    IndexEntry index_entry;
+    struct stat buffer;
+    if (stat(entry.path().c_str(), &buffer) == 0) {
+      index_entry.size = buffer.st_size;
+      index_entry.last_access =
+          static_cast<int64_t>(buffer.st_mtim.tv_sec) * 1'000'000'000 +
+          buffer.st_mtim.tv_nsec;
+    }
+    return index_entry;
+  }
+
+  // Tracks the entries on disk by scanning the cache directory, as other
+  // processes might have added or evicted entries since the index was last
+  // written. The index only provides the last access time of the entries it
+  // knows about. Entries in the legacy flat layout live in cache_dir itself,
+  // next to the shard directories.
+  void LoadIndex() {
+    std::unordered_map<std::string, int64_t> saved_last_access;
+    std::ifstream in(cache_dir_ / kIndexFile);
+    std::string version;
+    if (in >> version && version == kIndexVersion) {
+      std::string name;
+      IndexEntry entry;
+      while (in >> name >> entry.size >> entry.last_access) {
+        saved_last_access[name] = entry.last_access;
+      }
+    }
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(cache_dir_,
+                                                                   ec);
+         !ec && it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec)) {
+      if (it.depth() > 1 || !IsEntryFile(*it)) {
+        continue;
+      }
+      std::string name = it->path().filename().string();
+      if (index_.find(name) != index_.end()) {
+        continue;
+      }
+      IndexEntry entry = MakeIndexEntry(*it);
+      auto saved = saved_last_access.find(name);
+      if (saved != saved_last_access.end()) {
+        entry.last_access = saved->second;
+      } else {
+        index_dirty_ = true;
+      }
+      disk_bytes_ += entry.size;
+      index_[name] = entry;
+    }
+    if (index_.size() != saved_last_access.size()) {
+      index_dirty_ = true;
+    }
+  }
+
+  // Writes the index if this process is the index writer and it changed,
+  // at most once per kIndexSaveIntervalNs unless forced. The index is
+  // serialized under lock_, and written to disk outside of it.
+  void SaveIndex(bool force) {
+    if (index_lock_fd_ < 0) {
+      return;
+    }
+    std::string serialization;
+    uint64_t generation;
+    {
+      std::lock_guard<std::mutex> slock(lock_);
+      int64_t now = NowNs();
+      if (!index_dirty_ ||
+          (!force && now - last_index_save_ns_ < kIndexSaveIntervalNs)) {
+        return;
+      }
+      std::stringstream ss;
+      ss << kIndexVersion << "\n";
+      for (auto& [name, entry] : index_) {
+        ss << name << " " << entry.size << " " << entry.last_access << "\n";
+      }
+      serialization = ss.str();
+      index_dirty_ = false;
+      last_index_save_ns_ = now;
+      generation = ++index_generation_;
+    }
+    std::lock_guard<std::mutex> save_lock(index_save_lock_);
+    // A newer snapshot might have been written while waiting.
+    if (generation < saved_index_generation_) {
+      return;
+    }
+    if (WriteAtomically(cache_dir_ / kIndexFile, serialization)) {
+      saved_index_generation_ = generation;
+    } else {
+      std::lock_guard<std::mutex> slock(lock_);
+      index_dirty_ = true;
+    }
   }
 
   bool EraseImpl(const K& key) {
     memory_cache_.Erase(key);
-    return !readonly_storage_ && std::filesystem::remove(GetPath(key));
+    if (readonly_storage_) {
+      return false;
+    }
+    std::string name = GetName(key);
+    {
+      std::lock_guard<std::mutex> slock(lock_);
+      UntrackLocked(name);
+    }
+    std::error_code ec;
+    bool removed = std::filesystem::remove(GetPath(name), ec);
+    return std::filesystem::remove(cache_dir_ / name, ec) || removed;
   }
 
   Cache<K, T, H, E> memory_cache_;
   std::function<std::string(const TypePtr&)> serialize_;
-  std::function<TypePtr(const std::string&)> deserialize_;
+  std::function<TypePtr(std::string_view)> deserialize_;
   std::filesystem::path cache_dir_;
+  // Guards the index and disk usage tracking. Writing entries and the index
+  // file happens outside of it, while evicted entries are removed under it.
   std::mutex lock_;
   // readonly_storage_ controls whether the cache will treat the persistence
   // layer as readonly. When set, operations which mutate the cache, such as
   // Erase and Add, are not written to disk, but they are still applied to the
   // in-memory cache.
   const bool readonly_storage_;
+  // Budget for the entries on disk, in bytes. Zero means unbounded.
+  const size_t max_disk_bytes_;
+  std::unordered_map<std::string, IndexEntry> index_;
+  // The number of Add() calls writing each entry, which must not be removed
+  // by a concurrent eviction.
+  std::unordered_map<std::string, int> writing_;
+  size_t disk_bytes_ = 0;
+  bool index_dirty_ = false;
+  int64_t last_index_save_ns_ = 0;
+  uint64_t index_generation_ = 0;
+  // Held by the process writing the index, -1 in the other ones.
+  int index_lock_fd_ = -1;
+  // Serializes the index writes, and guards saved_index_generation_.
+  std::mutex index_save_lock_;
+  uint64_t saved_index_generation_ = 0;
 };
 
 }  // namespace util
@@ -3,9 +3,14 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 namespace torch_xla {
 namespace runtime {
@@ -38,12 +43,114 @@ TEST(UtilTest, XlaUtilCacheTest) {
   EXPECT_EQ(ptr, nullptr);
 }
 
+TEST(UtilTest, XlaUtilCacheCostAwareTest) {
+  // Each value's cost is its first character, and its size its length.
+  auto cost_fn = [](const std::string& value) {
+    return Cache<int, std::string>::EntryCost{value.size(),
+                                              static_cast<double>(value[0])};
+  };
+  Cache<int, std::string> cache(/*max_size=*/64, /*max_bytes=*/30, cost_fn);
+  std::vector<int> evicted;
+  cache.SetEvictionCallback(
+      [&](const int& key, const std::shared_ptr<std::string>& value) {
+        evicted.push_back(key);
+      });
+
+  // An expensive value, followed by cheap ones of the same size.
+  cache.Add(0, std::make_shared<std::string>(10, 'z'));
+  cache.Add(1, std::make_shared<std::string>(10, 'a'));
+  cache.Add(2, std::make_shared<std::string>(10, 'a'));
+  EXPECT_EQ(cache.GetTotalBytes(), 30);
+  EXPECT_TRUE(evicted.empty());
+
+  // The cheap values are evicted first, even though the expensive one is the
+  // least recently used.
+  cache.Add(3, std::make_shared<std::string>(10, 'a'));
+  EXPECT_THAT(evicted, ::testing::ElementsAre(1));
+  cache.Add(4, std::make_shared<std::string>(10, 'a'));
+  EXPECT_THAT(evicted, ::testing::ElementsAre(1, 2));
+  EXPECT_NE(cache.Get(0), nullptr);
+  EXPECT_EQ(cache.GetTotalBytes(), 30);
+
+  // A single large value evicts as many values as needed, but is kept even if
+  // it exceeds the budget on its own.
+  cache.Add(5, std::make_shared<std::string>(40, 'a'));
+  EXPECT_EQ(evicted.size(), 5);
+  EXPECT_NE(cache.Get(5), nullptr);
+  EXPECT_EQ(cache.GetTotalBytes(), 40);
+
+  EXPECT_TRUE(cache.Erase(5));
+  EXPECT_EQ(cache.GetTotalBytes(), 0);
+}
+
+TEST(UtilTest, XlaUtilConcurrentCacheTest) {
+  static const int kMaxSize = 64;
+  ConcurrentCache<int, std::string> cache(kMaxSize, /*num_shards=*/1);
+
+  for (int i = 0; i < kMaxSize; ++i) {
+    std::string istr = std::to_string(i);
+    auto ptr = cache.Add(i, std::make_shared<std::string>(istr));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(*ptr, istr);
+  }
+  // Adding an existing key returns the cached object.
+  auto ptr = cache.Add(0, std::make_shared<std::string>("ZERO"));
+  EXPECT_EQ(*ptr, "0");
+
+  // Referenced objects survive the next insertions, while the others are
+  // evicted in insertion order.
+  for (int i = 0; i < kMaxSize; i += 2) {
+    ASSERT_NE(cache.Get(i), nullptr);
+  }
+  for (int i = kMaxSize; i < kMaxSize + kMaxSize / 2; ++i) {
+    cache.Add(i, std::make_shared<std::string>(std::to_string(i)));
+  }
+  for (int i = 0; i < kMaxSize; ++i) {
+    EXPECT_EQ(cache.Get(i) != nullptr, i % 2 == 0) << i;
+  }
+
+  EXPECT_TRUE(cache.Erase(0));
+  EXPECT_FALSE(cache.Erase(0));
+  EXPECT_EQ(cache.Get(0), nullptr);
+  ptr = cache.Get(kMaxSize);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(*ptr, std::to_string(kMaxSize));
+  cache.Clear();
+  EXPECT_EQ(cache.Get(kMaxSize), nullptr);
+}
+
+TEST(UtilTest, XlaUtilConcurrentCacheThreadsTest) {
+  static const int kMaxSize = 256;
+  static const int kNumThreads = 8;
+  ConcurrentCache<int, int> cache(kMaxSize);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 10000; ++i) {
+        int key = (i * 7 + t) % (2 * kMaxSize);
+        auto ptr = cache.Get(key);
+        if (ptr == nullptr) {
+          ptr = cache.Add(key, std::make_shared<int>(key));
+        }
+        ASSERT_EQ(*ptr, key);
+        if (i % 100 == 0) {
+          cache.Erase(key);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST(UtilTest, XlaUtilPersistentCacheTest) {
   static const int kMaxSize = 64;
   auto serialize_fn = [](std::shared_ptr<std::string> value) -> std::string {
     return *value;
   };
-  auto deserialize_fn = [](std::string value) -> std::shared_ptr<std::string> {
+  auto deserialize_fn =
+      [](std::string_view value) -> std::shared_ptr<std::string> {
     return std::make_shared<std::string>(value);
   };
   char format[] = "/tmp/tmp.XXXXXX";
@@ -155,6 +262,153 @@ TEST(UtilTest, XlaUtilPersistentCacheTest) {
   unlink(tmpdir);
 }
 
+TEST(UtilTest, XlaUtilPersistentCacheEvictionTest) {
+  static const int kMaxSize = 64;
+  static const size_t kEntryBytes = 100;
+  static const size_t kMaxDiskBytes = 4 * kEntryBytes;
+  auto serialize_fn = [](std::shared_ptr<std::string> value) -> std::string {
+    return *value;
+  };
+  auto deserialize_fn =
+      [](std::string_view value) -> std::shared_ptr<std::string> {
+    return std::make_shared<std::string>(value);
+  };
+  char format[] = "/tmp/tmp.XXXXXX";
+  char* tmpdir = mkdtemp(format);
+  ASSERT_NE(tmpdir, nullptr);
+  auto cache = std::make_unique<PersistentCache<int, std::string>>(
+      kMaxSize, std::string(tmpdir), /*readonly=*/false, serialize_fn,
+      deserialize_fn, kMaxDiskBytes);
+
+  for (int i = 0; i < 8; ++i) {
+    cache->Add(i, std::make_shared<std::string>(kEntryBytes, 'a' + i));
+    EXPECT_LE(cache->GetDiskBytes(), kMaxDiskBytes);
+  }
+  EXPECT_EQ(cache->GetDiskBytes(), kMaxDiskBytes);
+
+  // Entries live in shard subdirectories, and no temporary files are left.
+  size_t num_entries = 0;
+  for (auto& entry :
+       std::filesystem::recursive_directory_iterator(std::string(tmpdir))) {
+    if (entry.is_regular_file() && entry.path().parent_path() != tmpdir) {
+      EXPECT_EQ(entry.path().filename().string().find(".tmp."),
+                std::string::npos);
+      ++num_entries;
+    }
+  }
+  EXPECT_EQ(num_entries, 4);
+
+  // The oldest entries were evicted from disk.
+  cache->GetMemoryCache().Clear();
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(cache->Get(i), nullptr);
+  }
+  // Touch entry 4, so that it becomes the most recently used.
+  auto ptr = cache->Get(4);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(*ptr, std::string(kEntryBytes, 'e'));
+
+  // The index survives the cache being recreated, preserving the LRU order.
+  cache = nullptr;
+  cache = std::make_unique<PersistentCache<int, std::string>>(
+      kMaxSize, std::string(tmpdir), /*readonly=*/false, serialize_fn,
+      deserialize_fn, kMaxDiskBytes);
+  EXPECT_EQ(cache->GetDiskBytes(), kMaxDiskBytes);
+  cache->Add(8, std::make_shared<std::string>(kEntryBytes, 'i'));
+  EXPECT_EQ(cache->Get(5), nullptr);
+  EXPECT_NE(cache->Get(4), nullptr);
+  EXPECT_NE(cache->Get(8), nullptr);
+
+  cache->Clear();
+  EXPECT_EQ(cache->GetDiskBytes(), 0);
+  std::filesystem::remove_all(tmpdir);
+}
+
+TEST(UtilTest, XlaUtilPersistentCacheSharedDirectoryTest) {
+  static const int kMaxSize = 64;
+  static const size_t kEntryBytes = 100;
+  static const size_t kMaxDiskBytes = 4 * kEntryBytes;
+  auto serialize_fn = [](std::shared_ptr<std::string> value) -> std::string {
+    return *value;
+  };
+  auto deserialize_fn =
+      [](std::string_view value) -> std::shared_ptr<std::string> {
+    return std::make_shared<std::string>(value);
+  };
+  char format[] = "/tmp/tmp.XXXXXX";
+  char* tmpdir = mkdtemp(format);
+  ASSERT_NE(tmpdir, nullptr);
+  auto writer = std::make_unique<PersistentCache<int, std::string>>(
+      kMaxSize, std::string(tmpdir), /*readonly=*/false, serialize_fn,
+      deserialize_fn, kMaxDiskBytes);
+  writer->Add(0, std::make_shared<std::string>(kEntryBytes, 'a'));
+  writer->Flush();
+  // Not in the index yet, as it is written at most once per interval.
+  writer->Add(1, std::make_shared<std::string>(kEntryBytes, 'b'));
+  writer->Add(2, std::make_shared<std::string>(kEntryBytes, 'c'));
+
+  // The writer holds the index lock, but the other caches sharing the
+  // directory count all the entries on disk.
+  auto other = std::make_unique<PersistentCache<int, std::string>>(
+      kMaxSize, std::string(tmpdir), /*readonly=*/false, serialize_fn,
+      deserialize_fn, kMaxDiskBytes);
+  EXPECT_EQ(other->GetDiskBytes(), 3 * kEntryBytes);
+  other->Add(3, std::make_shared<std::string>(kEntryBytes, 'd'));
+  other->Add(4, std::make_shared<std::string>(kEntryBytes, 'e'));
+  EXPECT_EQ(other->GetDiskBytes(), kMaxDiskBytes);
+  other->GetMemoryCache().Clear();
+  EXPECT_EQ(other->Get(0), nullptr);
+  EXPECT_NE(other->Get(4), nullptr);
+
+  other = nullptr;
+  writer->Clear();
+  writer = nullptr;
+  std::filesystem::remove_all(tmpdir);
+}
+
+TEST(UtilTest, XlaUtilPersistentCacheLegacyEntriesTest) {
+  static const int kMaxSize = 64;
+  static const size_t kEntryBytes = 100;
+  auto serialize_fn = [](std::shared_ptr<std::string> value) -> std::string {
+    return *value;
+  };
+  auto deserialize_fn =
+      [](std::string_view value) -> std::shared_ptr<std::string> {
+    return std::make_shared<std::string>(value);
+  };
+  char format[] = "/tmp/tmp.XXXXXX";
+  char* tmpdir = mkdtemp(format);
+  ASSERT_NE(tmpdir, nullptr);
+  auto cache = std::make_unique<PersistentCache<int, std::string>>(
+      kMaxSize, std::string(tmpdir), /*readonly=*/false, serialize_fn,
+      deserialize_fn, 2 * kEntryBytes);
+  cache->Add(0, std::make_shared<std::string>(kEntryBytes, 'a'));
+  cache = nullptr;
+
+  // An entry written in the flat layout of older versions, next to the index.
+  {
+    std::ofstream out(std::filesystem::path(tmpdir) / "1", std::ios::binary);
+    out << std::string(kEntryBytes, 'b');
+  }
+  cache = std::make_unique<PersistentCache<int, std::string>>(
+      kMaxSize, std::string(tmpdir), /*readonly=*/false, serialize_fn,
+      deserialize_fn, 2 * kEntryBytes);
+  EXPECT_EQ(cache->GetDiskBytes(), 2 * kEntryBytes);
+  auto ptr = cache->Get(1);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(*ptr, std::string(kEntryBytes, 'b'));
+
+  // The legacy entry counts toward the budget, and is evicted like the others.
+  cache->Add(2, std::make_shared<std::string>(kEntryBytes, 'c'));
+  EXPECT_EQ(cache->GetDiskBytes(), 2 * kEntryBytes);
+  cache->GetMemoryCache().Clear();
+  EXPECT_EQ(cache->Get(0), nullptr);
+  EXPECT_NE(cache->Get(1), nullptr);
+
+  cache->Clear();
+  std::filesystem::remove_all(tmpdir);
+}
+
 }  // namespace util
 }  // namespace runtime
 }  // namespace torch_xla
@@ -1,15 +1,20 @@
 #include "torch_xla/csrc/runtime/computation_client.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <exception>
 #include <fstream>
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
 #include "torch_xla/csrc/runtime/env_vars.h"
 #include "torch_xla/csrc/runtime/sys_util.h"
@@ -30,6 +35,68 @@ std::shared_ptr<ComputationClient::Computation> ComputationClient::Compile(
   return std::move(results[0]);
 }
 
+std::vector<ComputationClient::ComputationPtr>
+ComputationClient::CompileInstances(
+    std::vector<CompileInstance>& instances,
+    const std::function<ComputationPtr(CompileInstance&)>& compile_fn,
+    tsl::thread::ThreadPool* pool) {
+  static const int64_t max_parallel_compiles = sys_util::GetEnvInt(
+      "XLA_PARALLEL_COMPILE_MAX_THREADS", std::thread::hardware_concurrency());
+  std::vector<ComputationPtr> computations(instances.size());
+  if (instances.size() == 1 || max_parallel_compiles <= 1) {
+    for (size_t i = 0; i < instances.size(); ++i) {
+      computations[i] = compile_fn(instances[i]);
+    }
+    return computations;
+  }
+
+  metrics::TimedSection timed(CompileParallelMetric());
+  std::vector<std::exception_ptr> errors(instances.size());
+  std::atomic<size_t> next_instance(0);
+  auto compile_loop = [&]() {
+    for (size_t i = next_instance++; i < instances.size();
+         i = next_instance++) {
+      try {
+        computations[i] = compile_fn(instances[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  // The calling thread takes part in the compilation, so only num_workers - 1
+  // closures are scheduled on the pool.
+  size_t num_workers =
+      std::min<size_t>(instances.size(), max_parallel_compiles);
+  absl::BlockingCounter counter(num_workers - 1);
+  for (size_t i = 1; i < num_workers; ++i) {
+    pool->Schedule([&]() {
+      compile_loop();
+      counter.DecrementCount();
+    });
+  }
+  compile_loop();
+  counter.Wait();
+
+  std::vector<std::string> failures;
+  for (size_t i = 0; i < errors.size(); ++i) {
+    if (errors[i] == nullptr) {
+      continue;
+    }
+    try {
+      std::rethrow_exception(errors[i]);
+    } catch (const std::exception& ex) {
+      failures.push_back(absl::StrCat("instance ", i, ": ", ex.what()));
+    } catch (...) {
+      failures.push_back(absl::StrCat("instance ", i, ": unknown error"));
+    }
+  }
+  XLA_CHECK(failures.empty())
+      << "Failed to compile " << failures.size() << " of " << instances.size()
+      << " computations:\n"
+      << absl::StrJoin(failures, "\n");
+  return computations;
+}
+
 std::vector<std::string> ComputationClient::GetCompilationDevices(
     const std::string& device, absl::Span<const std::string> devices) {
   std::vector<std::string> compilation_devices;
@@ -47,6 +114,37 @@ std::vector<std::string> ComputationClient::GetCompilationDevices(
   return compilation_devices;
 }
 
+std::vector<std::shared_future<ComputationClient::DataPtr>>
+ComputationClient::TransferToDeviceAsync(
+    std::vector<std::shared_ptr<const TensorSource>> tensors) {
+  std::vector<DataPtr> datas = TransferToDevice(absl::MakeConstSpan(tensors));
+  std::vector<std::shared_future<DataPtr>> futures;
+  futures.reserve(datas.size());
+  for (auto& data : datas) {
+    std::promise<DataPtr> promise;
+    promise.set_value(std::move(data));
+    futures.push_back(promise.get_future().share());
+  }
+  return futures;
+}
+
+std::vector<std::shared_future<void>>
+ComputationClient::TransferFromDeviceAsync(
+    absl::Span<const DataPtr> handles,
+    std::vector<xla::MutableBorrowingLiteral> destinations) {
+  XLA_CHECK_EQ(handles.size(), destinations.size());
+  std::vector<xla::Literal> literals = TransferFromDevice(handles);
+  std::vector<std::shared_future<void>> futures;
+  futures.reserve(literals.size());
+  for (size_t i = 0; i < literals.size(); ++i) {
+    XLA_CHECK_OK(destinations[i].CopyFrom(literals[i]));
+    std::promise<void> promise;
+    promise.set_value();
+    futures.push_back(promise.get_future().share());
+  }
+  return futures;
+}
+
 int64_t ComputationClient::GetDeviceOrdinal(const std::string& device) {
   auto pos = device.rfind(':');
   XLA_CHECK_NE(pos, std::string::npos) << device;
@@ -54,8 +152,9 @@ int64_t ComputationClient::GetDeviceOrdinal(const std::string& device) {
 }
 
 metrics::Metric* ComputationClient::TransferToDeviceMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("TransferToDeviceTime", metrics::MetricFnTime);
+  static metrics::Metric* metric = new metrics::Metric(
+      "TransferToDeviceTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
@@ -66,38 +165,50 @@ metrics::Metric* ComputationClient::TransferToDeviceTransformMetric() {
 }
 
 metrics::Metric* ComputationClient::TransferFromDeviceMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("TransferFromDeviceTime", metrics::MetricFnTime);
+  static metrics::Metric* metric = new metrics::Metric(
+      "TransferFromDeviceTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
 metrics::Metric* ComputationClient::CompileMetric() {
+  static metrics::Metric* metric = new metrics::Metric(
+      "CompileTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
+  return metric;
+}
+
+metrics::Metric* ComputationClient::CompileParallelMetric() {
   static metrics::Metric* metric =
-      new metrics::Metric("CompileTime", metrics::MetricFnTime);
+      new metrics::Metric("CompileParallelTime", metrics::MetricFnTime);
   return metric;
 }
 
 metrics::Metric* ComputationClient::EagerCompileMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("EagerOpCompileTime", metrics::MetricFnTime);
+  static metrics::Metric* metric = new metrics::Metric(
+      "EagerOpCompileTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
 metrics::Metric* ComputationClient::ExecuteMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("ExecuteTime", metrics::MetricFnTime);
+  static metrics::Metric* metric = new metrics::Metric(
+      "ExecuteTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
 metrics::Metric* ComputationClient::EagerExecuteMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("EagerOpExecuteTime", metrics::MetricFnTime);
+  static metrics::Metric* metric = new metrics::Metric(
+      "EagerOpExecuteTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
 metrics::Metric* ComputationClient::ExecuteReplicatedMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("ExecuteReplicatedTime", metrics::MetricFnTime);
+  static metrics::Metric* metric = new metrics::Metric(
+      "ExecuteReplicatedTime", metrics::MetricFnTime, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
@@ -183,14 +294,16 @@ metrics::Counter* ComputationClient::StableHloCompileCounter() {
 }
 
 metrics::Metric* ComputationClient::InboundDataMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("InboundData", metrics::MetricFnBytes);
+  static metrics::Metric* metric = new metrics::Metric(
+      "InboundData", metrics::MetricFnBytes, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
 metrics::Metric* ComputationClient::OutboundDataMetric() {
-  static metrics::Metric* metric =
-      new metrics::Metric("OutboundData", metrics::MetricFnBytes);
+  static metrics::Metric* metric = new metrics::Metric(
+      "OutboundData", metrics::MetricFnBytes, /*max_samples=*/0,
+      /*lifetime_histogram=*/true);
   return metric;
 }
 
@@ -10,12 +10,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/span.h"
 #include "torch_xla/csrc/device.h"
@@ -24,6 +27,7 @@
 #include "torch_xla/csrc/runtime/tensor_source.h"
 #include "torch_xla/csrc/runtime/types.h"
 #include "torch_xla/csrc/runtime/util.h"
+#include "tsl/platform/threadpool.h"
 #include "xla/client/xla_computation.h"
 #include "xla/hlo/ir/hlo_module.h"
 #include "xla/literal_util.h"
@@ -198,6 +202,12 @@ class ComputationClient {
       XLA_ERROR() << "Unimplemented";
     }
 
+    // Returns the number of bytes held by the compiled program, used to budget
+    // the computation cache. Defaults to the size of the HLO module.
+    virtual size_t memory_size_bytes() const {
+      return computation_moved_ ? 0 : computation_.proto().ByteSizeLong();
+    }
+
    private:
     xla::XlaComputation computation_;
     xla::ProgramShape program_shape_;
@@ -289,6 +299,16 @@ class ComputationClient {
   virtual std::vector<DataPtr> TransferToDevice(
       absl::Span<const std::shared_ptr<const TensorSource>> tensors) = 0;
 
+  // Same as TransferToDevice(), but returns immediately, with one future per
+  // tensor which becomes ready once the tensor's transfer has been issued.
+  // Tensors are prepared and handed to the device in order, so the host side
+  // preparation of a tensor overlaps with the transfer of the previous ones,
+  // and callers can start using the first handles before the last tensors
+  // have been prepared. The sources are snapshotted before returning, so the
+  // caller may modify the tensors they were created from right away.
+  virtual std::vector<std::shared_future<DataPtr>> TransferToDeviceAsync(
+      std::vector<std::shared_ptr<const TensorSource>> tensors);
+
   // Reshard and return data sharded by `sharding` spec. This is a no-op if the
   // input sharding spec is identical to the target `sharding` sharding spec.
   virtual std::vector<DataPtr> ReshardData(
@@ -312,6 +332,16 @@ class ComputationClient {
   virtual std::vector<xla::Literal> TransferFromDevice(
       absl::Span<const DataPtr> handles) = 0;
 
+  // Starts copying the data behind each handle into the host memory borrowed
+  // by the matching destination, whose shape must have the element type and
+  // dimensions of the handle, and can have any host layout. Returns one future
+  // per handle, which becomes ready once its destination has been written, so
+  // callers can consume the first outputs while the later ones are still in
+  // flight. The destination memory must remain valid until then.
+  virtual std::vector<std::shared_future<void>> TransferFromDeviceAsync(
+      absl::Span<const DataPtr> handles,
+      std::vector<xla::MutableBorrowingLiteral> destinations);
+
   virtual std::uintptr_t UnsafeBufferPointer(const DataPtr handle) = 0;
 
   virtual std::shared_ptr<xla::PjRtBuffer> GetPjRtBuffer(
@@ -328,7 +358,7 @@ class ComputationClient {
   // Deserialize a string resulting from SerializeComputation back to a
   // Computation. If the deserialization fails, nullptr is returned.
   virtual ComputationPtr DeserializeComputation(
-      const std::string& serialized) = 0;
+      absl::string_view serialized) = 0;
 
   // Returns a hash of the current compilation environment.
   virtual torch::lazy::hash_t HashCompilationEnv() = 0;
@@ -426,11 +456,22 @@ class ComputationClient {
  protected:
   static constexpr auto spmd_device_str = "SPMD:0";
 
+  // Compiles each of the instances with compile_fn. When there is more than
+  // one instance, up to XLA_PARALLEL_COMPILE_MAX_THREADS of them are compiled
+  // concurrently using `pool` and the calling thread. A failing instance does
+  // not stop the others, and all the failures are reported together once
+  // every instance has been processed.
+  static std::vector<ComputationPtr> CompileInstances(
+      std::vector<CompileInstance>& instances,
+      const std::function<ComputationPtr(CompileInstance&)>& compile_fn,
+      tsl::thread::ThreadPool* pool);
+
   // Metrics common to all client interfaces.
   static metrics::Metric* TransferToDeviceMetric();
   static metrics::Metric* TransferToDeviceTransformMetric();
   static metrics::Metric* TransferFromDeviceMetric();
   static metrics::Metric* CompileMetric();
+  static metrics::Metric* CompileParallelMetric();
   static metrics::Metric* EagerCompileMetric();
   static metrics::Metric* ExecuteMetric();
   static metrics::Metric* EagerExecuteMetric();
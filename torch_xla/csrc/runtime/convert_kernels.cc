@@ -0,0 +1,409 @@
+#include "torch_xla/csrc/runtime/convert_kernels.h"
+
+#include <cstring>
+
+#include "torch_xla/csrc/runtime/debug_macros.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XLA_CONVERT_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace torch_xla {
+namespace runtime {
+namespace {
+
+uint32_t FloatToBits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float BitsToFloat(uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+uint16_t FloatToBFloat16Scalar(float value) {
+  uint32_t bits = FloatToBits(value);
+  if ((bits & 0x7fffffff) > 0x7f800000) {
+    // Squash NaNs to a quiet NaN, so that truncation cannot turn them into
+    // infinities.
+    return static_cast<uint16_t>(((bits >> 16) & 0x8000) | 0x7fc0);
+  }
+  uint32_t lsb = (bits >> 16) & 1;
+  return static_cast<uint16_t>((bits + 0x7fff + lsb) >> 16);
+}
+
+float BFloat16ToFloatScalar(uint16_t value) {
+  return BitsToFloat(static_cast<uint32_t>(value) << 16);
+}
+
+// Same bit manipulations as the Eigen::half software conversions.
+uint16_t FloatToHalfScalar(float value) {
+  const uint32_t f32_infinity = 255 << 23;
+  const uint32_t f16_max = (127 + 16) << 23;
+  const uint32_t denorm_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+  uint32_t bits = FloatToBits(value);
+  uint32_t sign = bits & 0x80000000;
+  bits ^= sign;
+  uint16_t result;
+  if (bits >= f16_max) {
+    // Infinity or NaN, all exponent bits set.
+    result = bits > f32_infinity ? 0x7e00 : 0x7c00;
+  } else if (bits < (113 << 23)) {
+    // The result is a subnormal or zero, let the FPU do the rounding.
+    float rounded = BitsToFloat(bits) + BitsToFloat(denorm_magic);
+    result = static_cast<uint16_t>(FloatToBits(rounded) - denorm_magic);
+  } else {
+    uint32_t mantissa_odd = (bits >> 13) & 1;
+    // Rebias the exponent and round to nearest even.
+    bits += 0xc8000fff;
+    bits += mantissa_odd;
+    result = static_cast<uint16_t>(bits >> 13);
+  }
+  return result | static_cast<uint16_t>(sign >> 16);
+}
+
+float HalfToFloatScalar(uint16_t value) {
+  const uint32_t shifted_exponent = 0x7c00 << 13;
+  uint32_t bits = static_cast<uint32_t>(value & 0x7fff) << 13;
+  uint32_t exponent = bits & shifted_exponent;
+  bits += (127 - 15) << 23;
+  if (exponent == shifted_exponent) {
+    // Infinity or NaN.
+    bits += (128 - 16) << 23;
+  } else if (exponent == 0) {
+    // Zero or subnormal, renormalize.
+    bits += 1 << 23;
+    bits = FloatToBits(BitsToFloat(bits) - BitsToFloat(113 << 23));
+  }
+  return BitsToFloat(bits | static_cast<uint32_t>(value & 0x8000) << 16);
+}
+
+void FloatToBFloat16Loop(const float* src, uint16_t* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = FloatToBFloat16Scalar(src[i]);
+  }
+}
+
+void BFloat16ToFloatLoop(const uint16_t* src, float* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = BFloat16ToFloatScalar(src[i]);
+  }
+}
+
+void FloatToHalfLoop(const float* src, uint16_t* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = FloatToHalfScalar(src[i]);
+  }
+}
+
+void HalfToFloatLoop(const uint16_t* src, float* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = HalfToFloatScalar(src[i]);
+  }
+}
+
+void DoubleToFloatLoop(const double* src, float* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = static_cast<float>(src[i]);
+  }
+}
+
+void Int64ToInt32Loop(const int64_t* src, int32_t* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = static_cast<int32_t>(src[i]);
+  }
+}
+
+void Uint8ToBoolLoop(const uint8_t* src, bool* dest, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dest[i] = src[i] != 0;
+  }
+}
+
+#ifdef XLA_CONVERT_KERNELS_X86
+
+#define XLA_TARGET_AVX2 __attribute__((target("avx2,f16c")))
+#define XLA_TARGET_AVX512 __attribute__((target("avx2,f16c,avx512f")))
+
+XLA_TARGET_AVX2 __m256i FloatToBFloat16Avx2(__m256i bits) {
+  const __m256i one = _mm256_set1_epi32(1);
+  __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), one);
+  __m256i bias = _mm256_add_epi32(_mm256_set1_epi32(0x7fff), lsb);
+  __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, bias), 16);
+  __m256i abs_bits = _mm256_and_si256(bits, _mm256_set1_epi32(0x7fffffff));
+  __m256i is_nan =
+      _mm256_cmpgt_epi32(abs_bits, _mm256_set1_epi32(0x7f800000));
+  __m256i nan = _mm256_or_si256(
+      _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(0x8000)),
+      _mm256_set1_epi32(0x7fc0));
+  return _mm256_blendv_epi8(rounded, nan, is_nan);
+}
+
+XLA_TARGET_AVX2 void FloatToBFloat16Avx2(const float* src, uint16_t* dest,
+                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i lo = FloatToBFloat16Avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    __m256i hi = FloatToBFloat16Avx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 8)));
+    // The pack works within 128 bit lanes, restore the element order.
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi),
+                                              _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), packed);
+  }
+  FloatToBFloat16Loop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX2 void BFloat16ToFloatAvx2(const uint16_t* src, float* dest,
+                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i bits = _mm256_slli_epi32(
+        _mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+        16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), bits);
+  }
+  BFloat16ToFloatLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX2 void FloatToHalfAvx2(const float* src, uint16_t* dest,
+                                     int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i half =
+        _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), half);
+  }
+  FloatToHalfLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX2 void HalfToFloatAvx2(const uint16_t* src, float* dest,
+                                     int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(dest + i,
+                     _mm256_cvtph_ps(_mm_loadu_si128(
+                         reinterpret_cast<const __m128i*>(src + i))));
+  }
+  HalfToFloatLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX2 void DoubleToFloatAvx2(const double* src, float* dest,
+                                       int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i));
+    __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(src + i + 4));
+    _mm256_storeu_ps(dest + i,
+                     _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1));
+  }
+  DoubleToFloatLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX2 void Int64ToInt32Avx2(const int64_t* src, int32_t* dest,
+                                      int64_t n) {
+  // Gathers the low halves of the 64 bit elements in the lower 128 bits.
+  const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i lo = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)),
+        low_halves);
+    __m256i hi = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 4)),
+        low_halves);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+  }
+  Int64ToInt32Loop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX2 void Uint8ToBoolAvx2(const uint8_t* src, bool* dest,
+                                     int64_t n) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi8(1);
+  int64_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i is_zero = _mm256_cmpeq_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), zero);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm256_andnot_si256(is_zero, one));
+  }
+  Uint8ToBoolLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX512 void FloatToBFloat16Avx512(const float* src, uint16_t* dest,
+                                             int64_t n) {
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i bias = _mm512_set1_epi32(0x7fff);
+  const __m512i abs_mask = _mm512_set1_epi32(0x7fffffff);
+  const __m512i infinity = _mm512_set1_epi32(0x7f800000);
+  const __m512i sign_mask = _mm512_set1_epi32(0x8000);
+  const __m512i quiet_nan = _mm512_set1_epi32(0x7fc0);
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i bits = _mm512_loadu_si512(src + i);
+    __m512i high = _mm512_srli_epi32(bits, 16);
+    __m512i lsb = _mm512_and_si512(high, one);
+    __m512i rounded = _mm512_srli_epi32(
+        _mm512_add_epi32(bits, _mm512_add_epi32(bias, lsb)), 16);
+    __mmask16 is_nan =
+        _mm512_cmpgt_epi32_mask(_mm512_and_si512(bits, abs_mask), infinity);
+    __m512i nan = _mm512_or_si512(_mm512_and_si512(high, sign_mask), quiet_nan);
+    __m512i result = _mm512_mask_blend_epi32(is_nan, rounded, nan);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm512_cvtepi32_epi16(result));
+  }
+  FloatToBFloat16Loop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX512 void BFloat16ToFloatAvx512(const uint16_t* src, float* dest,
+                                             int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m512i bits = _mm512_slli_epi32(
+        _mm512_cvtepu16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))),
+        16);
+    _mm512_storeu_si512(dest + i, bits);
+  }
+  BFloat16ToFloatLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX512 void FloatToHalfAvx512(const float* src, uint16_t* dest,
+                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i half =
+        _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), half);
+  }
+  FloatToHalfLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX512 void HalfToFloatAvx512(const uint16_t* src, float* dest,
+                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_ps(dest + i,
+                     _mm512_cvtph_ps(_mm256_loadu_si256(
+                         reinterpret_cast<const __m256i*>(src + i))));
+  }
+  HalfToFloatLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX512 void DoubleToFloatAvx512(const double* src, float* dest,
+                                           int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(dest + i, _mm512_cvtpd_ps(_mm512_loadu_pd(src + i)));
+  }
+  DoubleToFloatLoop(src + i, dest + i, n - i);
+}
+
+XLA_TARGET_AVX512 void Int64ToInt32Avx512(const int64_t* src, int32_t* dest,
+                                          int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i),
+                        _mm512_cvtepi64_epi32(_mm512_loadu_si512(src + i)));
+  }
+  Int64ToInt32Loop(src + i, dest + i, n - i);
+}
+
+#undef XLA_TARGET_AVX2
+#undef XLA_TARGET_AVX512
+
+#endif  // XLA_CONVERT_KERNELS_X86
+
+const ConvertKernels kScalarKernels = {
+    FloatToBFloat16Loop, BFloat16ToFloatLoop, FloatToHalfLoop,
+    HalfToFloatLoop,     DoubleToFloatLoop,   Int64ToInt32Loop,
+    Uint8ToBoolLoop,
+};
+
+#ifdef XLA_CONVERT_KERNELS_X86
+const ConvertKernels kAvx2Kernels = {
+    FloatToBFloat16Avx2, BFloat16ToFloatAvx2, FloatToHalfAvx2,
+    HalfToFloatAvx2,     DoubleToFloatAvx2,   Int64ToInt32Avx2,
+    Uint8ToBoolAvx2,
+};
+
+// Byte compares need AVX512BW, which AVX512F alone does not imply, so the
+// bool conversion stays on AVX2.
+const ConvertKernels kAvx512Kernels = {
+    FloatToBFloat16Avx512, BFloat16ToFloatAvx512, FloatToHalfAvx512,
+    HalfToFloatAvx512,     DoubleToFloatAvx512,   Int64ToInt32Avx512,
+    Uint8ToBoolAvx2,
+};
+#endif  // XLA_CONVERT_KERNELS_X86
+
+}  // namespace
+
+const char* ConvertIsaName(ConvertIsa isa) {
+  switch (isa) {
+    case ConvertIsa::kScalar:
+      return "scalar";
+    case ConvertIsa::kAvx2:
+      return "avx2";
+    case ConvertIsa::kAvx512:
+      return "avx512";
+  }
+  XLA_ERROR() << "Invalid conversion ISA: " << static_cast<int>(isa);
+}
+
+bool IsConvertIsaSupported(ConvertIsa isa) {
+  switch (isa) {
+    case ConvertIsa::kScalar:
+      return true;
+#ifdef XLA_CONVERT_KERNELS_X86
+    case ConvertIsa::kAvx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+    case ConvertIsa::kAvx512:
+      return IsConvertIsaSupported(ConvertIsa::kAvx2) &&
+             __builtin_cpu_supports("avx512f");
+#endif  // XLA_CONVERT_KERNELS_X86
+    default:
+      return false;
+  }
+}
+
+ConvertIsa GetBestConvertIsa() {
+  static const ConvertIsa isa = []() {
+    for (ConvertIsa isa : {ConvertIsa::kAvx512, ConvertIsa::kAvx2}) {
+      if (IsConvertIsaSupported(isa)) {
+        return isa;
+      }
+    }
+    return ConvertIsa::kScalar;
+  }();
+  return isa;
+}
+
+const ConvertKernels& GetConvertKernels(ConvertIsa isa) {
+  XLA_CHECK(IsConvertIsaSupported(isa))
+      << "Conversion ISA not supported by the host: " << ConvertIsaName(isa);
+  switch (isa) {
+#ifdef XLA_CONVERT_KERNELS_X86
+    case ConvertIsa::kAvx2:
+      return kAvx2Kernels;
+    case ConvertIsa::kAvx512:
+      return kAvx512Kernels;
+#endif  // XLA_CONVERT_KERNELS_X86
+    default:
+      return kScalarKernels;
+  }
+}
+
+const ConvertKernels& GetConvertKernels() {
+  return GetConvertKernels(GetBestConvertIsa());
+}
+
+}  // namespace runtime
+}  // namespace torch_xla
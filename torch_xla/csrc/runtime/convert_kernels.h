@@ -0,0 +1,48 @@
+#ifndef XLA_CLIENT_CONVERT_KERNELS_H_
+#define XLA_CLIENT_CONVERT_KERNELS_H_
+
+#include <cstdint>
+
+namespace torch_xla {
+namespace runtime {
+
+// Instruction sets the element type conversion kernels are specialized for.
+enum class ConvertIsa {
+  kScalar,
+  kAvx2,
+  kAvx512,
+};
+
+// Kernels converting n contiguous elements from src to dest. The 16 bit
+// floating point types are passed as their bit patterns. Narrowing floating
+// point conversions round to nearest even, matching the static_cast<> of the
+// tsl/Eigen bfloat16 and half types, except for NaN payloads which are not
+// guaranteed to be preserved.
+struct ConvertKernels {
+  void (*float_to_bfloat16)(const float* src, uint16_t* dest, int64_t n);
+  void (*bfloat16_to_float)(const uint16_t* src, float* dest, int64_t n);
+  void (*float_to_half)(const float* src, uint16_t* dest, int64_t n);
+  void (*half_to_float)(const uint16_t* src, float* dest, int64_t n);
+  void (*double_to_float)(const double* src, float* dest, int64_t n);
+  void (*int64_to_int32)(const int64_t* src, int32_t* dest, int64_t n);
+  void (*uint8_to_bool)(const uint8_t* src, bool* dest, int64_t n);
+};
+
+const char* ConvertIsaName(ConvertIsa isa);
+
+bool IsConvertIsaSupported(ConvertIsa isa);
+
+// Returns the most capable instruction set supported by the host CPU.
+ConvertIsa GetBestConvertIsa();
+
+// Returns the kernels for the given instruction set, which must be supported
+// by the host CPU.
+const ConvertKernels& GetConvertKernels(ConvertIsa isa);
+
+// Returns the kernels for GetBestConvertIsa().
+const ConvertKernels& GetConvertKernels();
+
+}  // namespace runtime
+}  // namespace torch_xla
+
+#endif  // XLA_CLIENT_CONVERT_KERNELS_H_
@@ -0,0 +1,210 @@
+#include "torch_xla/csrc/runtime/convert_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "tsl/platform/bfloat16.h"
+#include "xla/types.h"
+
+namespace torch_xla {
+namespace runtime {
+namespace {
+
+// Not a multiple of any vector width, so that the scalar tails get exercised.
+constexpr int64_t kNumElements = 4099;
+
+std::vector<float> MakeFloats() {
+  std::vector<float> values = {0.0f,
+                               -0.0f,
+                               1.0f,
+                               -1.5f,
+                               65504.0f,
+                               65520.0f,
+                               1e-8f,
+                               6e-8f,
+                               std::numeric_limits<float>::denorm_min(),
+                               std::numeric_limits<float>::max(),
+                               std::numeric_limits<float>::infinity(),
+                               -std::numeric_limits<float>::infinity(),
+                               std::numeric_limits<float>::quiet_NaN(),
+                               -std::numeric_limits<float>::quiet_NaN()};
+  // Values exactly halfway between two bfloat16 numbers.
+  for (uint32_t bits : {0x3f808000u, 0x3f818000u, 0xbf808000u}) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    values.push_back(value);
+  }
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<uint32_t> bits_dist;
+  std::normal_distribution<float> normal_dist(0.0f, 1000.0f);
+  while (values.size() < kNumElements) {
+    if (values.size() % 2 == 0) {
+      uint32_t bits = bits_dist(gen);
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      values.push_back(value);
+    } else {
+      values.push_back(normal_dist(gen));
+    }
+  }
+  return values;
+}
+
+std::vector<uint16_t> MakeHalfBits() {
+  std::vector<uint16_t> values(kNumElements);
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    values[i] = static_cast<uint16_t>(i * 16 + i / 4096);
+  }
+  return values;
+}
+
+bool IsBFloat16NaN(uint16_t bits) {
+  return (bits & 0x7f80) == 0x7f80 && (bits & 0x7f) != 0;
+}
+
+bool IsHalfNaN(uint16_t bits) {
+  return (bits & 0x7c00) == 0x7c00 && (bits & 0x3ff) != 0;
+}
+
+void ExpectSameFloats(const std::vector<float>& expected,
+                      const std::vector<float>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(actual[i])) << "at " << i;
+    } else {
+      EXPECT_EQ(std::memcmp(&expected[i], &actual[i], sizeof(float)), 0)
+          << "at " << i << ": " << expected[i] << " vs. " << actual[i];
+    }
+  }
+}
+
+void ExpectSameBits(const std::vector<uint16_t>& expected,
+                    const std::vector<uint16_t>& actual,
+                    bool (*is_nan)(uint16_t)) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    if (is_nan(expected[i])) {
+      EXPECT_TRUE(is_nan(actual[i])) << "at " << i;
+    } else {
+      EXPECT_EQ(expected[i], actual[i]) << "at " << i;
+    }
+  }
+}
+
+TEST(ConvertKernelsTest, ScalarMatchesStaticCast) {
+  const ConvertKernels& kernels = GetConvertKernels(ConvertIsa::kScalar);
+  std::vector<float> floats = MakeFloats();
+  std::vector<uint16_t> half_bits = MakeHalfBits();
+
+  std::vector<uint16_t> expected_bits(kNumElements);
+  std::vector<uint16_t> bits(kNumElements);
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    expected_bits[i] = Eigen::numext::bit_cast<uint16_t>(
+        static_cast<tsl::bfloat16>(floats[i]));
+  }
+  kernels.float_to_bfloat16(floats.data(), bits.data(), kNumElements);
+  ExpectSameBits(expected_bits, bits, IsBFloat16NaN);
+
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    expected_bits[i] =
+        Eigen::numext::bit_cast<uint16_t>(static_cast<xla::half>(floats[i]));
+  }
+  kernels.float_to_half(floats.data(), bits.data(), kNumElements);
+  ExpectSameBits(expected_bits, bits, IsHalfNaN);
+
+  std::vector<float> expected_floats(kNumElements);
+  std::vector<float> converted(kNumElements);
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    expected_floats[i] = static_cast<float>(
+        Eigen::numext::bit_cast<tsl::bfloat16>(half_bits[i]));
+  }
+  kernels.bfloat16_to_float(half_bits.data(), converted.data(), kNumElements);
+  ExpectSameFloats(expected_floats, converted);
+
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    expected_floats[i] =
+        static_cast<float>(Eigen::numext::bit_cast<xla::half>(half_bits[i]));
+  }
+  kernels.half_to_float(half_bits.data(), converted.data(), kNumElements);
+  ExpectSameFloats(expected_floats, converted);
+}
+
+TEST(ConvertKernelsTest, VectorizedMatchesScalar) {
+  const ConvertKernels& scalar = GetConvertKernels(ConvertIsa::kScalar);
+  std::vector<float> floats = MakeFloats();
+  std::vector<uint16_t> half_bits = MakeHalfBits();
+  std::vector<double> doubles(kNumElements);
+  std::vector<int64_t> ints(kNumElements);
+  std::vector<uint8_t> bytes(kNumElements);
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    doubles[i] = static_cast<double>(floats[i]) * (1.0 + 1e-9 * i);
+    ints[i] = (int64_t{1} << 40) * (i % 7) - i * 1000003;
+    bytes[i] = static_cast<uint8_t>(i % 3 == 0 ? 0 : i);
+  }
+
+  for (ConvertIsa isa : {ConvertIsa::kAvx2, ConvertIsa::kAvx512}) {
+    if (!IsConvertIsaSupported(isa)) {
+      continue;
+    }
+    SCOPED_TRACE(ConvertIsaName(isa));
+    const ConvertKernels& kernels = GetConvertKernels(isa);
+    std::vector<uint16_t> expected_bits(kNumElements);
+    std::vector<uint16_t> bits(kNumElements);
+    scalar.float_to_bfloat16(floats.data(), expected_bits.data(), kNumElements);
+    kernels.float_to_bfloat16(floats.data(), bits.data(), kNumElements);
+    ExpectSameBits(expected_bits, bits, IsBFloat16NaN);
+
+    scalar.float_to_half(floats.data(), expected_bits.data(), kNumElements);
+    kernels.float_to_half(floats.data(), bits.data(), kNumElements);
+    ExpectSameBits(expected_bits, bits, IsHalfNaN);
+
+    std::vector<float> expected_floats(kNumElements);
+    std::vector<float> converted(kNumElements);
+    scalar.bfloat16_to_float(half_bits.data(), expected_floats.data(),
+                             kNumElements);
+    kernels.bfloat16_to_float(half_bits.data(), converted.data(),
+                              kNumElements);
+    ExpectSameFloats(expected_floats, converted);
+
+    scalar.half_to_float(half_bits.data(), expected_floats.data(),
+                         kNumElements);
+    kernels.half_to_float(half_bits.data(), converted.data(), kNumElements);
+    ExpectSameFloats(expected_floats, converted);
+
+    scalar.double_to_float(doubles.data(), expected_floats.data(),
+                           kNumElements);
+    kernels.double_to_float(doubles.data(), converted.data(), kNumElements);
+    ExpectSameFloats(expected_floats, converted);
+
+    std::vector<int32_t> expected_ints(kNumElements);
+    std::vector<int32_t> converted_ints(kNumElements);
+    scalar.int64_to_int32(ints.data(), expected_ints.data(), kNumElements);
+    kernels.int64_to_int32(ints.data(), converted_ints.data(), kNumElements);
+    EXPECT_EQ(expected_ints, converted_ints);
+
+    std::unique_ptr<bool[]> expected_bools(new bool[kNumElements]);
+    std::unique_ptr<bool[]> converted_bools(new bool[kNumElements]);
+    scalar.uint8_to_bool(bytes.data(), expected_bools.get(), kNumElements);
+    kernels.uint8_to_bool(bytes.data(), converted_bools.get(), kNumElements);
+    EXPECT_EQ(std::memcmp(expected_bools.get(), converted_bools.get(),
+                          kNumElements),
+              0);
+  }
+}
+
+TEST(ConvertKernelsTest, BestIsaIsSupported) {
+  EXPECT_TRUE(IsConvertIsaSupported(GetBestConvertIsa()));
+  EXPECT_TRUE(IsConvertIsaSupported(ConvertIsa::kScalar));
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace torch_xla
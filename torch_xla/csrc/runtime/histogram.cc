@@ -0,0 +1,132 @@
+#include "torch_xla/csrc/runtime/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "torch_xla/csrc/runtime/debug_macros.h"
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+
+Histogram::Histogram(double relative_accuracy, size_t max_buckets)
+    : relative_accuracy_(relative_accuracy), max_buckets_(max_buckets) {
+  XLA_CHECK(relative_accuracy > 0.0 && relative_accuracy < 1.0)
+      << relative_accuracy;
+  XLA_CHECK_GT(max_buckets, 0);
+  double gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+  log_gamma_ = std::log(gamma);
+}
+
+void Histogram::Add(double value, uint64_t count) {
+  if (count == 0) {
+    return;
+  }
+  count_ += count;
+  sum_ += value * count;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  if (value > 0.0) {
+    AddToBucket(BucketIndex(value), count);
+  } else {
+    zero_count_ += count;
+  }
+}
+
+void Histogram::Merge(const Histogram& other) {
+  XLA_CHECK_EQ(relative_accuracy_, other.relative_accuracy_);
+  if (other.count_ == 0) {
+    return;
+  }
+  count_ += other.count_;
+  zero_count_ += other.zero_count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  for (size_t i = 0; i < other.counts_.size(); ++i) {
+    if (other.counts_[i] > 0) {
+      AddToBucket(other.min_index_ + i, other.counts_[i]);
+    }
+  }
+}
+
+double Histogram::Quantile(double quantile) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  double rank = std::clamp(quantile, 0.0, 1.0) * (count_ - 1);
+  uint64_t seen = zero_count_;
+  if (rank < seen) {
+    return std::clamp(0.0, min_, max_);
+  }
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (rank < seen) {
+      return std::clamp(BucketValue(min_index_ + i), min_, max_);
+    }
+  }
+  return max_;
+}
+
+void Histogram::Clear() {
+  count_ = 0;
+  zero_count_ = 0;
+  sum_ = 0.0;
+  min_ = std::numeric_limits<double>::infinity();
+  max_ = -std::numeric_limits<double>::infinity();
+  min_index_ = 0;
+  counts_.clear();
+}
+
+void Histogram::ForEachBucket(
+    const std::function<void(double, uint64_t)>& fn) const {
+  if (zero_count_ > 0) {
+    fn(0.0, zero_count_);
+  }
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i] > 0) {
+      fn(BucketValue(min_index_ + i), counts_[i]);
+    }
+  }
+}
+
+int64_t Histogram::BucketIndex(double value) const {
+  return static_cast<int64_t>(std::ceil(std::log(value) / log_gamma_));
+}
+
+double Histogram::BucketValue(int64_t index) const {
+  // The bucket holds (gamma^(index-1), gamma^index], and this is the value
+  // within relative_accuracy of both ends.
+  return 2.0 * std::exp(index * log_gamma_) / (1.0 + std::exp(log_gamma_));
+}
+
+void Histogram::AddToBucket(int64_t index, uint64_t count) {
+  if (counts_.empty()) {
+    min_index_ = index;
+    counts_.push_back(count);
+    return;
+  }
+  int64_t max_index = min_index_ + counts_.size() - 1;
+  int64_t new_min_index = std::min(min_index_, index);
+  int64_t new_max_index = std::max(max_index, index);
+  int64_t max_buckets = static_cast<int64_t>(max_buckets_);
+  if (new_max_index - new_min_index + 1 > max_buckets) {
+    new_min_index = new_max_index - max_buckets + 1;
+  }
+  if (new_min_index != min_index_ || new_max_index != max_index) {
+    // Buckets below the new range collapse into its lowest one.
+    std::vector<uint64_t> counts(new_max_index - new_min_index + 1, 0);
+    for (size_t i = 0; i < counts_.size(); ++i) {
+      int64_t new_index = std::max<int64_t>(min_index_ + i, new_min_index);
+      counts[new_index - new_min_index] += counts_[i];
+    }
+    counts_ = std::move(counts);
+    min_index_ = new_min_index;
+  }
+  counts_[std::max(index, min_index_) - min_index_] += count;
+}
+
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
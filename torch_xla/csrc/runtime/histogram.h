@@ -0,0 +1,79 @@
+#ifndef XLA_CLIENT_HISTOGRAM_H_
+#define XLA_CLIENT_HISTOGRAM_H_
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+
+// Streaming histogram with bounded relative error on its quantiles, in the
+// fashion of DDSketch. Positive values land in logarithmically sized buckets,
+// so that every value within a bucket is within relative_accuracy of the
+// value the bucket reports. Values which are not positive are all counted as
+// zero. The memory is bounded by max_buckets: when the range of the values
+// needs more, the lowest buckets are collapsed together, which keeps the
+// accuracy of the upper quantiles.
+//
+// Histograms with the same relative accuracy can be merged, so they can be
+// recorded by different threads or processes and combined for reporting.
+// The class is not thread safe.
+class Histogram {
+ public:
+  explicit Histogram(double relative_accuracy = 0.01,
+                     size_t max_buckets = 2048);
+
+  void Add(double value) { Add(value, 1); }
+
+  void Add(double value, uint64_t count);
+
+  void Merge(const Histogram& other);
+
+  // Returns the estimated value at the given quantile, in [0, 1].
+  double Quantile(double quantile) const;
+
+  void Clear();
+
+  double relative_accuracy() const { return relative_accuracy_; }
+
+  uint64_t Count() const { return count_; }
+
+  double Sum() const { return sum_; }
+
+  double Min() const { return min_; }
+
+  double Max() const { return max_; }
+
+  // Calls fn(value, count) for every non empty bucket, from the lowest one,
+  // where value is the representative value of the bucket. Together with
+  // Add(value, count) it allows shipping histograms between processes.
+  void ForEachBucket(const std::function<void(double, uint64_t)>& fn) const;
+
+ private:
+  int64_t BucketIndex(double value) const;
+
+  double BucketValue(int64_t index) const;
+
+  void AddToBucket(int64_t index, uint64_t count);
+
+  double relative_accuracy_;
+  double log_gamma_;
+  size_t max_buckets_;
+  uint64_t count_ = 0;
+  uint64_t zero_count_ = 0;
+  double sum_ = 0.0;
+  double min_ = std::numeric_limits<double>::infinity();
+  double max_ = -std::numeric_limits<double>::infinity();
+  // counts_[i] holds the count of the bucket with index min_index_ + i.
+  int64_t min_index_ = 0;
+  std::vector<uint64_t> counts_;
+};
+
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
+
+#endif  // XLA_CLIENT_HISTOGRAM_H_
@@ -0,0 +1,132 @@
+#include "torch_xla/csrc/runtime/histogram.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+namespace {
+
+constexpr double kRelativeAccuracy = 0.01;
+
+double ExactQuantile(std::vector<double> values, double quantile) {
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(quantile * (values.size() - 1))];
+}
+
+void ExpectQuantilesWithinAccuracy(const Histogram& histogram,
+                                   const std::vector<double>& values) {
+  for (double quantile : {0.0, 0.01, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+    double expected = ExactQuantile(values, quantile);
+    EXPECT_NEAR(histogram.Quantile(quantile), expected,
+                expected * kRelativeAccuracy)
+        << "at quantile " << quantile;
+  }
+}
+
+std::vector<double> LogNormalValues(int count, unsigned seed) {
+  std::mt19937 gen(seed);
+  // Around a millisecond, in nanoseconds, with a long tail.
+  std::lognormal_distribution<double> dist(std::log(1e6), 1.5);
+  std::vector<double> values(count);
+  for (double& value : values) {
+    value = dist(gen);
+  }
+  return values;
+}
+
+TEST(HistogramTest, QuantilesHaveBoundedRelativeError) {
+  std::vector<double> values = LogNormalValues(100000, 1);
+  Histogram histogram(kRelativeAccuracy);
+  double sum = 0.0;
+  for (double value : values) {
+    histogram.Add(value);
+    sum += value;
+  }
+  EXPECT_EQ(histogram.Count(), values.size());
+  EXPECT_DOUBLE_EQ(histogram.Min(), *std::min_element(values.begin(),
+                                                      values.end()));
+  EXPECT_DOUBLE_EQ(histogram.Max(), *std::max_element(values.begin(),
+                                                      values.end()));
+  EXPECT_NEAR(histogram.Sum(), sum, sum * 1e-9);
+  ExpectQuantilesWithinAccuracy(histogram, values);
+}
+
+TEST(HistogramTest, MergeMatchesSingleHistogram) {
+  std::vector<double> values = LogNormalValues(30000, 2);
+  Histogram all(kRelativeAccuracy);
+  std::vector<Histogram> parts(3, Histogram(kRelativeAccuracy));
+  for (size_t i = 0; i < values.size(); ++i) {
+    all.Add(values[i]);
+    parts[i % parts.size()].Add(values[i]);
+  }
+  Histogram merged(kRelativeAccuracy);
+  for (const Histogram& part : parts) {
+    merged.Merge(part);
+  }
+  EXPECT_EQ(merged.Count(), all.Count());
+  for (double quantile : {0.1, 0.5, 0.99}) {
+    EXPECT_EQ(merged.Quantile(quantile), all.Quantile(quantile));
+  }
+
+  // Rebuilding from the buckets, as a remote process would do.
+  Histogram rebuilt(kRelativeAccuracy);
+  merged.ForEachBucket(
+      [&](double value, uint64_t count) { rebuilt.Add(value, count); });
+  EXPECT_EQ(rebuilt.Count(), merged.Count());
+  EXPECT_NEAR(rebuilt.Quantile(0.99), merged.Quantile(0.99),
+              merged.Quantile(0.99) * kRelativeAccuracy);
+}
+
+TEST(HistogramTest, NonPositiveValuesCountAsZero) {
+  Histogram histogram(kRelativeAccuracy);
+  for (int i = 0; i < 10; ++i) {
+    histogram.Add(0.0);
+  }
+  for (int i = 1; i <= 10; ++i) {
+    histogram.Add(i * 100.0);
+  }
+  EXPECT_EQ(histogram.Quantile(0.0), 0.0);
+  EXPECT_EQ(histogram.Quantile(0.4), 0.0);
+  EXPECT_NEAR(histogram.Quantile(1.0), 1000.0, 1000.0 * kRelativeAccuracy);
+}
+
+TEST(HistogramTest, CollapsingKeepsUpperQuantiles) {
+  // Values spanning many orders of magnitude, with few buckets.
+  Histogram histogram(kRelativeAccuracy, /*max_buckets=*/64);
+  std::vector<double> values;
+  for (int i = 0; i < 10000; ++i) {
+    values.push_back(std::pow(10.0, (i % 100) / 10.0));
+  }
+  for (double value : values) {
+    histogram.Add(value);
+  }
+  EXPECT_EQ(histogram.Count(), values.size());
+  for (double quantile : {0.99, 1.0}) {
+    double expected = ExactQuantile(values, quantile);
+    EXPECT_NEAR(histogram.Quantile(quantile), expected,
+                expected * kRelativeAccuracy);
+  }
+  // The collapsed lowest values are over estimated, never under.
+  EXPECT_GE(histogram.Quantile(0.0), 1.0);
+}
+
+TEST(HistogramTest, Clear) {
+  Histogram histogram(kRelativeAccuracy);
+  histogram.Add(5.0);
+  histogram.Clear();
+  EXPECT_EQ(histogram.Count(), 0);
+  EXPECT_EQ(histogram.Quantile(0.5), 0.0);
+  histogram.Add(7.0);
+  EXPECT_NEAR(histogram.Quantile(0.5), 7.0, 7.0 * kRelativeAccuracy);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
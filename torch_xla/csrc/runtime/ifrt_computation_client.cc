@@ -446,9 +446,7 @@ std::vector<ComputationClient::ComputationPtr> IfrtComputationClient::Compile(
   metrics::TimedSection timed(CompileMetric());
   tsl::profiler::TraceMe activity("IfrtComputationClient::Compile",
                                   tsl::profiler::TraceMeLevel::kInfo);
-  std::vector<ComputationClient::ComputationPtr> computations;
-
-  for (auto& instance : instances) {
+  auto compile_fn = [&](CompileInstance& instance) -> ComputationPtr {
     xla::CompileOptions compile_options;
     if (instance.is_sharded) {
       // TODO(yeounoh) multi-host, multi-slice configurations
@@ -496,12 +494,11 @@ std::vector<ComputationClient::ComputationPtr> IfrtComputationClient::Compile(
             std::move(xla::XlaComputation(hlo_modules[0]->ToProto())),
             instance.devices, std::move(executable));
 
-    computations.push_back(ifrt_computation);
-
     CreateCompileHandlesCounter()->AddValue(1);
-  }
+    return ifrt_computation;
+  };
 
-  return computations;
+  return CompileInstances(instances, compile_fn, &pool_);
 }
 
 std::vector<ComputationClient::DataPtr>
@@ -146,7 +146,7 @@ class IfrtComputationClient : public ComputationClient {
   }
 
   ComputationPtr DeserializeComputation(
-      const std::string& serialized) override {
+      absl::string_view serialized) override {
     XLA_ERROR() << __FUNCTION__ << " not implemented";
   }
 
@@ -1,6 +1,7 @@
 #include "torch_xla/csrc/runtime/metrics.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <sstream>
 
@@ -35,6 +36,12 @@ const std::vector<double>& GetPercentiles() {
   return *metrics_percentiles;
 }
 
+double GetHistogramAccuracy() {
+  static const double accuracy =
+      sys_util::GetEnvDouble("XLA_METRICS_HISTOGRAM_ACCURACY", 0.01);
+  return accuracy;
+}
+
 void EmitMetricInfo(const std::string& name, MetricData* data,
                     std::stringstream* ss) {
   double accumulator = 0.0;
@@ -74,6 +81,26 @@ void EmitMetricInfo(const std::string& name, MetricData* data,
           << "%=" << data->Repr(samples[index].value);
   }
   (*ss) << std::endl;
+
+  if (data->HasLifetimeHistogram()) {
+    Histogram histogram = data->LifetimeHistogram();
+    (*ss) << "  LifetimePercentiles: ";
+    for (size_t i = 0; i < metrics_percentiles.size(); ++i) {
+      if (i > 0) {
+        (*ss) << "; ";
+      }
+      (*ss) << (metrics_percentiles[i] * 100.0) << "%="
+            << data->Repr(histogram.Quantile(metrics_percentiles[i]));
+    }
+    (*ss) << "; max=" << data->Repr(histogram.Max()) << std::endl;
+  }
+}
+
+// Returns the shard the calling thread records its samples into.
+size_t ThreadShard(size_t num_shards) {
+  static std::atomic<size_t> next_shard(0);
+  thread_local size_t shard = next_shard.fetch_add(1);
+  return shard % num_shards;
 }
 
 void EmitCounterInfo(const std::string& name, CounterData* data,
@@ -82,6 +109,113 @@ void EmitCounterInfo(const std::string& name, CounterData* data,
   (*ss) << "  Value: " << data->Value() << std::endl;
 }
 
+// Turns a metric name like "TransferToDeviceTime" or "aten::add" into a valid
+// OpenMetrics name like "xla_transfer_to_device_time" or "xla_aten_add".
+std::string OpenMetricsName(const std::string& name) {
+  std::string result = "xla_";
+  for (size_t i = 0; i < name.size(); ++i) {
+    unsigned char c = name[i];
+    unsigned char prev = i > 0 ? name[i - 1] : '_';
+    if (std::isupper(c)) {
+      if (std::islower(prev) || std::isdigit(prev)) {
+        result += '_';
+      }
+      result += std::tolower(c);
+    } else if (std::isalnum(c)) {
+      result += c;
+    } else if (result.back() != '_') {
+      result += '_';
+    }
+  }
+  return result;
+}
+
+std::string OpenMetricsValue(double value) {
+  std::stringstream ss;
+  ss.precision(12);
+  ss << value;
+  return ss.str();
+}
+
+void EmitOpenMetricsSummaryImpl(const std::string& name, OpenMetricsUnit unit,
+                                std::vector<Sample> samples,
+                                double accumulator, size_t total_samples,
+                                const Histogram* histogram,
+                                std::stringstream* ss) {
+  if (total_samples == 0) {
+    return;
+  }
+  std::string om_name = OpenMetricsName(name);
+  std::string unit_name;
+  double scale = 1.0;
+  if (unit == OpenMetricsUnit::kSeconds) {
+    unit_name = "seconds";
+    scale = 1e-9;
+  } else if (unit == OpenMetricsUnit::kBytes) {
+    unit_name = "bytes";
+  }
+  if (!unit_name.empty()) {
+    om_name += "_" + unit_name;
+  }
+  (*ss) << "# TYPE " << om_name << " summary\n";
+  if (!unit_name.empty()) {
+    (*ss) << "# UNIT " << om_name << " " << unit_name << "\n";
+  }
+  const std::vector<double>& metrics_percentiles = GetPercentiles();
+  if (histogram != nullptr) {
+    for (double percentile : metrics_percentiles) {
+      (*ss) << om_name << "{quantile=\"" << percentile << "\"} "
+            << OpenMetricsValue(histogram->Quantile(percentile) * scale)
+            << "\n";
+    }
+  } else if (!samples.empty()) {
+    std::sort(
+        samples.begin(), samples.end(),
+        [](const Sample& s1, const Sample& s2) { return s1.value < s2.value; });
+    for (double percentile : metrics_percentiles) {
+      size_t index = percentile * samples.size();
+      (*ss) << om_name << "{quantile=\"" << percentile << "\"} "
+            << OpenMetricsValue(samples[index].value * scale) << "\n";
+    }
+  }
+  (*ss) << om_name << "_sum " << OpenMetricsValue(accumulator * scale)
+        << "\n";
+  (*ss) << om_name << "_count " << total_samples << "\n";
+}
+
+void EmitOpenMetricsMetric(const std::string& name, const MetricData* data,
+                           std::stringstream* ss) {
+  using ReprFnPtr = std::string (*)(double);
+  const ReprFnPtr* repr_fn = data->ReprFn().target<ReprFnPtr>();
+  OpenMetricsUnit unit = OpenMetricsUnit::kNone;
+  if (repr_fn != nullptr && *repr_fn == MetricFnTime) {
+    unit = OpenMetricsUnit::kSeconds;
+  } else if (repr_fn != nullptr && *repr_fn == MetricFnBytes) {
+    unit = OpenMetricsUnit::kBytes;
+  }
+  double accumulator = 0.0;
+  size_t total_samples = 0;
+  std::vector<Sample> samples = data->Samples(&accumulator, &total_samples);
+  if (data->HasLifetimeHistogram()) {
+    Histogram histogram = data->LifetimeHistogram();
+    EmitOpenMetricsSummaryImpl(name, unit, std::move(samples), accumulator,
+                               total_samples, &histogram, ss);
+  } else {
+    EmitOpenMetricsSummaryImpl(name, unit, std::move(samples), accumulator,
+                               total_samples, nullptr, ss);
+  }
+}
+
+std::mutex* GetOpenMetricsCollectorLock() {
+  static std::mutex* lock = new std::mutex();
+  return lock;
+}
+
+OpenMetricsCollector* GetOpenMetricsCollector() {
+  static OpenMetricsCollector* collector = new OpenMetricsCollector();
+  return collector;
+}
+
 }  // namespace
 
 MetricsArena* MetricsArena::Get() {
@@ -90,12 +224,13 @@ MetricsArena* MetricsArena::Get() {
 }
 
 void MetricsArena::RegisterMetric(const std::string& name, MetricReprFn repr_fn,
-                                  size_t max_samples,
+                                  size_t max_samples, bool lifetime_histogram,
                                   std::shared_ptr<MetricData>* data) {
   std::lock_guard<std::mutex> lock(lock_);
   if (*data == nullptr) {
     *data = torch_xla::runtime::util::MapInsert(&metrics_, name, [&]() {
-      return std::make_shared<MetricData>(std::move(repr_fn), max_samples);
+      return std::make_shared<MetricData>(std::move(repr_fn), max_samples,
+                                          lifetime_histogram);
     });
   }
 }
@@ -117,6 +252,14 @@ void MetricsArena::ForEachMetric(
   }
 }
 
+void MetricsArena::Snapshot(
+    std::map<std::string, std::shared_ptr<MetricData>>* metrics,
+    std::map<std::string, std::shared_ptr<CounterData>>* counters) {
+  std::lock_guard<std::mutex> lock(lock_);
+  *metrics = metrics_;
+  *counters = counters_;
+}
+
 void MetricsArena::ForEachCounter(
     const std::function<void(const std::string&, CounterData*)>& counter_func) {
   std::lock_guard<std::mutex> lock(lock_);
@@ -174,61 +317,109 @@ void MetricsArena::ClearMetrics() {
   }
 }
 
-MetricData::MetricData(MetricReprFn repr_fn, size_t max_samples)
-    : repr_fn_(std::move(repr_fn)), samples_(max_samples) {}
+MetricData::MetricData(MetricReprFn repr_fn, size_t max_samples,
+                       bool lifetime_histogram)
+    : repr_fn_(std::move(repr_fn)),
+      max_samples_(max_samples),
+      lifetime_histogram_(lifetime_histogram) {}
 
 void MetricData::AddSample(int64_t timestamp_ns, double value) {
-  std::lock_guard<std::mutex> lock(lock_);
-  size_t position = count_ % samples_.size();
-  ++count_;
-  accumulator_ += value;
-  samples_[position] = Sample(timestamp_ns, value);
+  {
+    Shard& shard = shards_[ThreadShard(kNumShards)];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    ++shard.count;
+    shard.accumulator += value;
+  }
+  std::lock_guard<std::mutex> lock(samples_lock_);
+  if (samples_.empty()) {
+    samples_.resize(max_samples_);
+    if (lifetime_histogram_) {
+      histogram_ = std::make_unique<Histogram>(GetHistogramAccuracy());
+    }
+  }
+  samples_[samples_count_ % samples_.size()] = Sample(timestamp_ns, value);
+  ++samples_count_;
+  if (histogram_ != nullptr) {
+    histogram_->Add(value);
+  }
 }
 
 double MetricData::Accumulator() const {
-  std::lock_guard<std::mutex> lock(lock_);
-  return accumulator_;
+  double accumulator = 0.0;
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    accumulator += shard.accumulator;
+  }
+  return accumulator;
 }
 
 size_t MetricData::TotalSamples() const {
-  std::lock_guard<std::mutex> lock(lock_);
-  return count_;
+  size_t count = 0;
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    count += shard.count;
+  }
+  return count;
+}
+
+Histogram MetricData::LifetimeHistogram() const {
+  std::lock_guard<std::mutex> lock(samples_lock_);
+  if (histogram_ == nullptr) {
+    return Histogram(GetHistogramAccuracy());
+  }
+  return *histogram_;
 }
 
 void MetricData::Clear() {
-  std::lock_guard<std::mutex> lock(lock_);
-  count_ = 0;
-  accumulator_ = 0.0;
-  samples_ = std::vector<Sample>(samples_.size());
+  for (Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    shard.count = 0;
+    shard.accumulator = 0.0;
+  }
+  std::lock_guard<std::mutex> lock(samples_lock_);
+  samples_ = std::vector<Sample>();
+  samples_count_ = 0;
+  histogram_.reset();
 }
 
 std::vector<Sample> MetricData::Samples(double* accumulator,
                                         size_t* total_samples) const {
-  std::lock_guard<std::mutex> lock(lock_);
+  double shards_accumulator = 0.0;
+  size_t count = 0;
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.lock);
+    shards_accumulator += shard.accumulator;
+    count += shard.count;
+  }
   std::vector<Sample> samples;
-  if (count_ <= samples_.size()) {
-    samples.insert(samples.end(), samples_.begin(), samples_.begin() + count_);
-  } else {
-    size_t position = count_ % samples_.size();
-    samples.insert(samples.end(), samples_.begin() + position, samples_.end());
-    samples.insert(samples.end(), samples_.begin(),
-                   samples_.begin() + position);
+  {
+    std::lock_guard<std::mutex> lock(samples_lock_);
+    if (samples_count_ <= samples_.size()) {
+      samples.assign(samples_.begin(), samples_.begin() + samples_count_);
+    } else {
+      size_t position = samples_count_ % samples_.size();
+      samples.assign(samples_.begin() + position, samples_.end());
+      samples.insert(samples.end(), samples_.begin(),
+                     samples_.begin() + position);
+    }
   }
   if (accumulator != nullptr) {
-    *accumulator = accumulator_;
+    *accumulator = shards_accumulator;
   }
   if (total_samples != nullptr) {
-    *total_samples = count_;
+    *total_samples = count;
   }
   return samples;
 }
 
-Metric::Metric(std::string name, MetricReprFn repr_fn, size_t max_samples)
+Metric::Metric(std::string name, MetricReprFn repr_fn, size_t max_samples,
+               bool lifetime_histogram)
     : name_(std::move(name)),
       repr_fn_(std::move(repr_fn)),
       max_samples_(max_samples != 0
                        ? max_samples
                        : sys_util::GetEnvInt("XLA_METRICS_SAMPLES", 1024)),
+      lifetime_histogram_(lifetime_histogram),
       data_(nullptr) {}
 
 double Metric::Accumulator() const { return GetData()->Accumulator(); }
@@ -254,7 +445,8 @@ MetricData* Metric::GetData() const {
     // The RegisterMetric() API is a synchronization point, and even if multiple
     // threads enters it, the data will be created only once.
     MetricsArena* arena = MetricsArena::Get();
-    arena->RegisterMetric(name_, repr_fn_, max_samples_, &data_ptr_);
+    arena->RegisterMetric(name_, repr_fn_, max_samples_, lifetime_histogram_,
+                          &data_ptr_);
     // Even if multiple threads will enter this IF statement, they will all
     // fetch the same value, and hence store the same value below.
     data = data_ptr_.get();
@@ -373,6 +565,48 @@ std::string CreateMetricReport(const std::vector<std::string>& counter_names,
   return ss.str();
 }
 
+void EmitOpenMetricsSummary(const std::string& name, OpenMetricsUnit unit,
+                            std::vector<Sample> samples, double accumulator,
+                            size_t total_samples, std::stringstream* ss) {
+  EmitOpenMetricsSummaryImpl(name, unit, std::move(samples), accumulator,
+                             total_samples, nullptr, ss);
+}
+
+void EmitOpenMetricsCounter(const std::string& name, int64_t value,
+                            std::stringstream* ss) {
+  std::string om_name = OpenMetricsName(name);
+  (*ss) << "# TYPE " << om_name << " counter\n";
+  (*ss) << om_name << "_total " << value << "\n";
+}
+
+void SetOpenMetricsCollector(OpenMetricsCollector collector) {
+  std::lock_guard<std::mutex> lock(*GetOpenMetricsCollectorLock());
+  *GetOpenMetricsCollector() = std::move(collector);
+}
+
+std::string CreateOpenMetricsReport() {
+  std::map<std::string, std::shared_ptr<MetricData>> metrics;
+  std::map<std::string, std::shared_ptr<CounterData>> counters;
+  MetricsArena::Get()->Snapshot(&metrics, &counters);
+  std::stringstream ss;
+  for (auto& name_data : metrics) {
+    EmitOpenMetricsMetric(name_data.first, name_data.second.get(), &ss);
+  }
+  for (auto& name_data : counters) {
+    EmitOpenMetricsCounter(name_data.first, name_data.second->Value(), &ss);
+  }
+  OpenMetricsCollector collector;
+  {
+    std::lock_guard<std::mutex> lock(*GetOpenMetricsCollectorLock());
+    collector = *GetOpenMetricsCollector();
+  }
+  if (collector) {
+    collector(&ss);
+  }
+  ss << "# EOF\n";
+  return ss.str();
+}
+
 std::vector<std::string> GetMetricNames() {
   return MetricsArena::Get()->GetMetricNames();
 }
@@ -1,14 +1,18 @@
 #ifndef XLA_CLIENT_METRICS_H_
 #define XLA_CLIENT_METRICS_H_
 
+#include <array>
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "absl/strings/str_cat.h"
+#include "torch_xla/csrc/runtime/histogram.h"
 #include "torch_xla/csrc/runtime/sys_util.h"
 #include "xla/types.h"
 
@@ -29,12 +33,20 @@ using MetricReprFn = std::function<std::string(double)>;
 
 // Class used to collect time-stamped numeric samples. The samples are stored in
 // a circular buffer whose size can be configured at constructor time.
+// Every thread records into one of a few shards, each with its own lock and
+// buffer, so that threads posting to the same metric do not contend with each
+// other. The shards are merged, by sample time, when the samples are read.
+// Since the circular buffer only covers the latest samples, a metric can also
+// track all its samples into a bounded memory Histogram, whose percentiles
+// cover the whole lifetime of the metric.
 class MetricData {
  public:
   // Creates a new MetricData object with the internal circular buffer storing
   // max_samples samples. The repr_fn argument allow to specify a function which
-  // pretty-prints a sample value.
-  MetricData(MetricReprFn repr_fn, size_t max_samples);
+  // pretty-prints a sample value. If lifetime_histogram is true, all the
+  // samples are also recorded into a Histogram.
+  MetricData(MetricReprFn repr_fn, size_t max_samples,
+             bool lifetime_histogram = false);
 
   // Returns the total values of all the samples being posted to this metric.
   double Accumulator() const;
@@ -44,21 +56,48 @@ class MetricData {
   void AddSample(int64_t timestamp_ns, double value);
 
   // Returns a vector with all the current samples, from the oldest to the
-  // newer. If accumulator is not nullptr, it will receive the current value of
-  // the metrics' accumulator (the sum of all posted values). If total_samples
-  // is not nullptr, it will receive the count of the posted values.
+  // newer. Those are the last max_samples samples posted, whatever the thread
+  // which posted them. If accumulator is not nullptr, it will receive the
+  // current value of the metrics' accumulator (the sum of all posted values).
+  // If total_samples is not nullptr, it will receive the count of the posted
+  // values.
   std::vector<Sample> Samples(double* accumulator, size_t* total_samples) const;
 
+  bool HasLifetimeHistogram() const { return lifetime_histogram_; }
+
+  // Returns the histogram of all the samples posted since the metric was
+  // created or cleared. Empty if the metric has no lifetime histogram.
+  Histogram LifetimeHistogram() const;
+
   std::string Repr(double value) const { return repr_fn_(value); }
 
+  const MetricReprFn& ReprFn() const { return repr_fn_; }
+
   void Clear();
 
  private:
-  mutable std::mutex lock_;
+  static constexpr size_t kNumShards = 16;
+
+  // The count and the accumulator of the samples posted by some of the
+  // threads. Aligned to keep the shards written by different threads in
+  // different cache lines.
+  struct alignas(64) Shard {
+    mutable std::mutex lock;
+    size_t count = 0;
+    double accumulator = 0.0;
+  };
+
   MetricReprFn repr_fn_;
-  size_t count_ = 0;
+  size_t max_samples_;
+  bool lifetime_histogram_;
+  std::array<Shard, kNumShards> shards_;
+  // Guards the ring of the latest samples and the histogram, which all the
+  // threads share, so that the metric keeps a single bounded window.
+  mutable std::mutex samples_lock_;
+  // Allocated with the first sample.
   std::vector<Sample> samples_;
-  double accumulator_ = 0.0;
+  size_t samples_count_ = 0;
+  std::unique_ptr<Histogram> histogram_;
 };
 
 // Counters are a very lightweight form of metrics which do not need to track
@@ -83,7 +122,8 @@ class MetricsArena {
 
   // Registers a new metric in the global arena.
   void RegisterMetric(const std::string& name, MetricReprFn repr_fn,
-                      size_t max_samples, std::shared_ptr<MetricData>* data);
+                      size_t max_samples, bool lifetime_histogram,
+                      std::shared_ptr<MetricData>* data);
 
   void RegisterCounter(const std::string& name,
                        std::shared_ptr<CounterData>* data);
@@ -94,6 +134,12 @@ class MetricsArena {
   void ForEachCounter(const std::function<void(const std::string&,
                                                CounterData*)>& counter_func);
 
+  // Copies the registered metrics and counters. The arena lock is only held
+  // while copying the maps, so that the callers can read and format the data
+  // without blocking the threads registering new metrics.
+  void Snapshot(std::map<std::string, std::shared_ptr<MetricData>>* metrics,
+                std::map<std::string, std::shared_ptr<CounterData>>* counters);
+
   std::vector<std::string> GetMetricNames();
 
   MetricData* GetMetric(const std::string& name);
@@ -129,10 +175,12 @@ std::string MetricFnTime(double value);
 //     ...
 //     metric->AddSample(ts_nanos, some_value);
 //   }
+// Metrics whose tail matters over long runs, like the execution and transfer
+// times, should pass lifetime_histogram=true.
 class Metric {
  public:
   explicit Metric(std::string name, MetricReprFn repr_fn = MetricFnValue,
-                  size_t max_samples = 0);
+                  size_t max_samples = 0, bool lifetime_histogram = false);
 
   const std::string& Name() const { return name_; }
 
@@ -152,6 +200,7 @@ class Metric {
   std::string name_;
   MetricReprFn repr_fn_;
   size_t max_samples_;
+  bool lifetime_histogram_;
   mutable std::shared_ptr<MetricData> data_ptr_;
   mutable std::atomic<MetricData*> data_;
 };
@@ -205,6 +254,33 @@ std::string CreateMetricReport();
 std::string CreateMetricReport(const std::vector<std::string>& counter_names,
                                const std::vector<std::string>& metric_names);
 
+// Creates a report with the current metrics statistics, in the OpenMetrics
+// text format. Metrics are reported as summaries and counters as counters,
+// with their names converted to snake case and prefixed with "xla_". Time
+// metrics are reported in seconds. The metrics added by the collector set with
+// SetOpenMetricsCollector() are appended to the ones of the MetricsArena.
+std::string CreateOpenMetricsReport();
+
+// Unit of the samples of a metric, in the OpenMetrics reports.
+enum class OpenMetricsUnit { kNone, kSeconds, kBytes };
+
+// Appends a summary of the samples of a metric to an OpenMetrics report. Time
+// samples are taken in nanoseconds, and reported in seconds.
+void EmitOpenMetricsSummary(const std::string& name, OpenMetricsUnit unit,
+                            std::vector<Sample> samples, double accumulator,
+                            size_t total_samples, std::stringstream* ss);
+
+// Appends a counter to an OpenMetrics report.
+void EmitOpenMetricsCounter(const std::string& name, int64_t value,
+                            std::stringstream* ss);
+
+using OpenMetricsCollector = std::function<void(std::stringstream*)>;
+
+// Sets the function which appends to the OpenMetrics reports the metrics kept
+// outside of the MetricsArena, like the torch::lazy ones which the runtime
+// cannot depend on.
+void SetOpenMetricsCollector(OpenMetricsCollector collector);
+
 // Returns the currently registered metric names. Note that the list can grow
 // since metrics are usualy function intialized (they are static function
 // variables).
@@ -0,0 +1,120 @@
+#include "torch_xla/csrc/runtime/metrics_exporter.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include "absl/strings/str_cat.h"
+#include "torch_xla/csrc/runtime/metrics.h"
+#include "torch_xla/csrc/runtime/sys_util.h"
+#include "torch_xla/csrc/runtime/tf_logging.h"
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+
+namespace {
+
+std::mutex* GetExporterLock() {
+  static std::mutex* lock = new std::mutex();
+  return lock;
+}
+
+// Not destroyed at exit: the exporting thread must be stopped by Shutdown()
+// while the runtime is still around.
+std::unique_ptr<MetricsExporter>* GetExporter() {
+  static std::unique_ptr<MetricsExporter>* exporter =
+      new std::unique_ptr<MetricsExporter>();
+  return exporter;
+}
+
+}  // namespace
+
+void MetricsExporter::MaybeStart() {
+  static bool started = false;
+  std::lock_guard<std::mutex> lock(*GetExporterLock());
+  if (started) {
+    return;
+  }
+  started = true;
+  std::string path = sys_util::GetEnvString("XLA_METRICS_EXPORT_FILE", "");
+  if (path.empty()) {
+    return;
+  }
+  int64_t interval_ms =
+      sys_util::GetEnvInt("XLA_METRICS_EXPORT_INTERVAL_MS", 10000);
+  *GetExporter() = std::make_unique<MetricsExporter>(
+      ProcessPath(path), std::chrono::milliseconds(interval_ms));
+}
+
+void MetricsExporter::Shutdown() {
+  std::unique_ptr<MetricsExporter> exporter;
+  {
+    std::lock_guard<std::mutex> lock(*GetExporterLock());
+    exporter = std::move(*GetExporter());
+  }
+  // Joins the exporting thread and writes the last snapshot, out of the lock.
+  exporter.reset();
+}
+
+std::string MetricsExporter::ProcessPath(const std::string& path) {
+  size_t name_pos = path.rfind('/');
+  name_pos = name_pos == std::string::npos ? 0 : name_pos + 1;
+  size_t ext_pos = path.rfind('.');
+  if (ext_pos == std::string::npos || ext_pos <= name_pos) {
+    ext_pos = path.size();
+  }
+  return absl::StrCat(path.substr(0, ext_pos), ".", getpid(),
+                      path.substr(ext_pos));
+}
+
+MetricsExporter::MetricsExporter(std::string path,
+                                 std::chrono::milliseconds interval)
+    : path_(std::move(path)), interval_(interval) {
+  thread_ = std::thread([this]() { Run(); });
+}
+
+MetricsExporter::~MetricsExporter() {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    stopped_ = true;
+  }
+  cv_.notify_one();
+  thread_.join();
+  WriteSnapshot();
+}
+
+bool MetricsExporter::WriteSnapshot() {
+  // Formatting only holds the arena lock while copying the metric pointers.
+  std::string report = CreateOpenMetricsReport();
+  std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::trunc);
+    file << report;
+    file.close();
+    if (!file) {
+      TF_LOG(WARNING) << "Failed to write the metrics to " << tmp_path;
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    TF_LOG(WARNING) << "Failed to rename " << tmp_path << " to " << path_;
+    return false;
+  }
+  return true;
+}
+
+void MetricsExporter::Run() {
+  std::unique_lock<std::mutex> lock(lock_);
+  while (!cv_.wait_for(lock, interval_, [this]() { return stopped_; })) {
+    lock.unlock();
+    WriteSnapshot();
+    lock.lock();
+  }
+}
+
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
@@ -0,0 +1,58 @@
+#ifndef XLA_CLIENT_METRICS_EXPORTER_H_
+#define XLA_CLIENT_METRICS_EXPORTER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+
+// Periodically writes CreateOpenMetricsReport() to a file, which monitoring
+// agents (like the textfile collector of the Prometheus node exporter) can
+// pick up. Every snapshot is written to a temporary file which is then renamed
+// over the target, so readers never see a partial report.
+class MetricsExporter {
+ public:
+  // Starts the global exporter if XLA_METRICS_EXPORT_FILE is set, writing a
+  // snapshot every XLA_METRICS_EXPORT_INTERVAL_MS milliseconds. The process ID
+  // is added to the file name, ahead of its extension, so that the processes
+  // of a multi-process run do not overwrite each other. Only the first call
+  // has an effect.
+  static void MaybeStart();
+
+  // Stops the global exporter, if any, after writing a last snapshot. To be
+  // called at exit.
+  static void Shutdown();
+
+  // Returns path with the process ID inserted ahead of the file extension,
+  // like "/tmp/xla.1234.prom" for "/tmp/xla.prom".
+  static std::string ProcessPath(const std::string& path);
+
+  MetricsExporter(std::string path, std::chrono::milliseconds interval);
+
+  // Stops the exporting thread, after writing a last snapshot.
+  ~MetricsExporter();
+
+  // Writes a snapshot of the current metrics. Returns false on I/O errors.
+  bool WriteSnapshot();
+
+ private:
+  void Run();
+
+  const std::string path_;
+  const std::chrono::milliseconds interval_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+  std::thread thread_;
+};
+
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
+
+#endif  // XLA_CLIENT_METRICS_EXPORTER_H_
@@ -0,0 +1,61 @@
+#include "torch_xla/csrc/runtime/metrics_exporter.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "torch_xla/csrc/runtime/metrics.h"
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+namespace {
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path);
+  std::stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+TEST(MetricsExporterTest, WritesSnapshots) {
+  std::string path = ::testing::TempDir() + "/metrics_exporter_test.prom";
+  std::remove(path.c_str());
+  Counter counter("ExporterTestCounter");
+  counter.AddValue(1);
+  {
+    MetricsExporter exporter(path, std::chrono::milliseconds(1));
+    ASSERT_TRUE(exporter.WriteSnapshot());
+    EXPECT_NE(ReadFile(path).find("xla_exporter_test_counter_total 1\n"),
+              std::string::npos);
+    counter.AddValue(1);
+  }
+  // The exporter writes a last snapshot when it is destroyed.
+  std::string report = ReadFile(path);
+  EXPECT_NE(report.find("xla_exporter_test_counter_total 2\n"),
+            std::string::npos);
+  EXPECT_EQ(report.substr(report.size() - 6), "# EOF\n");
+}
+
+TEST(MetricsExporterTest, FailsOnMissingDirectory) {
+  MetricsExporter exporter(::testing::TempDir() + "/missing/dir/metrics.prom",
+                           std::chrono::hours(1));
+  EXPECT_FALSE(exporter.WriteSnapshot());
+}
+
+TEST(MetricsExporterTest, ProcessPath) {
+  std::string pid = std::to_string(getpid());
+  EXPECT_EQ(MetricsExporter::ProcessPath("/tmp/xla.prom"),
+            "/tmp/xla." + pid + ".prom");
+  EXPECT_EQ(MetricsExporter::ProcessPath("/tmp/xla"), "/tmp/xla." + pid);
+  EXPECT_EQ(MetricsExporter::ProcessPath("/tmp.d/xla"), "/tmp.d/xla." + pid);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
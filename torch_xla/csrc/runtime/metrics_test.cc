@@ -0,0 +1,139 @@
+#include "torch_xla/csrc/runtime/metrics.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace torch_xla {
+namespace runtime {
+namespace metrics {
+namespace {
+
+TEST(MetricDataTest, KeepsTheLatestSamplesInOrder) {
+  MetricData data(MetricFnValue, /*max_samples=*/4);
+  for (int64_t i = 0; i < 10; ++i) {
+    data.AddSample(/*timestamp_ns=*/i, /*value=*/i);
+  }
+  double accumulator = 0.0;
+  size_t total_samples = 0;
+  std::vector<Sample> samples = data.Samples(&accumulator, &total_samples);
+  EXPECT_EQ(total_samples, 10);
+  EXPECT_EQ(accumulator, 45.0);
+  ASSERT_EQ(samples.size(), 4);
+  for (int64_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(samples[i].timestamp_ns, 6 + i);
+  }
+}
+
+TEST(MetricDataTest, MergesTheSamplesOfAllThreads) {
+  constexpr int kNumThreads = 8;
+  constexpr int kSamplesPerThread = 1000;
+  MetricData data(MetricFnValue, /*max_samples=*/64);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kSamplesPerThread; ++i) {
+        data.AddSample(/*timestamp_ns=*/i * kNumThreads + t, /*value=*/1.0);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(data.TotalSamples(), kNumThreads * kSamplesPerThread);
+  EXPECT_EQ(data.Accumulator(), kNumThreads * kSamplesPerThread);
+
+  // The window is the latest samples posted, so the samples of each thread in
+  // it are its last ones, without gaps.
+  std::vector<Sample> samples = data.Samples(nullptr, nullptr);
+  ASSERT_EQ(samples.size(), 64);
+  std::vector<std::vector<int64_t>> thread_samples(kNumThreads);
+  for (const Sample& sample : samples) {
+    thread_samples[sample.timestamp_ns % kNumThreads].push_back(
+        sample.timestamp_ns / kNumThreads);
+  }
+  for (const std::vector<int64_t>& indices : thread_samples) {
+    for (size_t i = 0; i < indices.size(); ++i) {
+      EXPECT_EQ(indices[i], kSamplesPerThread - indices.size() + i);
+    }
+  }
+
+  data.Clear();
+  EXPECT_EQ(data.TotalSamples(), 0);
+  EXPECT_TRUE(data.Samples(nullptr, nullptr).empty());
+}
+
+TEST(MetricDataTest, LifetimeHistogramCoversAllTheSamples) {
+  MetricData data(MetricFnValue, /*max_samples=*/4,
+                  /*lifetime_histogram=*/true);
+  ASSERT_TRUE(data.HasLifetimeHistogram());
+  for (int64_t i = 1; i <= 1000; ++i) {
+    data.AddSample(/*timestamp_ns=*/i, /*value=*/i);
+  }
+  // The circular buffer only has the latest samples, the histogram all.
+  EXPECT_EQ(data.Samples(nullptr, nullptr).front().value, 997.0);
+  Histogram histogram = data.LifetimeHistogram();
+  EXPECT_EQ(histogram.Count(), 1000);
+  EXPECT_EQ(histogram.Min(), 1.0);
+  EXPECT_NEAR(histogram.Quantile(0.5), 500.0, 500.0 * 0.01);
+  EXPECT_NEAR(histogram.Quantile(0.99), 990.0, 990.0 * 0.01);
+
+  data.Clear();
+  EXPECT_EQ(data.LifetimeHistogram().Count(), 0);
+}
+
+TEST(MetricsTest, CreateOpenMetricsReport) {
+  Metric time_metric("OpenMetricsTestTime", MetricFnTime, /*max_samples=*/0,
+                     /*lifetime_histogram=*/true);
+  time_metric.AddSample(2e9);
+  Metric bytes_metric("OpenMetricsTestData", MetricFnBytes);
+  bytes_metric.AddSample(1024.0);
+  Counter counter("aten::OpenMetricsTest");
+  counter.AddValue(3);
+
+  std::string report = CreateOpenMetricsReport();
+  EXPECT_NE(report.find("# TYPE xla_open_metrics_test_time_seconds summary\n"
+                        "# UNIT xla_open_metrics_test_time_seconds seconds\n"
+                        "xla_open_metrics_test_time_seconds"
+                        "{quantile=\"0.01\"}"),
+            std::string::npos);
+  EXPECT_NE(report.find("xla_open_metrics_test_time_seconds_sum 2\n"
+                        "xla_open_metrics_test_time_seconds_count 1\n"),
+            std::string::npos);
+  EXPECT_NE(report.find("xla_open_metrics_test_data_bytes_sum 1024\n"),
+            std::string::npos);
+  EXPECT_NE(report.find("# TYPE xla_aten_open_metrics_test counter\n"
+                        "xla_aten_open_metrics_test_total 3\n"),
+            std::string::npos);
+  EXPECT_EQ(report.substr(report.size() - 6), "# EOF\n");
+}
+
+TEST(MetricsTest, OpenMetricsCollector) {
+  SetOpenMetricsCollector([](std::stringstream* ss) {
+    EmitOpenMetricsSummary("CollectedTime", OpenMetricsUnit::kSeconds,
+                           {Sample(0, 1e9), Sample(1, 3e9)}, 4e9, 2, ss);
+    EmitOpenMetricsCounter("CollectedCounter", 5, ss);
+  });
+  std::string report = CreateOpenMetricsReport();
+  SetOpenMetricsCollector(nullptr);
+
+  EXPECT_NE(report.find("xla_collected_time_seconds{quantile=\"0.99\"} 3\n"
+                        "xla_collected_time_seconds_sum 4\n"
+                        "xla_collected_time_seconds_count 2\n"),
+            std::string::npos);
+  EXPECT_NE(report.find("# TYPE xla_collected_counter counter\n"
+                        "xla_collected_counter_total 5\n"),
+            std::string::npos);
+  EXPECT_EQ(report.substr(report.size() - 6), "# EOF\n");
+  EXPECT_EQ(CreateOpenMetricsReport().find("xla_collected_counter"),
+            std::string::npos);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace runtime
+}  // namespace torch_xla
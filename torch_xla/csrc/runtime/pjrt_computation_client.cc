@@ -1,11 +1,16 @@
 #include "torch_xla/csrc/runtime/pjrt_computation_client.h"
 
 #include <algorithm>
+#include <atomic>
 #include <future>
+#include <optional>
+#include <set>
+#include <stdexcept>
 #include <unordered_set>
 #include <vector>
 
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/types/span.h"
 #include "torch_xla/csrc/runtime/computation_client.h"
@@ -140,6 +145,8 @@ PjRtComputationClient::PjRtComputationClient() {
 }
 
 PjRtComputationClient::~PjRtComputationClient() {
+  // The cached executables must not outlive the PjRtClient.
+  utility_computations_.Clear();
   // In the GPU case, the PjRtClient depends on the DistributedRuntimeClient
   // tracked in XlaCoordinator, so the PjRtClient must be destroyed first.
   client_ = nullptr;
@@ -171,6 +178,7 @@ void PjRtComputationClient::PjRtData::Assign(
   const PjRtData& pjrt_data = dynamic_cast<const PjRtData&>(data);
   if (&pjrt_data != this) {
     buffer = pjrt_data.buffer;
+    zero_copy = pjrt_data.zero_copy;
   }
 }
 
@@ -200,8 +208,10 @@ std::vector<ComputationClient::DataPtr> PjRtComputationClient::GetDataShards(
   if (PjRtShardedData* sharded_data =
           dynamic_cast<PjRtShardedData*>(data.get())) {
     for (auto shard : sharded_data->shards) {
-      shards.push_back(std::make_shared<PjRtData>(
-          shard->device(), shard->shape(), shard->buffer));
+      auto data = std::make_shared<PjRtData>(shard->device(), shard->shape(),
+                                             shard->buffer);
+      data->zero_copy = shard->zero_copy;
+      shards.push_back(std::move(data));
     }
   } else {
     shards.push_back(data);
@@ -219,8 +229,10 @@ ComputationClient::DataPtr PjRtComputationClient::GetDataShard(
         << "GetDataShard out of range with index: " << index
         << " and num of shard: " << sharded_data->shards.size();
     std::shared_ptr<PjRtData> shard = sharded_data->shards[index];
-    return std::make_shared<PjRtData>(shard->device(), shard->shape(),
-                                      shard->buffer);
+    auto data = std::make_shared<PjRtData>(shard->device(), shard->shape(),
+                                           shard->buffer);
+    data->zero_copy = shard->zero_copy;
+    return data;
   } else {
     return data;
   }
@@ -235,8 +247,10 @@ ComputationClient::DataPtr PjRtComputationClient::WrapDataShards(
   for (auto& shard : shards) {
     XLA_CHECK(shard != nullptr);
     auto pjrt_shard = dynamic_cast<PjRtData*>(shard.get());
-    pjrt_data_shards.push_back(std::make_shared<PjRtData>(
-        pjrt_shard->device(), pjrt_shard->shape(), pjrt_shard->buffer));
+    auto data = std::make_shared<PjRtData>(
+        pjrt_shard->device(), pjrt_shard->shape(), pjrt_shard->buffer);
+    data->zero_copy = pjrt_shard->zero_copy;
+    pjrt_data_shards.push_back(std::move(data));
   }
   return std::make_shared<PjRtShardedData>(device, shape, pjrt_data_shards,
                                            sharding);
@@ -250,6 +264,37 @@ std::optional<xla::OpSharding> PjRtComputationClient::GetDataSharding(
   return std::optional<xla::OpSharding>();
 }
 
+ComputationClient::DataPtr PjRtComputationClient::TransferTensorToDevice(
+    std::shared_ptr<const TensorSource> tensor) {
+  xla::PjRtDevice* pjrt_device = StringToPjRtDevice(tensor->device());
+  // Sources convert their data on first access, so this overlaps with the
+  // transfers issued before, which complete in the background.
+  const void* data = tensor->data();
+  // The CPU client can wrap the host memory in the buffer instead of copying
+  // it, in which case the source is released along with the buffer.
+  bool supports_zero_copy =
+      absl::AsciiStrToLower(client_->platform_name()) == "cpu";
+  bool zero_copy = supports_zero_copy && tensor->can_alias();
+  if (zero_copy) {
+    XLA_COUNTER("ZeroCopyTransfer", 1);
+  }
+  xla::PjRtClient::HostBufferSemantics semantics =
+      zero_copy ? xla::PjRtClient::HostBufferSemantics::kImmutableZeroCopy
+                : xla::PjRtClient::HostBufferSemantics::
+                      kImmutableUntilTransferCompletes;
+  std::shared_ptr<xla::PjRtBuffer> buffer =
+      std::move(client_
+                    ->BufferFromHostBuffer(
+                        data, tensor->primitive_type(), tensor->dimensions(),
+                        tensor->byte_strides(), semantics,
+                        [tensor]() { /* frees tensor */ }, pjrt_device)
+                    .value());
+  auto pjrt_data =
+      std::make_shared<PjRtData>(tensor->device(), tensor->shape(), buffer);
+  pjrt_data->zero_copy = zero_copy;
+  return pjrt_data;
+}
+
 std::vector<ComputationClient::DataPtr> PjRtComputationClient::TransferToDevice(
     absl::Span<const std::shared_ptr<const TensorSource>> tensors) {
   metrics::TimedSection timed(TransferToDeviceMetric());
@@ -259,23 +304,8 @@ std::vector<ComputationClient::DataPtr> PjRtComputationClient::TransferToDevice(
   datas.reserve(tensors.size());
   int64_t total_size = 0;
   for (auto& tensor : tensors) {
-    xla::PjRtDevice* pjrt_device = StringToPjRtDevice(tensor->device());
-
     total_size += xla::ShapeUtil::ByteSizeOf(tensor->shape());
-
-    std::shared_ptr<xla::PjRtBuffer> buffer =
-        std::move(client_
-                      ->BufferFromHostBuffer(
-                          tensor->data(), tensor->primitive_type(),
-                          tensor->dimensions(), tensor->byte_strides(),
-                          xla::PjRtClient::HostBufferSemantics::
-                              kImmutableUntilTransferCompletes,
-                          [tensor]() { /* frees tensor */ }, pjrt_device)
-                      .value());
-
-    ComputationClient::DataPtr data =
-        std::make_shared<PjRtData>(tensor->device(), tensor->shape(), buffer);
-    datas.push_back(data);
+    datas.push_back(TransferTensorToDevice(tensor));
   }
   OutboundDataMetric()->AddSample(total_size);
   CreateDataHandlesCounter()->AddValue(datas.size());
@@ -283,6 +313,42 @@ std::vector<ComputationClient::DataPtr> PjRtComputationClient::TransferToDevice(
   return datas;
 }
 
+std::vector<std::shared_future<ComputationClient::DataPtr>>
+PjRtComputationClient::TransferToDeviceAsync(
+    std::vector<std::shared_ptr<const TensorSource>> tensors) {
+  auto promises =
+      std::make_shared<std::vector<std::promise<DataPtr>>>(tensors.size());
+  std::vector<std::shared_future<DataPtr>> futures;
+  futures.reserve(tensors.size());
+  for (auto& promise : *promises) {
+    futures.push_back(promise.get_future().share());
+  }
+  // Sources which convert their tensor lazily (e.g. AtenSource) would
+  // otherwise read it on the transfer thread, after the caller may have
+  // modified it. Only the device transfers are issued in the background.
+  for (auto& tensor : tensors) {
+    tensor->data();
+  }
+  pool_.Schedule([this, tensors = std::move(tensors), promises]() {
+    metrics::TimedSection timed(TransferToDeviceMetric());
+    tsl::profiler::TraceMe activity(
+        "PjRtComputationClient::TransferToDeviceAsync",
+        tsl::profiler::TraceMeLevel::kInfo);
+    int64_t total_size = 0;
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      try {
+        total_size += xla::ShapeUtil::ByteSizeOf(tensors[i]->shape());
+        (*promises)[i].set_value(TransferTensorToDevice(tensors[i]));
+      } catch (...) {
+        (*promises)[i].set_exception(std::current_exception());
+      }
+    }
+    OutboundDataMetric()->AddSample(total_size);
+    CreateDataHandlesCounter()->AddValue(tensors.size());
+  });
+  return futures;
+}
+
 ComputationClient::DataPtr PjRtComputationClient::TransferShardsToDevice(
     absl::Span<const std::shared_ptr<const TensorSource>> tensor_shards,
     std::string device, xla::Shape shape, xla::OpSharding sharding) {
@@ -298,8 +364,10 @@ ComputationClient::DataPtr PjRtComputationClient::TransferShardsToDevice(
   std::vector<std::shared_ptr<PjRtData>> pjrt_data_shards;
   for (auto& shard : data_shards) {
     auto pjrt_shard = dynamic_cast<PjRtData*>(shard.get());
-    pjrt_data_shards.push_back(std::make_shared<PjRtData>(
-        pjrt_shard->device(), pjrt_shard->shape(), pjrt_shard->buffer));
+    auto data = std::make_shared<PjRtData>(
+        pjrt_shard->device(), pjrt_shard->shape(), pjrt_shard->buffer);
+    data->zero_copy = pjrt_shard->zero_copy;
+    pjrt_data_shards.push_back(std::move(data));
   }
   return std::make_shared<PjRtShardedData>(device, shape, pjrt_data_shards,
                                            sharding);
@@ -339,42 +407,27 @@ PjRtComputationClient::ReplicateShardedData(
       // Data is replicated, return the first shard
       return sharded_data->shards[0];
     }
-    xla::XlaBuilder builder("ReplicateShardedData");
-    xla::Shape shape = sharded_data->shape();
-    builder.SetSharding(sharded_data->GetSharding());
-
-    // perform a simple identity calculation to reassemble the input as
-    // replicated output.
-    xla::XlaOp x = xla::Parameter(&builder, 0, shape, "p0");
-    builder.SetSharding(xla::HloSharding::Replicate().ToProto());
-    xla::XlaOp scalar_zero_op = xla::ConvertElementType(
-        xla::ConstantR0(&builder, 0), shape.element_type());
-    xla::XlaOp y = xla::Add(x, scalar_zero_op);
-    auto instruction = XlaBuilderFriend::GetInstruction(y);
-    *instruction->mutable_sharding() = xla::HloSharding::Replicate().ToProto();
-
-    xla::XlaComputation computation =
-        ConsumeValue(builder.Build(/*remove_dynamic_dimensions=*/false));
-    xla::ProgramShape program_shape =
-        ConsumeValue(computation.GetProgramShape());
-
-    std::string device = GetDefaultDevice();
-    std::vector<torch_xla::runtime::ComputationClient::CompileInstance>
-        instances;
-    instances.push_back({std::move(computation), device,
-                         GetCompilationDevices(device, {}), &shape,
-                         /*should_wrap_parameter=*/false,
-                         /*is_sharded=*/true,
-                         /*allow_spmd_sharding_propagation_to_output=*/false});
-    std::vector<
-        std::shared_ptr<torch_xla::runtime::ComputationClient::Computation>>
-        computations = Compile(std::move(instances));
+    std::string cache_key = absl::StrCat(
+        "ReplicateShardedData:",
+        sharded_data->shape().ToString(/*print_layout=*/true), ":",
+        sharded_data->GetSharding().SerializeAsString());
+    std::shared_ptr<Computation> computation =
+        utility_computations_.Get(cache_key);
+    if (computation == nullptr) {
+      XLA_COUNTER("UtilityComputationCacheMiss", 1);
+      computation = utility_computations_.Add(
+          std::move(cache_key),
+          CompileReplicateComputation(sharded_data->shape(),
+                                      sharded_data->GetSharding()));
+    } else {
+      XLA_COUNTER("UtilityComputationCacheHit", 1);
+    }
 
     torch_xla::runtime::ComputationClient::ExecuteReplicatedOptions
         execute_options;
     auto sharded_results =
-        ExecuteReplicated(*computations.front(), {sharded_data},
-                          GetLocalDevices(), execute_options);
+        ExecuteReplicated(*computation, {sharded_data}, GetLocalDevices(),
+                          execute_options);
     XLA_CHECK(sharded_results.size() > 0)
         << "empty ExecuteReplicated results returned.";
     XLA_CHECK(sharded_results.size() == 1)
@@ -388,6 +441,127 @@ PjRtComputationClient::ReplicateShardedData(
               << handle->ToString();
 }
 
+std::shared_ptr<ComputationClient::Computation>
+PjRtComputationClient::CompileReplicateComputation(
+    xla::Shape shape, const xla::OpSharding& sharding) {
+  xla::XlaBuilder builder("ReplicateShardedData");
+  builder.SetSharding(sharding);
+
+  // perform a simple identity calculation to reassemble the input as
+  // replicated output.
+  xla::XlaOp x = xla::Parameter(&builder, 0, shape, "p0");
+  builder.SetSharding(xla::HloSharding::Replicate().ToProto());
+  xla::XlaOp scalar_zero_op = xla::ConvertElementType(
+      xla::ConstantR0(&builder, 0), shape.element_type());
+  xla::XlaOp y = xla::Add(x, scalar_zero_op);
+  auto instruction = XlaBuilderFriend::GetInstruction(y);
+  *instruction->mutable_sharding() = xla::HloSharding::Replicate().ToProto();
+
+  xla::XlaComputation computation =
+      ConsumeValue(builder.Build(/*remove_dynamic_dimensions=*/false));
+
+  std::string device = GetDefaultDevice();
+  std::vector<torch_xla::runtime::ComputationClient::CompileInstance>
+      instances;
+  instances.push_back({std::move(computation), device,
+                       GetCompilationDevices(device, {}), &shape,
+                       /*should_wrap_parameter=*/false,
+                       /*is_sharded=*/true,
+                       /*allow_spmd_sharding_propagation_to_output=*/false});
+  return Compile(std::move(instances)).front();
+}
+
+std::optional<std::vector<PjRtComputationClient::HostShardTile>>
+PjRtComputationClient::GetHostShardTiles(const DataPtr& handle) {
+  static const bool host_reassembly =
+      sys_util::GetEnvBool("XLA_HOST_SHARD_REASSEMBLY", false);
+  auto sharded_data = std::dynamic_pointer_cast<PjRtShardedData>(handle);
+  if (!host_reassembly || sharded_data == nullptr ||
+      sharded_data->GetSharding().type() != xla::OpSharding::OTHER) {
+    return std::nullopt;
+  }
+  xla::HloSharding sharding =
+      ConsumeValue(xla::HloSharding::FromProto(sharded_data->GetSharding()));
+  const xla::Shape& shape = sharded_data->shape();
+  std::vector<HostShardTile> tiles;
+  std::set<std::vector<int64_t>> tile_offsets;
+  int64_t covered_elements = 0;
+  for (const auto& shard : sharded_data->shards) {
+    if (shard->buffer == nullptr) {
+      return std::nullopt;
+    }
+    // The tile assignment refers to the devices by their global ordinal.
+    int64_t ordinal = global_ordinals_.at(shard->buffer->device()->id());
+    xla::DimensionVector tile_offset =
+        sharding.TileOffsetForDevice(shape, ordinal);
+    std::vector<int64_t> offsets(tile_offset.begin(), tile_offset.end());
+    if (!tile_offsets.insert(offsets).second) {
+      // A replica of a tile which is already being transferred.
+      continue;
+    }
+    xla::DimensionVector limits = sharding.TileLimitForDevice(shape, ordinal);
+    std::vector<int64_t> sizes(offsets.size());
+    int64_t tile_elements = 1;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+      sizes[i] = limits[i] - offsets[i];
+      tile_elements *= sizes[i];
+    }
+    covered_elements += tile_elements;
+    tiles.push_back({shard, std::move(offsets), std::move(sizes)});
+  }
+  if (covered_elements != xla::ShapeUtil::ElementsIn(shape)) {
+    // Some of the tiles are only addressable from other hosts.
+    return std::nullopt;
+  }
+  return tiles;
+}
+
+void PjRtComputationClient::ReassembleShardsOnHost(
+    std::vector<HostShardTile> tiles, xla::MutableLiteralBase* literal,
+    std::function<void(absl::Status)> done) {
+  XLA_COUNTER("ReassembleShardsOnHost", 1);
+  struct State {
+    std::mutex mutex;
+    absl::Status status;
+    std::atomic<size_t> pending;
+    std::function<void(absl::Status)> done;
+  };
+  auto state = std::make_shared<State>();
+  state->pending = tiles.size();
+  state->done = std::move(done);
+  if (tiles.empty()) {
+    state->done(absl::OkStatus());
+    return;
+  }
+  for (auto& tile : tiles) {
+    auto shard_literal = std::make_shared<xla::Literal>(
+        host_output_shape(tile.shard->buffer.get()));
+    // Copy each shard into place as soon as it lands, off the transfer
+    // callback thread. The tile keeps its buffer alive until then.
+    tile.shard->buffer->ToLiteral(shard_literal.get())
+        .OnReady([this, state, literal, shard_literal,
+                  tile](absl::Status status) {
+          pool_.Schedule([state, literal, shard_literal, tile, status]() {
+            absl::Status copy_status = status;
+            if (copy_status.ok()) {
+              std::vector<int64_t> src_base(tile.offsets.size(), 0);
+              copy_status = literal->CopySliceFrom(*shard_literal, src_base,
+                                                   tile.offsets, tile.sizes);
+            }
+            if (!copy_status.ok()) {
+              std::lock_guard<std::mutex> lock(state->mutex);
+              if (state->status.ok()) {
+                state->status = copy_status;
+              }
+            }
+            if (--state->pending == 0) {
+              state->done(state->status);
+            }
+          });
+        });
+  }
+}
+
 std::vector<ComputationClient::DataPtr> PjRtComputationClient::ReshardData(
     absl::Span<const ComputationClient::DataPtr> handles,
     absl::Span<const xla::OpSharding> shardings) {
@@ -398,6 +572,41 @@ std::vector<ComputationClient::DataPtr> PjRtComputationClient::ReshardData(
       << "input handles and shardings must have the same length.";
   XLA_CHECK(UseVirtualDevice()) << "We only supports SPMD mode resharding.";
 
+  std::string cache_key = "ReshardData";
+  for (int i = 0; i < handles.size(); ++i) {
+    PjRtShardedData* sharded_data =
+        dynamic_cast<PjRtShardedData*>(handles[i].get());
+    XLA_CHECK_NE(sharded_data, nullptr)
+        << "Resharding requires PjRtShardedData on SPMD virtual device, "
+        << "current device: " << handles[i]->device();
+    XLA_CHECK_NE(shardings[i].type(), xla::OpSharding::UNKNOWN)
+        << "Resharding by UNKNOWN sharding type is not allowed.";
+    absl::StrAppend(&cache_key, ":",
+                    sharded_data->shape().ToString(/*print_layout=*/true), ":",
+                    sharded_data->GetSharding().SerializeAsString(), ":",
+                    shardings[i].SerializeAsString());
+  }
+  std::shared_ptr<Computation> computation =
+      utility_computations_.Get(cache_key);
+  if (computation == nullptr) {
+    XLA_COUNTER("UtilityComputationCacheMiss", 1);
+    computation = utility_computations_.Add(
+        std::move(cache_key), CompileReshardComputation(handles, shardings));
+  } else {
+    XLA_COUNTER("UtilityComputationCacheHit", 1);
+  }
+
+  torch_xla::runtime::ComputationClient::ExecuteReplicatedOptions
+      execute_options;
+  auto resharded_results = ExecuteReplicated(
+      *computation, handles, GetLocalDevices(), execute_options);
+  return resharded_results;
+}
+
+std::shared_ptr<ComputationClient::Computation>
+PjRtComputationClient::CompileReshardComputation(
+    absl::Span<const ComputationClient::DataPtr> handles,
+    absl::Span<const xla::OpSharding> shardings) {
   // Perform a simple identity calculation to reshard.
   xla::XlaBuilder builder("ReshardData");
 
@@ -410,17 +619,9 @@ std::vector<ComputationClient::DataPtr> PjRtComputationClient::ReshardData(
   for (int i = 0; i < handles.size(); ++i) {
     PjRtShardedData* sharded_data =
         dynamic_cast<PjRtShardedData*>(handles[i].get());
-    XLA_CHECK_NE(sharded_data, nullptr)
-        << "Resharding requires PjRtShardedData on SPMD virtual device, "
-        << "current device: " << handles[i]->device();
     shapes.push_back(sharded_data->shape());
-
-    const xla::OpSharding& sharding = shardings[i];
-    XLA_CHECK_NE(sharding.type(), xla::OpSharding::UNKNOWN)
-        << "Resharding by UNKNOWN sharding type is not allowed.";
-
     hlo_shardings.push_back(
-        ConsumeValue(xla::HloSharding::FromProto(sharding)));
+        ConsumeValue(xla::HloSharding::FromProto(shardings[i])));
 
     xla::OpSharding fallback_sharding;
     fallback_sharding.set_type(xla::OpSharding::REPLICATED);
@@ -455,14 +656,7 @@ std::vector<ComputationClient::DataPtr> PjRtComputationClient::ReshardData(
                        /*should_wrap_parameter=*/false,
                        /*is_sharded=*/true,
                        /*allow_spmd_sharding_propagation_to_output=*/false});
-  std::shared_ptr<torch_xla::runtime::ComputationClient::Computation>
-      computation = Compile(std::move(instances)).front();
-
-  torch_xla::runtime::ComputationClient::ExecuteReplicatedOptions
-      execute_options;
-  auto resharded_results = ExecuteReplicated(
-      *computation, handles, GetLocalDevices(), execute_options);
-  return resharded_results;
+  return Compile(std::move(instances)).front();
 }
 
 std::uintptr_t PjRtComputationClient::UnsafeBufferPointer(
@@ -504,8 +698,22 @@ std::vector<xla::Literal> PjRtComputationClient::TransferFromDevice(
   futures.reserve(handles.size());
   std::vector<xla::Literal> literals;
   literals.reserve(handles.size());
+  std::vector<std::future<absl::Status>> reassemblies;
   int64_t total_size = 0;
   for (auto handle : handles) {
+    if (std::optional<std::vector<HostShardTile>> tiles =
+            GetHostShardTiles(handle)) {
+      xla::Literal& literal =
+          literals.emplace_back(xla::ShapeUtil::MakeShapeWithDescendingLayout(
+              handle->shape().element_type(), handle->shape().dimensions()));
+      auto promise = std::make_shared<std::promise<absl::Status>>();
+      reassemblies.push_back(promise->get_future());
+      ReassembleShardsOnHost(
+          std::move(*tiles), &literal,
+          [promise](absl::Status status) { promise->set_value(status); });
+      total_size += literal.size_bytes();
+      continue;
+    }
     // Use XLA replication to reassemble the sharded data. If input handle
     // is not sharded, then it is a no-op.
     std::shared_ptr<PjRtData> pjrt_data = ReplicateShardedData(handle);
@@ -524,11 +732,61 @@ std::vector<xla::Literal> PjRtComputationClient::TransferFromDevice(
     XLA_CHECK_OK(status) << "Failed to await future from buffer to literal in"
                          << __FUNCTION__;
   }
+  for (auto& reassembly : reassemblies) {
+    XLA_CHECK_OK(reassembly.get())
+        << "Failed to reassemble the shards on the host in " << __FUNCTION__;
+  }
   InboundDataMetric()->AddSample(total_size);
 
   return literals;
 }
 
+std::vector<std::shared_future<void>>
+PjRtComputationClient::TransferFromDeviceAsync(
+    absl::Span<const DataPtr> handles,
+    std::vector<xla::MutableBorrowingLiteral> destinations) {
+  tsl::profiler::TraceMe activity(
+      "PjRtComputationClient::TransferFromDeviceAsync",
+      tsl::profiler::TraceMeLevel::kInfo);
+  XLA_CHECK_EQ(handles.size(), destinations.size());
+  std::vector<std::shared_future<void>> futures;
+  futures.reserve(handles.size());
+  int64_t total_size = 0;
+  for (size_t i = 0; i < handles.size(); ++i) {
+    // The literal must outlive the transfer, which writes through it.
+    auto literal =
+        std::make_shared<xla::MutableBorrowingLiteral>(destinations[i]);
+    total_size += literal->size_bytes();
+    auto promise = std::make_shared<std::promise<void>>();
+    futures.push_back(promise->get_future().share());
+    auto done = [literal, promise](absl::Status status) {
+      if (status.ok()) {
+        promise->set_value();
+      } else {
+        promise->set_exception(std::make_exception_ptr(std::runtime_error(
+            absl::StrCat("Failed to transfer buffer to host: ",
+                         status.ToString()))));
+      }
+    };
+    if (std::optional<std::vector<HostShardTile>> tiles =
+            GetHostShardTiles(handles[i])) {
+      ReassembleShardsOnHost(std::move(*tiles), literal.get(),
+                             std::move(done));
+      continue;
+    }
+
+    std::shared_ptr<PjRtData> pjrt_data = ReplicateShardedData(handles[i]);
+    XLA_CHECK(pjrt_data) << "PjRt_data is null in " << __FUNCTION__;
+    XLA_CHECK(pjrt_data->buffer != nullptr)
+        << "PjRt buffer is null in " << __FUNCTION__;
+    // Keep the buffer alive until the transfer completes.
+    pjrt_data->buffer->ToLiteral(literal.get())
+        .OnReady([done, pjrt_data](absl::Status status) { done(status); });
+  }
+  InboundDataMetric()->AddSample(total_size);
+  return futures;
+}
+
 std::vector<ComputationClient::ComputationPtr> PjRtComputationClient::Compile(
     std::vector<ComputationClient::CompileInstance> instances) {
   auto metrics_fn = CompileMetric;
@@ -538,9 +796,7 @@ std::vector<ComputationClient::ComputationPtr> PjRtComputationClient::Compile(
   metrics::TimedSection timed(metrics_fn());
   tsl::profiler::TraceMe activity("PjRtComputationClient::Compile",
                                   tsl::profiler::TraceMeLevel::kInfo);
-  std::vector<ComputationClient::ComputationPtr> computations;
-
-  for (auto& instance : instances) {
+  auto compile_fn = [&](CompileInstance& instance) -> ComputationPtr {
     xla::CompileOptions compile_options;
     if (instance.is_sharded) {
       // TODO(yeounoh) multi-host, multi-slice configurations
@@ -639,12 +895,11 @@ std::vector<ComputationClient::ComputationPtr> PjRtComputationClient::Compile(
             std::move(xla::XlaComputation(hlo_modules[0]->ToProto())),
             instance.devices, std::move(executable));
 
-    computations.push_back(pjrt_computation);
-
     CreateCompileHandlesCounter()->AddValue(1);
-  }
+    return pjrt_computation;
+  };
 
-  return computations;
+  return CompileInstances(instances, compile_fn, &pool_);
 }
 
 std::string PjRtComputationClient::SerializeComputation(
@@ -656,7 +911,7 @@ std::string PjRtComputationClient::SerializeComputation(
 }
 
 ComputationClient::ComputationPtr PjRtComputationClient::DeserializeComputation(
-    const std::string& serialized) {
+    absl::string_view serialized) {
   auto executable_or = client_->DeserializeExecutable(serialized, std::nullopt);
   if (!executable_or.ok()) {
     TF_LOG(WARNING) << "Failed to deserialize executable: "
@@ -712,22 +967,25 @@ PjRtComputationClient::ExecuteComputation(
   xla::PjRtDevice* pjrt_device = StringToPjRtDevice(device);
   XLA_CHECK(pjrt_device->IsAddressable()) << pjrt_device->DebugString();
 
+  xla::ExecuteOptions execute_options;
+  execute_options.untuple_result = options.explode_tuple;
+  execute_options.strict_shape_checking = false;
+
   std::vector<xla::PjRtBuffer*> buffers;
   buffers.reserve(arguments.size());
-  for (auto& argument : arguments) {
-    const PjRtData* pjrt_data = dynamic_cast<PjRtData*>(argument.get());
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    const PjRtData* pjrt_data = dynamic_cast<PjRtData*>(arguments[i].get());
 
     XLA_CHECK(pjrt_device == pjrt_data->buffer->device())
         << "The device currently being used : " << pjrt_device->DebugString()
         << " is different from the device where the buffer resides: "
         << pjrt_data->buffer->device()->DebugString();
     buffers.push_back(pjrt_data->buffer.get());
+    if (pjrt_data->zero_copy) {
+      execute_options.non_donatable_input_indices.insert(i);
+    }
   }
 
-  xla::ExecuteOptions execute_options;
-  execute_options.untuple_result = options.explode_tuple;
-  execute_options.strict_shape_checking = false;
-
   // Required as of cl/518733871
   execute_options.use_major_to_minor_data_layout_for_callbacks = true;
 
@@ -823,6 +1081,15 @@ PjRtComputationClient::ExecuteReplicated(
   execute_options.strict_shape_checking = true;
   // TODO(yeounoh) currently only support single-slice execution
   execute_options.multi_slice_config = nullptr;
+  for (size_t i = 0; i < arguments.size(); ++i) {
+    auto pjrt_data = std::dynamic_pointer_cast<PjRtShardedData>(arguments[i]);
+    if (std::any_of(pjrt_data->shards.begin(), pjrt_data->shards.end(),
+                    [](const std::shared_ptr<PjRtData>& shard) {
+                      return shard->zero_copy;
+                    })) {
+      execute_options.non_donatable_input_indices.insert(i);
+    }
+  }
 
   // Required as of cl/518733871
   execute_options.use_major_to_minor_data_layout_for_callbacks = true;
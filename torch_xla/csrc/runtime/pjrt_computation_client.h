@@ -4,10 +4,13 @@
 #include <torch/csrc/lazy/backend/backend_data.h>
 
 #include <cstdint>
+#include <functional>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
 
 #include "absl/types/span.h"
+#include "torch_xla/csrc/runtime/cache.h"
 #include "torch_xla/csrc/runtime/computation_client.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
 #include "torch_xla/csrc/runtime/operation_manager.h"
@@ -48,6 +51,9 @@ class PjRtComputationClient : public ComputationClient {
   std::vector<DataPtr> TransferToDevice(
       absl::Span<const std::shared_ptr<const TensorSource>> tensors) override;
 
+  std::vector<std::shared_future<DataPtr>> TransferToDeviceAsync(
+      std::vector<std::shared_ptr<const TensorSource>> tensors) override;
+
   // Reshard and return data sharded by `sharding` spec. This is a no-op if
   // the input sharding spec is identical to the target `sharding` sharding
   // spec.
@@ -59,6 +65,10 @@ class PjRtComputationClient : public ComputationClient {
   std::vector<xla::Literal> TransferFromDevice(
       absl::Span<const DataPtr> handles) override;
 
+  std::vector<std::shared_future<void>> TransferFromDeviceAsync(
+      absl::Span<const DataPtr> handles,
+      std::vector<xla::MutableBorrowingLiteral> destinations) override;
+
   std::uintptr_t UnsafeBufferPointer(const DataPtr handle) override;
 
   std::shared_ptr<xla::PjRtBuffer> GetPjRtBuffer(const DataPtr handle) override;
@@ -74,7 +84,7 @@ class PjRtComputationClient : public ComputationClient {
 
   std::string SerializeComputation(const ComputationPtr computation) override;
 
-  ComputationPtr DeserializeComputation(const std::string& serialized) override;
+  ComputationPtr DeserializeComputation(absl::string_view serialized) override;
 
   std::vector<DataPtr> ExecuteComputation(
       const Computation& computation, absl::Span<const DataPtr> arguments,
@@ -156,6 +166,8 @@ class PjRtComputationClient : public ComputationClient {
   const PJRT_Api* GetPjRtCApiIfAvailable() const;
 
  private:
+  static constexpr size_t kUtilityComputationCacheSize = 128;
+
   std::unique_ptr<xla::PjRtClient> client_;
   std::unique_ptr<XlaCoordinator> coordinator_;
   // global_ordinals_ tracks a map from PjRtDeviceId to the device's
@@ -167,9 +179,16 @@ class PjRtComputationClient : public ComputationClient {
   tsl::thread::ThreadPool pool_ = tsl::thread::ThreadPool(
       tsl::Env::Default(), "pjrt", std::thread::hardware_concurrency());
   torch::lazy::hash_t comp_env_hash_;
+  // Compiled replication and resharding programs, keyed by the shapes and
+  // the source and target shardings of their inputs.
+  util::Cache<std::string, Computation> utility_computations_{
+      kUtilityComputationCacheSize};
 
   xla::PjRtDevice* StringToPjRtDevice(const std::string& device);
 
+  // Issues the transfer of a single tensor, which completes asynchronously.
+  DataPtr TransferTensorToDevice(std::shared_ptr<const TensorSource> tensor);
+
   struct PjRtData : public Data {
     PjRtData(std::string device, xla::Shape device_shape)
         : Data(std::move(device), std::move(device_shape)) {}
@@ -218,6 +237,10 @@ class PjRtComputationClient : public ComputationClient {
     }
 
     std::shared_ptr<xla::PjRtBuffer> buffer;
+    // Whether `buffer` wraps host memory owned by its TensorSource (see
+    // TensorSource::can_alias()). Such buffers are never donated, since the
+    // computation would write its results into that memory.
+    bool zero_copy = false;
   };
 
   struct PjRtShardedData : public Data {
@@ -297,12 +320,55 @@ class PjRtComputationClient : public ComputationClient {
       }
     }
 
+    size_t memory_size_bytes() const override {
+      size_t bytes = Computation::memory_size_bytes();
+      auto memory_stats_status_or = executable->GetCompiledMemoryStats();
+      if (memory_stats_status_or.ok()) {
+        const xla::CompiledMemoryStats& memory_stats =
+            memory_stats_status_or.value();
+        bytes += memory_stats.generated_code_size_in_bytes +
+                 memory_stats.host_generated_code_size_in_bytes;
+      }
+      return bytes;
+    }
+
     std::unique_ptr<xla::PjRtLoadedExecutable> executable;
     std::optional<std::vector<xla::OpSharding>> output_shardings_;
   };
 
   // Use XLA replication to re-assemble the sharded data.
   std::shared_ptr<PjRtData> ReplicateShardedData(const DataPtr& handle);
+
+  // A shard to transfer to the host, and the region of the full array it
+  // holds.
+  struct HostShardTile {
+    std::shared_ptr<PjRtData> shard;
+    std::vector<int64_t> offsets;
+    std::vector<int64_t> sizes;
+  };
+
+  // Returns the shards to stitch together on the host to rebuild the data
+  // behind `handle`, without the replicated copies of a tile. Returns
+  // std::nullopt when the data has to be replicated on the devices instead,
+  // which is the case unless XLA_HOST_SHARD_REASSEMBLY is set, the sharding is
+  // tiled and all the tiles are addressable from this host.
+  std::optional<std::vector<HostShardTile>> GetHostShardTiles(
+      const DataPtr& handle);
+
+  // Transfers the tiles to the host and copies each of them into its region
+  // of `literal`, in parallel on the thread pool. Calls `done` once `literal`
+  // has been written, or with the first error.
+  void ReassembleShardsOnHost(std::vector<HostShardTile> tiles,
+                              xla::MutableLiteralBase* literal,
+                              std::function<void(absl::Status)> done);
+
+  // Compile the identity programs used by ReplicateShardedData and
+  // ReshardData, which are cached in utility_computations_.
+  std::shared_ptr<Computation> CompileReplicateComputation(
+      xla::Shape shape, const xla::OpSharding& sharding);
+  std::shared_ptr<Computation> CompileReshardComputation(
+      absl::Span<const DataPtr> handles,
+      absl::Span<const xla::OpSharding> shardings);
 };
 
 }  // namespace runtime
@@ -78,5 +78,98 @@ TEST(PjRtComputationClientTest, Init) {
       result_literals[0]));
 }
 
+TEST(PjRtComputationClientTest, CompileMultipleInstances) {
+  tsl::setenv("PJRT_DEVICE", "CPU", true);
+  auto client = std::make_unique<PjRtComputationClient>();
+  std::string device = client->GetDefaultDevice();
+
+  // Compile several independent instances in a single call, which runs them
+  // concurrently.
+  static constexpr int kNumInstances = 8;
+  auto shape = xla::ShapeUtil::MakeShape(xla::F32, {2, 2});
+  std::vector<ComputationClient::CompileInstance> instances;
+  for (int i = 0; i < kNumInstances; ++i) {
+    instances.push_back(ComputationClient::CompileInstance(
+        std::move(MakeComputation().value()), device,
+        client->GetCompilationDevices(device, client->GetLocalDevices()),
+        &shape));
+  }
+  std::vector<ComputationClient::ComputationPtr> computations =
+      client->Compile(std::move(instances));
+  ASSERT_EQ(computations.size(), kNumInstances);
+
+  // Every computation must be usable, and returned in the instances order.
+  std::vector<std::shared_ptr<const TensorSource>> args = {
+      std::make_shared<LiteralSource>(
+          xla::LiteralUtil::CreateR2<float>({{1.0f, 2.0f}, {3.0f, 4.0f}}),
+          device),
+      std::make_shared<LiteralSource>(
+          xla::LiteralUtil::CreateR2<float>({{5.0f, 6.0f}, {7.0f, 8.0f}}),
+          device)};
+  std::vector<ComputationClient::DataPtr> arguments =
+      client->TransferToDevice(absl::MakeConstSpan(args));
+  ComputationClient::ExecuteComputationOptions options{};
+  for (const auto& computation : computations) {
+    ASSERT_NE(computation, nullptr);
+    std::vector<ComputationClient::DataPtr> results =
+        client->ExecuteComputation(*computation, arguments, device, options);
+    auto result_literals = client->TransferFromDevice(results);
+    ASSERT_THAT(result_literals, ::testing::SizeIs(1));
+    EXPECT_TRUE(xla::LiteralTestUtil::Equal(
+        xla::LiteralUtil::CreateR2<float>({{6.0f, 8.0f}, {10.0f, 12.0f}}),
+        result_literals[0]));
+  }
+}
+
+TEST(PjRtComputationClientTest, TransferToDeviceAsync) {
+  tsl::setenv("PJRT_DEVICE", "CPU", true);
+  auto client = std::make_unique<PjRtComputationClient>();
+  std::string device = client->GetDefaultDevice();
+
+  static constexpr int kNumTensors = 4;
+  std::vector<std::shared_ptr<const TensorSource>> args;
+  for (int i = 0; i < kNumTensors; ++i) {
+    args.push_back(std::make_shared<LiteralSource>(
+        xla::LiteralUtil::CreateR1<float>({1.0f * i, 2.0f * i}), device));
+  }
+  std::vector<std::shared_future<ComputationClient::DataPtr>> futures =
+      client->TransferToDeviceAsync(args);
+  ASSERT_EQ(futures.size(), kNumTensors);
+
+  // Each handle is usable as soon as its own future is ready.
+  for (int i = 0; i < kNumTensors; ++i) {
+    ComputationClient::DataPtr data = futures[i].get();
+    ASSERT_NE(data, nullptr);
+    auto literals = client->TransferFromDevice({data});
+    ASSERT_THAT(literals, ::testing::SizeIs(1));
+    EXPECT_TRUE(xla::LiteralTestUtil::Equal(
+        xla::LiteralUtil::CreateR1<float>({1.0f * i, 2.0f * i}), literals[0]));
+  }
+}
+
+TEST(PjRtComputationClientTest, TransferFromDeviceAsync) {
+  tsl::setenv("PJRT_DEVICE", "CPU", true);
+  auto client = std::make_unique<PjRtComputationClient>();
+  std::string device = client->GetDefaultDevice();
+
+  xla::Literal expected =
+      xla::LiteralUtil::CreateR2<float>({{1.0f, 2.0f}, {3.0f, 4.0f}});
+  std::vector<std::shared_ptr<const TensorSource>> args = {
+      std::make_shared<LiteralSource>(expected.Clone(), device)};
+  std::vector<ComputationClient::DataPtr> handles =
+      client->TransferToDevice(absl::MakeConstSpan(args));
+
+  // The data is written into the caller's memory.
+  std::vector<float> host(4);
+  std::vector<xla::MutableBorrowingLiteral> destinations;
+  destinations.emplace_back(reinterpret_cast<const char*>(host.data()),
+                            expected.shape());
+  std::vector<std::shared_future<void>> futures =
+      client->TransferFromDeviceAsync(handles, std::move(destinations));
+  ASSERT_EQ(futures.size(), 1);
+  futures[0].get();
+  EXPECT_EQ(host, std::vector<float>({1.0f, 2.0f, 3.0f, 4.0f}));
+}
+
 }  // namespace runtime
 }  // namespace torch_xla
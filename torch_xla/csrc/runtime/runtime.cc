@@ -4,6 +4,7 @@
 #include "torch_xla/csrc/runtime/computation_client.h"
 #include "torch_xla/csrc/runtime/env_vars.h"
 #include "torch_xla/csrc/runtime/ifrt_computation_client.h"
+#include "torch_xla/csrc/runtime/metrics_exporter.h"
 #include "torch_xla/csrc/runtime/pjrt_computation_client.h"
 #include "tsl/platform/stacktrace_handler.h"
 
@@ -32,6 +33,7 @@ ComputationClient* GetComputationClient() {
     }
 
     XLA_CHECK(client);
+    metrics::MetricsExporter::MaybeStart();
 
     g_computation_client_initialized = true;
     return client;
@@ -0,0 +1,86 @@
+#include "torch_xla/csrc/runtime/staging_buffer_pool.h"
+
+#include <torch/csrc/lazy/core/metrics.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "torch_xla/csrc/runtime/debug_macros.h"
+#include "torch_xla/csrc/runtime/sys_util.h"
+
+namespace torch_xla {
+namespace runtime {
+
+StagingBufferPool* StagingBufferPool::Get() {
+  static StagingBufferPool* pool = new StagingBufferPool(
+      sys_util::GetEnvInt("XLA_STAGING_BUFFER_POOL_BYTES", 0));
+  return pool;
+}
+
+StagingBufferPool::StagingBufferPool(size_t max_pooled_bytes)
+    : max_pooled_bytes_(max_pooled_bytes) {}
+
+StagingBufferPool::~StagingBufferPool() {
+  for (auto& [size_class, buffers] : free_buffers_) {
+    for (void* ptr : buffers) {
+      std::free(ptr);
+    }
+  }
+}
+
+size_t StagingBufferPool::GetSizeClass(size_t size) {
+  static const size_t kMinSize = 4096;
+  if (size <= kMinSize) {
+    return kMinSize;
+  }
+  size_t power = kMinSize;
+  while (power < size) {
+    power <<= 1;
+  }
+  size_t granularity = std::max(kMinSize, power / 8);
+  return (size + granularity - 1) / granularity * granularity;
+}
+
+std::shared_ptr<void> StagingBufferPool::Allocate(size_t size) {
+  size_t size_class = GetSizeClass(size);
+  void* ptr = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    auto it = free_buffers_.find(size_class);
+    if (it != free_buffers_.end() && !it->second.empty()) {
+      ptr = it->second.back();
+      it->second.pop_back();
+      pooled_bytes_ -= size_class;
+    }
+  }
+  if (ptr != nullptr) {
+    TORCH_LAZY_COUNTER("StagingBufferPoolHit", 1);
+  } else {
+    TORCH_LAZY_COUNTER("StagingBufferPoolMiss", 1);
+    ptr = std::aligned_alloc(kAlignment, size_class);
+    XLA_CHECK(ptr != nullptr)
+        << "Failed to allocate a staging buffer of " << size_class << " bytes";
+  }
+  return std::shared_ptr<void>(
+      ptr, [this, size_class](void* ptr) { Release(ptr, size_class); });
+}
+
+size_t StagingBufferPool::GetPooledBytes() {
+  std::lock_guard<std::mutex> lock(lock_);
+  return pooled_bytes_;
+}
+
+void StagingBufferPool::Release(void* ptr, size_t size_class) {
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (pooled_bytes_ + size_class <= max_pooled_bytes_) {
+      free_buffers_[size_class].push_back(ptr);
+      pooled_bytes_ += size_class;
+      return;
+    }
+  }
+  std::free(ptr);
+}
+
+}  // namespace runtime
+}  // namespace torch_xla
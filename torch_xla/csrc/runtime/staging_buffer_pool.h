@@ -0,0 +1,54 @@
+#ifndef XLA_CLIENT_STAGING_BUFFER_POOL_H_
+#define XLA_CLIENT_STAGING_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch_xla {
+namespace runtime {
+
+// Pool of aligned host buffers used to stage tensors before they are
+// transferred to the devices. Buffers are recycled once the transfer reading
+// from them has completed, which avoids paying for the allocation (and the
+// page faults of fresh memory) of every input batch.
+class StagingBufferPool {
+ public:
+  static constexpr size_t kAlignment = 64;
+
+  // The global pool, holding at most XLA_STAGING_BUFFER_POOL_BYTES bytes of
+  // unused buffers. Pooling is disabled by default, in which case buffers are
+  // freed as soon as they are released.
+  static StagingBufferPool* Get();
+
+  explicit StagingBufferPool(size_t max_pooled_bytes);
+
+  ~StagingBufferPool();
+
+  // Returns a buffer of at least `size` bytes, which goes back to the pool
+  // once the last reference to it is dropped. The pool must outlive the
+  // buffers it returns.
+  std::shared_ptr<void> Allocate(size_t size);
+
+  // Returns the bytes held by unused buffers.
+  size_t GetPooledBytes();
+
+ private:
+  // Rounds sizes up, so that buffers of similar sizes can be reused for each
+  // other while wasting at most 1/8th of the buffer.
+  static size_t GetSizeClass(size_t size);
+
+  void Release(void* ptr, size_t size_class);
+
+  const size_t max_pooled_bytes_;
+  std::mutex lock_;
+  std::map<size_t, std::vector<void*>> free_buffers_;
+  size_t pooled_bytes_ = 0;
+};
+
+}  // namespace runtime
+}  // namespace torch_xla
+
+#endif  // XLA_CLIENT_STAGING_BUFFER_POOL_H_
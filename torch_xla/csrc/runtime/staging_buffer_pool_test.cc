@@ -0,0 +1,45 @@
+#include "torch_xla/csrc/runtime/staging_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace torch_xla {
+namespace runtime {
+
+TEST(StagingBufferPoolTest, ReusesBuffers) {
+  StagingBufferPool pool(/*max_pooled_bytes=*/1 << 20);
+  void* first = nullptr;
+  {
+    std::shared_ptr<void> buffer = pool.Allocate(10000);
+    first = buffer.get();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first) %
+                  StagingBufferPool::kAlignment,
+              0);
+    EXPECT_EQ(pool.GetPooledBytes(), 0);
+  }
+  EXPECT_GT(pool.GetPooledBytes(), 0);
+
+  // A buffer of a similar size reuses the released one.
+  std::shared_ptr<void> buffer = pool.Allocate(9000);
+  EXPECT_EQ(buffer.get(), first);
+  EXPECT_EQ(pool.GetPooledBytes(), 0);
+
+  // While it is in use, a new buffer is allocated.
+  std::shared_ptr<void> other = pool.Allocate(9000);
+  EXPECT_NE(other.get(), first);
+}
+
+TEST(StagingBufferPoolTest, BoundsPooledBytes) {
+  StagingBufferPool pool(/*max_pooled_bytes=*/8192);
+  {
+    std::shared_ptr<void> small = pool.Allocate(4096);
+    std::shared_ptr<void> large = pool.Allocate(1 << 20);
+  }
+  // Only the buffers fitting within the limit are kept.
+  EXPECT_EQ(pool.GetPooledBytes(), 4096);
+}
+
+}  // namespace runtime
+}  // namespace torch_xla
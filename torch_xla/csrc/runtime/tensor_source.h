@@ -1,13 +1,20 @@
 #ifndef XLA_CLIENT_TENSOR_SOURCE_H_
 #define XLA_CLIENT_TENSOR_SOURCE_H_
 
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <ATen/Tensor.h>
 #include <torch/csrc/lazy/core/metrics.h>
 
+#include <mutex>
 #include <vector>
 
 #include "torch_xla/csrc/dtype.h"
+#include "torch_xla/csrc/runtime/convert_kernels.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
+#include "torch_xla/csrc/runtime/staging_buffer_pool.h"
+#include "torch_xla/csrc/runtime/sys_util.h"
+#include "xla/layout_util.h"
 #include "xla/literal.h"
 #include "xla/shape.h"
 #include "xla/shape_util.h"
@@ -42,47 +49,169 @@ class TensorSource {
     return shape().element_type();
   }
 
+  // Whether the device buffer may alias data() instead of copying it. This
+  // requires the data to remain valid and unmodified for as long as the
+  // source is alive.
+  virtual bool can_alias() const { return false; }
+
  private:
   std::string device_;
 };
 
+// Converts the tensor into the device type and a contiguous layout when its
+// data is first accessed, which is when it is about to be transferred. This
+// lets TransferToDevice overlap the conversion of a tensor with the transfer
+// of the previous ones. The converted data is written into a buffer from the
+// StagingBufferPool, which is recycled once the transfer completes. The
+// conversions which have a runtime::ConvertKernels kernel use it, the other
+// ones go through ATen's copy_.
+//
+// With XLA_ZERO_COPY_TRANSFER=1, CPU tensors which already have the device
+// type and a row-major dense layout are not converted at all, and the device
+// buffer may alias their storage on clients which support it.
+//
+// `staged` tensors were written by the caller for this transfer only, in the
+// device type and a contiguous layout (e.g. the shards of
+// ShardingUtil::ShardAndTransferTensor). They are never modified afterwards,
+// so they are transferred as they are, and aliased with
+// XLA_ZERO_COPY_TRANSFER=1.
 class AtenSource : public TensorSource {
  public:
-  AtenSource(const at::Tensor& tensor, xla::Shape shape, std::string device)
-      : TensorSource(std::move(device)), shape_(std::move(shape)) {
+  AtenSource(const at::Tensor& tensor, xla::Shape shape, std::string device,
+             bool staged = false)
+      : TensorSource(std::move(device)),
+        source_tensor_(tensor),
+        shape_(std::move(shape)) {
     at::ScalarType target_torch_type = TorchTypeFromXlaType(primitive_type());
     if (target_torch_type != tensor.type().scalarType()) {
       TORCH_LAZY_COUNTER("AtenSourceDowncasts", 1);
+    } else if (IsAliasable(tensor) && (staged || ZeroCopyEnabled())) {
+      if (staged) {
+        TORCH_LAZY_COUNTER("AtenSourceStaged", 1);
+      }
+      tensor_ = tensor;
+      source_tensor_ = at::Tensor();
+      as_is_ = true;
+      can_alias_ = ZeroCopyEnabled();
     }
-    // TODO(ysiraichi): check, first, if tensor lives in a device that the
-    // current PjRt client has access. If so, we don't need to go through the
-    // CPU.
-    tensor_ = std::move(
-        tensor.to(at::TensorOptions().device(at::kCPU).dtype(target_torch_type),
-                  /*non_blocking=*/false,
-                  /*copy=*/true, at::MemoryFormat::Contiguous));
   }
 
-  const void* data() const override { return tensor_.const_data_ptr(); }
+  const void* data() const override { return GetTensor().const_data_ptr(); }
 
   const xla::Shape& shape() const override { return shape_; }
 
   std::vector<int64_t> byte_strides() const override {
+    const at::Tensor& tensor = GetTensor();
     std::vector<int64_t> strides;
-    for (auto& stride : tensor_.strides()) {
-      strides.push_back(stride * tensor_.itemsize());
+    for (auto& stride : tensor.strides()) {
+      strides.push_back(stride * tensor.itemsize());
     }
     return strides;
   }
 
   std::vector<int64_t> dimensions() const override {
-    auto sizes = tensor_.sizes();
+    auto sizes = GetTensor().sizes();
     return {sizes.begin(), sizes.end()};
   }
 
+  bool can_alias() const override { return can_alias_; }
+
  private:
-  at::Tensor tensor_;
+  static bool ZeroCopyEnabled() {
+    static const bool zero_copy =
+        sys_util::GetEnvBool("XLA_ZERO_COPY_TRANSFER", false);
+    return zero_copy;
+  }
+
+  bool IsAliasable(const at::Tensor& tensor) const {
+    return tensor.device().is_cpu() && tensor.is_contiguous() &&
+           tensor.numel() > 0 && !tensor.is_conj() && !tensor.is_neg() &&
+           (!shape_.has_layout() ||
+            xla::LayoutUtil::IsMonotonicWithDim0Major(shape_.layout()));
+  }
+
+  const at::Tensor& GetTensor() const {
+    if (as_is_) {
+      return tensor_;
+    }
+    std::call_once(converted_, [this]() {
+      at::ScalarType target_torch_type = TorchTypeFromXlaType(primitive_type());
+      // TODO(ysiraichi): check, first, if tensor lives in a device that the
+      // current PjRt client has access. If so, we don't need to go through
+      // the CPU.
+      at::TensorOptions options =
+          at::TensorOptions().device(at::kCPU).dtype(target_torch_type);
+      size_t size =
+          source_tensor_.numel() * c10::elementSize(target_torch_type);
+      if (size == 0) {
+        tensor_ = at::empty(source_tensor_.sizes(), options);
+      } else {
+        std::shared_ptr<void> buffer = StagingBufferPool::Get()->Allocate(size);
+        void* ptr = buffer.get();
+        tensor_ = at::from_blob(
+            ptr, source_tensor_.sizes(),
+            [buffer = std::move(buffer)](void*) mutable { buffer.reset(); },
+            options);
+        // Fuses the copy and the type conversion into the staging buffer.
+        if (!ConvertWithKernel(source_tensor_, ptr, target_torch_type)) {
+          tensor_.copy_(source_tensor_);
+        }
+      }
+      source_tensor_ = at::Tensor();
+    });
+    return tensor_;
+  }
+
+  // Converts the elements of `source` into `dest`, which has room for them,
+  // if there is a ConvertKernels kernel for this pair of types.
+  static bool ConvertWithKernel(const at::Tensor& source, void* dest,
+                                at::ScalarType dest_type) {
+    if (!source.device().is_cpu() || !source.is_contiguous() ||
+        source.is_conj() || source.is_neg()) {
+      return false;
+    }
+    const ConvertKernels& kernels = GetConvertKernels();
+    at::ScalarType source_type = source.scalar_type();
+    if (source_type == at::kFloat && dest_type == at::kBFloat16) {
+      RunKernel(kernels.float_to_bfloat16, source, dest);
+    } else if (source_type == at::kBFloat16 && dest_type == at::kFloat) {
+      RunKernel(kernels.bfloat16_to_float, source, dest);
+    } else if (source_type == at::kFloat && dest_type == at::kHalf) {
+      RunKernel(kernels.float_to_half, source, dest);
+    } else if (source_type == at::kHalf && dest_type == at::kFloat) {
+      RunKernel(kernels.half_to_float, source, dest);
+    } else if (source_type == at::kDouble && dest_type == at::kFloat) {
+      RunKernel(kernels.double_to_float, source, dest);
+    } else if (source_type == at::kLong && dest_type == at::kInt) {
+      RunKernel(kernels.int64_to_int32, source, dest);
+    } else if (source_type == at::kByte && dest_type == at::kBool) {
+      RunKernel(kernels.uint8_to_bool, source, dest);
+    } else {
+      return false;
+    }
+    TORCH_LAZY_COUNTER("AtenSourceConvertKernel", 1);
+    return true;
+  }
+
+  template <typename S, typename D>
+  static void RunKernel(void (*kernel)(const S*, D*, int64_t),
+                        const at::Tensor& source, void* dest) {
+    const S* source_data = static_cast<const S*>(source.const_data_ptr());
+    D* dest_data = static_cast<D*>(dest);
+    at::parallel_for(0, source.numel(), at::internal::GRAIN_SIZE,
+                     [&](int64_t begin, int64_t end) {
+                       kernel(source_data + begin, dest_data + begin,
+                              end - begin);
+                     });
+  }
+
+  mutable at::Tensor source_tensor_;
+  mutable at::Tensor tensor_;
+  mutable std::once_flag converted_;
   xla::Shape shape_;
+  // Whether tensor_ is used without conversion.
+  bool as_is_ = false;
+  bool can_alias_ = false;
 };
 
 class LiteralSource : public TensorSource {
@@ -0,0 +1,143 @@
+#ifndef XLA_CLIENT_TILED_COPY_H_
+#define XLA_CLIENT_TILED_COPY_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "torch_xla/csrc/runtime/debug_macros.h"
+
+namespace torch_xla {
+namespace runtime {
+
+// Plans a copy between two layouts of the same array. The array is split in
+// tiles over the most minor dimension of the destination and the most
+// minor (other) dimension of the source, and each tile is copied as a set of
+// rows which are contiguous in the destination. Within a tile, the source
+// cache lines touched by a row are reused by the following rows, so both
+// buffers are walked in a cache friendly fashion even for transposes. Tiles
+// are independent, so ranges of them can be copied in parallel.
+class TiledCopyPlan {
+ public:
+  // The strides are expressed in elements, for each logical dimension.
+  TiledCopyPlan(absl::Span<const int64_t> dimensions,
+                absl::Span<const int64_t> src_strides,
+                absl::Span<const int64_t> dest_strides, int64_t tile_size) {
+    XLA_CHECK_EQ(dimensions.size(), src_strides.size());
+    XLA_CHECK_EQ(dimensions.size(), dest_strides.size());
+    XLA_CHECK_GT(tile_size, 0);
+    int64_t row_dim = MinorDimension(dimensions, dest_strides, -1);
+    int64_t col_dim = MinorDimension(dimensions, src_strides, row_dim);
+    if (row_dim >= 0) {
+      row_size_ = dimensions[row_dim];
+      row_src_stride_ = src_strides[row_dim];
+      row_dest_stride_ = dest_strides[row_dim];
+    }
+    if (col_dim >= 0) {
+      col_size_ = dimensions[col_dim];
+      col_src_stride_ = src_strides[col_dim];
+      col_dest_stride_ = dest_strides[col_dim];
+    }
+    // The remaining dimensions are walked from the most major one in the
+    // destination, so that consecutive tiles write to nearby memory.
+    std::vector<int64_t> outer_dims;
+    for (int64_t dim = 0; dim < dimensions.size(); ++dim) {
+      if (dim != row_dim && dim != col_dim && dimensions[dim] > 1) {
+        outer_dims.push_back(dim);
+      }
+    }
+    std::sort(outer_dims.begin(), outer_dims.end(),
+              [&](int64_t a, int64_t b) {
+                return dest_strides[a] > dest_strides[b];
+              });
+    int64_t num_outer = 1;
+    for (int64_t dim : outer_dims) {
+      outer_sizes_.push_back(dimensions[dim]);
+      outer_src_strides_.push_back(src_strides[dim]);
+      outer_dest_strides_.push_back(dest_strides[dim]);
+      num_outer *= dimensions[dim];
+    }
+    // Rows which are contiguous on both sides need no blocking.
+    row_tile_size_ = row_src_stride_ == 1 ? row_size_ : tile_size;
+    col_tile_size_ = tile_size;
+    row_tiles_ = (row_size_ + row_tile_size_ - 1) / row_tile_size_;
+    col_tiles_ = (col_size_ + col_tile_size_ - 1) / col_tile_size_;
+    bool empty = std::find(dimensions.begin(), dimensions.end(), 0) !=
+                 dimensions.end();
+    num_tiles_ = empty ? 0 : num_outer * row_tiles_ * col_tiles_;
+  }
+
+  int64_t num_tiles() const { return num_tiles_; }
+
+  // The strides between the elements of the rows handed to ForEachRow().
+  int64_t row_src_stride() const { return row_src_stride_; }
+  int64_t row_dest_stride() const { return row_dest_stride_; }
+
+  // Calls copy_row(dest_offset, src_offset, n) for each row of the tiles
+  // within [begin, end), where the offsets are the ones of the first element
+  // of the row, and n its number of elements.
+  template <typename F>
+  void ForEachRow(int64_t begin, int64_t end, const F& copy_row) const {
+    for (int64_t tile = begin; tile < end; ++tile) {
+      int64_t index = tile;
+      int64_t row_start = (index % row_tiles_) * row_tile_size_;
+      index /= row_tiles_;
+      int64_t col_start = (index % col_tiles_) * col_tile_size_;
+      index /= col_tiles_;
+      int64_t src_offset =
+          row_start * row_src_stride_ + col_start * col_src_stride_;
+      int64_t dest_offset =
+          row_start * row_dest_stride_ + col_start * col_dest_stride_;
+      for (int64_t i = outer_sizes_.size() - 1; i >= 0; --i) {
+        int64_t outer_index = index % outer_sizes_[i];
+        index /= outer_sizes_[i];
+        src_offset += outer_index * outer_src_strides_[i];
+        dest_offset += outer_index * outer_dest_strides_[i];
+      }
+      int64_t row_length = std::min(row_tile_size_, row_size_ - row_start);
+      int64_t col_end = std::min(col_start + col_tile_size_, col_size_);
+      for (int64_t col = col_start; col < col_end; ++col) {
+        copy_row(dest_offset, src_offset, row_length);
+        src_offset += col_src_stride_;
+        dest_offset += col_dest_stride_;
+      }
+    }
+  }
+
+ private:
+  // Returns the dimension with the smallest stride among the non degenerate
+  // ones, other than exclude_dim, or -1 if there is none.
+  static int64_t MinorDimension(absl::Span<const int64_t> dimensions,
+                                absl::Span<const int64_t> strides,
+                                int64_t exclude_dim) {
+    int64_t minor_dim = -1;
+    for (int64_t dim = 0; dim < dimensions.size(); ++dim) {
+      if (dim != exclude_dim && dimensions[dim] > 1 &&
+          (minor_dim < 0 || strides[dim] < strides[minor_dim])) {
+        minor_dim = dim;
+      }
+    }
+    return minor_dim;
+  }
+
+  int64_t row_size_ = 1;
+  int64_t row_src_stride_ = 0;
+  int64_t row_dest_stride_ = 0;
+  int64_t col_size_ = 1;
+  int64_t col_src_stride_ = 0;
+  int64_t col_dest_stride_ = 0;
+  std::vector<int64_t> outer_sizes_;
+  std::vector<int64_t> outer_src_strides_;
+  std::vector<int64_t> outer_dest_strides_;
+  int64_t row_tile_size_ = 1;
+  int64_t col_tile_size_ = 1;
+  int64_t row_tiles_ = 1;
+  int64_t col_tiles_ = 1;
+  int64_t num_tiles_ = 0;
+};
+
+}  // namespace runtime
+}  // namespace torch_xla
+
+#endif  // XLA_CLIENT_TILED_COPY_H_
@@ -0,0 +1,122 @@
+#include "torch_xla/csrc/runtime/tiled_copy.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace torch_xla {
+namespace runtime {
+namespace {
+
+// Computes the element strides of a dense layout, given its minor to major
+// dimension order.
+std::vector<int64_t> Strides(const std::vector<int64_t>& dimensions,
+                             const std::vector<int64_t>& minor_to_major) {
+  std::vector<int64_t> strides(dimensions.size());
+  int64_t stride = 1;
+  for (int64_t dim : minor_to_major) {
+    strides[dim] = stride;
+    stride *= dimensions[dim];
+  }
+  return strides;
+}
+
+// Copies with the plan, splitting the tiles in a few ranges, and checks that
+// every element lands where the destination layout expects it.
+void CheckCopy(const std::vector<int64_t>& dimensions,
+               const std::vector<int64_t>& src_minor_to_major,
+               const std::vector<int64_t>& dest_minor_to_major,
+               int64_t tile_size) {
+  std::vector<int64_t> src_strides = Strides(dimensions, src_minor_to_major);
+  std::vector<int64_t> dest_strides = Strides(dimensions, dest_minor_to_major);
+  int64_t num_elements = std::accumulate(dimensions.begin(), dimensions.end(),
+                                         int64_t{1}, std::multiplies<>());
+  std::vector<int64_t> src(num_elements);
+  std::iota(src.begin(), src.end(), 0);
+  std::vector<int64_t> dest(num_elements, -1);
+
+  TiledCopyPlan plan(dimensions, src_strides, dest_strides, tile_size);
+  int64_t num_tiles = plan.num_tiles();
+  int64_t ranges = std::min<int64_t>(num_tiles, 3);
+  for (int64_t r = 0; r < ranges; ++r) {
+    plan.ForEachRow(num_tiles * r / ranges, num_tiles * (r + 1) / ranges,
+                    [&](int64_t dest_offset, int64_t src_offset, int64_t n) {
+                      for (int64_t i = 0; i < n; ++i) {
+                        dest[dest_offset + i * plan.row_dest_stride()] =
+                            src[src_offset + i * plan.row_src_stride()];
+                      }
+                    });
+  }
+
+  std::vector<int64_t> indices(dimensions.size(), 0);
+  for (int64_t n = 0; n < num_elements; ++n) {
+    int64_t src_offset = 0;
+    int64_t dest_offset = 0;
+    for (size_t i = 0; i < indices.size(); ++i) {
+      src_offset += indices[i] * src_strides[i];
+      dest_offset += indices[i] * dest_strides[i];
+    }
+    ASSERT_EQ(dest[dest_offset], src[src_offset]) << "at element " << n;
+    for (int64_t i = indices.size() - 1; i >= 0; --i) {
+      if (++indices[i] < dimensions[i]) {
+        break;
+      }
+      indices[i] = 0;
+    }
+  }
+}
+
+TEST(TiledCopyPlanTest, Transpose2D) {
+  CheckCopy({37, 70}, {1, 0}, {0, 1}, /*tile_size=*/16);
+  CheckCopy({64, 64}, {0, 1}, {1, 0}, /*tile_size=*/32);
+}
+
+TEST(TiledCopyPlanTest, ChannelsLast) {
+  // NCHW to NHWC and back.
+  CheckCopy({2, 3, 17, 19}, {3, 2, 1, 0}, {1, 3, 2, 0}, /*tile_size=*/8);
+  CheckCopy({2, 3, 17, 19}, {1, 3, 2, 0}, {3, 2, 1, 0}, /*tile_size=*/8);
+}
+
+TEST(TiledCopyPlanTest, SameMinorDimension) {
+  CheckCopy({5, 6, 40}, {2, 1, 0}, {2, 0, 1}, /*tile_size=*/16);
+}
+
+TEST(TiledCopyPlanTest, DegenerateDimensions) {
+  CheckCopy({1, 9, 1, 13}, {3, 2, 1, 0}, {1, 0, 3, 2}, /*tile_size=*/4);
+  CheckCopy({1, 1}, {0, 1}, {1, 0}, /*tile_size=*/4);
+  CheckCopy({1, 7}, {0, 1}, {1, 0}, /*tile_size=*/4);
+}
+
+TEST(TiledCopyPlanTest, EmptyArray) {
+  std::vector<int64_t> dimensions = {0, 5};
+  TiledCopyPlan plan(dimensions, Strides(dimensions, {0, 1}),
+                     Strides(dimensions, {1, 0}), /*tile_size=*/4);
+  EXPECT_EQ(plan.num_tiles(), 0);
+}
+
+TEST(TiledCopyPlanTest, RandomLayouts) {
+  std::mt19937 gen(11);
+  for (int iteration = 0; iteration < 50; ++iteration) {
+    int64_t rank = 2 + iteration % 4;
+    std::vector<int64_t> dimensions(rank);
+    for (int64_t& size : dimensions) {
+      size = std::uniform_int_distribution<int64_t>(1, 9)(gen);
+    }
+    std::vector<int64_t> src_minor_to_major(rank);
+    std::iota(src_minor_to_major.begin(), src_minor_to_major.end(), 0);
+    std::vector<int64_t> dest_minor_to_major = src_minor_to_major;
+    std::shuffle(src_minor_to_major.begin(), src_minor_to_major.end(), gen);
+    std::shuffle(dest_minor_to_major.begin(), dest_minor_to_major.end(), gen);
+    CheckCopy(dimensions, src_minor_to_major, dest_minor_to_major,
+              /*tile_size=*/1 + iteration % 5);
+  }
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace torch_xla
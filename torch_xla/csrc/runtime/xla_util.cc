@@ -21,17 +21,40 @@ namespace runtime {
 namespace util {
 namespace {
 
-torch::lazy::hash_t SingleShapeHash(const xla::Shape& shape,
-                                    torch::lazy::hash_t seed) {
-  if (shape.has_layout()) {
-    for (auto dim : shape.layout().minor_to_major()) {
-      seed = torch::lazy::HashCombine(seed, dim);
+torch::lazy::hash_t ShapeHash(const xla::Shape& shape, bool hash_layout,
+                              torch::lazy::hash_t seed) {
+  seed = torch::lazy::HashCombine(seed, static_cast<int>(shape.element_type()));
+  if (shape.IsTuple()) {
+    // Hashing the arity keeps ((a, b), c) and ((a), b, c) apart.
+    seed = torch::lazy::HashCombine(seed, shape.tuple_shapes_size());
+    for (const xla::Shape& subshape : shape.tuple_shapes()) {
+      seed = ShapeHash(subshape, hash_layout, seed);
+    }
+    return seed;
+  }
+  uint64_t dynamic_dimensions = 0;
+  for (int64_t i = 0; i < shape.dimensions_size(); ++i) {
+    seed = torch::lazy::HashCombine(seed, shape.dimensions(i));
+    if (shape.is_dynamic_dimension(i)) {
+      dynamic_dimensions |= uint64_t{1} << (i % 64);
     }
   }
-  for (auto dim : shape.dimensions()) {
+  seed = torch::lazy::HashCombine(seed, dynamic_dimensions);
+  if (!hash_layout || !shape.has_layout()) {
+    return seed;
+  }
+  const xla::Layout& layout = shape.layout();
+  seed = torch::lazy::HashCombine(seed, layout.minor_to_major_size());
+  for (int64_t dim : layout.minor_to_major()) {
     seed = torch::lazy::HashCombine(seed, dim);
   }
-  return torch::lazy::HashCombine(seed, static_cast<int>(shape.element_type()));
+  for (const xla::Tile& tile : layout.tiles()) {
+    for (int64_t dim : tile.dimensions()) {
+      seed = torch::lazy::HashCombine(seed, dim);
+    }
+  }
+  seed = torch::lazy::HashCombine(seed, layout.element_size_in_bits());
+  return torch::lazy::HashCombine(seed, layout.memory_space());
 }
 
 void MaybeSaveHloGraph(const std::string& hlo_text, size_t index) {
@@ -106,13 +129,8 @@ void CheckComputationStatus(
   }
 }
 
-torch::lazy::hash_t ShapeHash(const xla::Shape& shape) {
-  torch::lazy::hash_t hash = 0xa5d2d6916;
-  xla::ShapeUtil::ForEachSubshape(
-      shape, [&](const xla::Shape& subshape, const xla::ShapeIndex&) {
-        hash = SingleShapeHash(subshape, hash);
-      });
-  return hash;
+torch::lazy::hash_t ShapeHash(const xla::Shape& shape, bool hash_layout) {
+  return ShapeHash(shape, hash_layout, 0xa5d2d6916);
 }
 
 }  // namespace util
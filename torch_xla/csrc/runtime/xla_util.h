@@ -37,7 +37,10 @@ void CheckComputationStatus(
     absl::Span<const xla::XlaComputation* const> computations,
     absl::Span<const xla::Shape* const> output_shapes);
 
-torch::lazy::hash_t ShapeHash(const xla::Shape& shape);
+// Hashes the structure of the shape: the element type and the tuple arity,
+// the dimensions and which of them are dynamic, and the layout if hash_layout
+// is set. Unlike hashing shape.ToString(), this does not allocate.
+torch::lazy::hash_t ShapeHash(const xla::Shape& shape, bool hash_layout = true);
 
 }  // namespace util
 }  // namespace runtime
@@ -32,6 +32,46 @@ TEST(XlaUtilTest, ShapeHash) {
   EXPECT_EQ(ShapeHash(shape), ShapeHash(shape));
 }
 
+TEST(XlaUtilTest, ShapeHashIsStructural) {
+  xla::Shape f32 = xla::ShapeUtil::MakeShape(xla::PrimitiveType::F32, {2, 3});
+  xla::Shape s32 = xla::ShapeUtil::MakeShape(xla::PrimitiveType::S32, {2, 3});
+  xla::Shape dynamic =
+      xla::ShapeUtil::MakeShape(xla::PrimitiveType::F32, {2, 3}, {false, true});
+  xla::Shape transposed =
+      xla::ShapeUtil::MakeShapeWithDenseLayout(xla::PrimitiveType::F32, {2, 3},
+                                               /*minor_to_major=*/{0, 1});
+  xla::Shape scalar = xla::ShapeUtil::MakeShape(xla::PrimitiveType::F32, {});
+  xla::Shape nested = xla::ShapeUtil::MakeTupleShape(
+      {xla::ShapeUtil::MakeTupleShape({f32, s32}), scalar});
+  xla::Shape flat = xla::ShapeUtil::MakeTupleShape(
+      {xla::ShapeUtil::MakeTupleShape({f32}), s32, scalar});
+
+  std::vector<xla::Shape> shapes = {f32,    s32,    dynamic, transposed,
+                                    scalar, nested, flat};
+  std::set<torch::lazy::hash_t> hashes;
+  for (const xla::Shape& shape : shapes) {
+    hashes.insert(ShapeHash(shape));
+    // Equal shapes hash the same, however they were built.
+    xla::Shape copy = xla::Shape(shape.ToProto());
+    EXPECT_EQ(ShapeHash(shape), ShapeHash(copy)) << shape;
+  }
+  EXPECT_EQ(hashes.size(), shapes.size());
+}
+
+TEST(XlaUtilTest, ShapeHashWithoutLayout) {
+  xla::Shape row_major = xla::ShapeUtil::MakeShapeWithDenseLayout(
+      xla::PrimitiveType::F32, {2, 3}, /*minor_to_major=*/{1, 0});
+  xla::Shape column_major = xla::ShapeUtil::MakeShapeWithDenseLayout(
+      xla::PrimitiveType::F32, {2, 3}, /*minor_to_major=*/{0, 1});
+  xla::Shape other = xla::ShapeUtil::MakeShapeWithDenseLayout(
+      xla::PrimitiveType::F32, {3, 2}, /*minor_to_major=*/{1, 0});
+  EXPECT_NE(ShapeHash(row_major), ShapeHash(column_major));
+  EXPECT_EQ(ShapeHash(row_major, /*hash_layout=*/false),
+            ShapeHash(column_major, /*hash_layout=*/false));
+  EXPECT_NE(ShapeHash(row_major, /*hash_layout=*/false),
+            ShapeHash(other, /*hash_layout=*/false));
+}
+
 template <typename MessageType>
 xla::StatusOr<MessageType> ParseTextProto(const std::string& text_proto) {
   tsl::protobuf::TextFormat::Parser parser;
@@ -0,0 +1,173 @@
+#include "torch_xla/csrc/step_timeline.h"
+
+#include <sstream>
+
+#include "torch_xla/csrc/runtime/sys_util.h"
+
+namespace torch_xla {
+namespace {
+
+thread_local std::shared_ptr<StepRecord> current_step;
+
+enum ChromeTraceThread { kStepsThread = 0, kTracingThread, kExecutionThread };
+
+bool IsExecutionPhase(StepPhase phase) {
+  return phase == StepPhase::kAsyncCompileWait || phase == StepPhase::kExecute;
+}
+
+void EmitThreadName(int tid, const char* name, std::stringstream* ss) {
+  (*ss) << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << tid
+        << ",\"args\":{\"name\":\"" << name << "\"}},\n";
+}
+
+void EmitEvent(const char* name, int tid, int64_t start_ns, int64_t end_ns,
+               std::stringstream* ss) {
+  (*ss) << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+        << tid << ",\"ts\":" << start_ns / 1000.0
+        << ",\"dur\":" << (end_ns - start_ns) / 1000.0;
+}
+
+}  // namespace
+
+const char* StepPhaseName(StepPhase phase) {
+  switch (phase) {
+    case StepPhase::kCollectSyncTensors:
+      return "CollectSyncTensors";
+    case StepPhase::kPrepareData:
+      return "ExtractIRAndPrepareXlaData";
+    case StepPhase::kPostOrder:
+      return "RunPostOrder";
+    case StepPhase::kCompile:
+      return "Compile";
+    case StepPhase::kTensorCollectionBarrier:
+      return "TensorCollectionBarrier";
+    case StepPhase::kAsyncCompileWait:
+      return "AsyncCompileWait";
+    case StepPhase::kExecute:
+      return "ExecuteComputation";
+    default:
+      return "Unknown";
+  }
+}
+
+StepTimeline* StepTimeline::Get() {
+  static StepTimeline* timeline = new StepTimeline(
+      runtime::sys_util::GetEnvInt("XLA_STEP_TIMELINE_SIZE", 256));
+  return timeline;
+}
+
+StepTimeline::StepTimeline(size_t capacity) : capacity_(capacity) {}
+
+std::shared_ptr<StepRecord> StepTimeline::NewStep() {
+  StepRecord* record = new StepRecord();
+  record->start_ns = runtime::sys_util::NowNs();
+  return std::shared_ptr<StepRecord>(record, [this](StepRecord* record) {
+    Add(record);
+    delete record;
+  });
+}
+
+void StepTimeline::Add(StepRecord* record) {
+  record->end_ns = runtime::sys_util::NowNs();
+  // Syncs which found no pending IR to execute are not steps.
+  if (capacity_ == 0 || record->node_count == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(lock_);
+  record->step_id = next_step_id_++;
+  if (steps_.size() < capacity_) {
+    steps_.push_back(std::move(*record));
+  } else {
+    steps_[count_ % capacity_] = std::move(*record);
+  }
+  ++count_;
+}
+
+std::vector<StepRecord> StepTimeline::GetSteps() {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (count_ <= capacity_) {
+    return steps_;
+  }
+  size_t position = count_ % capacity_;
+  std::vector<StepRecord> steps(steps_.begin() + position, steps_.end());
+  steps.insert(steps.end(), steps_.begin(), steps_.begin() + position);
+  return steps;
+}
+
+void StepTimeline::Clear() {
+  std::lock_guard<std::mutex> lock(lock_);
+  steps_.clear();
+  count_ = 0;
+}
+
+std::string StepTimeline::ToChromeTrace(const std::vector<StepRecord>& steps) {
+  std::stringstream ss;
+  // Timestamps are in microseconds, keep them to the nanosecond.
+  ss.precision(3);
+  ss << std::fixed << "{\"traceEvents\":[\n";
+  EmitThreadName(kStepsThread, "Steps", &ss);
+  EmitThreadName(kTracingThread, "Tracing", &ss);
+  EmitThreadName(kExecutionThread, "Execution", &ss);
+  for (const StepRecord& step : steps) {
+    EmitEvent("Step", kStepsThread, step.start_ns, step.end_ns, &ss);
+    ss << ",\"args\":{\"step_id\":" << step.step_id << ",\"device\":\""
+       << step.device << "\",\"graph_hash\":\""
+       << torch::lazy::HashToString(step.graph_hash)
+       << "\",\"node_count\":" << step.node_count
+       << ",\"parameter_count\":" << step.parameter_count
+       << ",\"parameter_bytes\":" << step.parameter_bytes
+       << ",\"cache_hit\":" << (step.cache_hit ? "true" : "false") << "}},\n";
+    for (size_t i = 0; i < StepRecord::kNumPhases; ++i) {
+      if (step.phase_start_ns[i] == 0 || step.phase_end_ns[i] == 0) {
+        continue;
+      }
+      StepPhase phase = static_cast<StepPhase>(i);
+      EmitEvent(StepPhaseName(phase),
+                IsExecutionPhase(phase) ? kExecutionThread : kTracingThread,
+                step.phase_start_ns[i], step.phase_end_ns[i], &ss);
+      ss << ",\"args\":{\"step_id\":" << step.step_id
+         << ",\"duration_us\":" << step.phase_duration_ns[i] / 1000.0
+         << "}},\n";
+    }
+  }
+  // Chrome accepts a trailing comma, but other JSON readers do not.
+  ss << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+     << "\"args\":{\"name\":\"XLAGraphExecutor\"}}\n]}\n";
+  return ss.str();
+}
+
+StepRecord* StepTimeline::CurrentStep() { return current_step.get(); }
+
+const std::shared_ptr<StepRecord>& StepTimeline::CurrentStepPtr() {
+  return current_step;
+}
+
+StepScope::StepScope(std::shared_ptr<StepRecord> step)
+    : previous_(std::move(current_step)) {
+  current_step = std::move(step);
+}
+
+StepScope::~StepScope() { current_step = std::move(previous_); }
+
+StepPhaseTimer::StepPhaseTimer(StepRecord* step, StepPhase phase)
+    : step_(step), phase_(static_cast<size_t>(phase)) {
+  if (step_ != nullptr) {
+    start_ns_ = runtime::sys_util::NowNs();
+    if (step_->phase_start_ns[phase_] == 0) {
+      step_->phase_start_ns[phase_] = start_ns_;
+    }
+  }
+}
+
+StepPhaseTimer::~StepPhaseTimer() { Stop(); }
+
+void StepPhaseTimer::Stop() {
+  if (step_ != nullptr) {
+    int64_t end_ns = runtime::sys_util::NowNs();
+    step_->phase_end_ns[phase_] = end_ns;
+    step_->phase_duration_ns[phase_] += end_ns - start_ns_;
+    step_ = nullptr;
+  }
+}
+
+}  // namespace torch_xla
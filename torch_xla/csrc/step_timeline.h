@@ -0,0 +1,121 @@
+#ifndef XLA_TORCH_XLA_CSRC_STEP_TIMELINE_H_
+#define XLA_TORCH_XLA_CSRC_STEP_TIMELINE_H_
+
+#include <torch/csrc/lazy/core/hash.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace torch_xla {
+
+// The phases of a graph execution, as run by
+// XLAGraphExecutor::SyncTensorsGraphInternal(). kAsyncCompileWait and kExecute
+// run on the execution thread, all the others on the tracing thread.
+enum class StepPhase {
+  kCollectSyncTensors,
+  kPrepareData,
+  kPostOrder,
+  kCompile,
+  kTensorCollectionBarrier,
+  kAsyncCompileWait,
+  kExecute,
+  kNumPhases,
+};
+
+const char* StepPhaseName(StepPhase phase);
+
+// What happened during one graph execution. Timestamps are sys_util::NowNs()
+// values, zero for the phases the step did not go through. A phase entered more
+// than once by a step, like the TensorCollectionBarrier, spans from its first
+// start to its last end, and its duration sums the time of each entry.
+struct StepRecord {
+  static constexpr size_t kNumPhases =
+      static_cast<size_t>(StepPhase::kNumPhases);
+
+  int64_t step_id = 0;
+  std::string device;
+  torch::lazy::hash_t graph_hash;
+  size_t node_count = 0;
+  size_t parameter_count = 0;
+  // Bytes of the parameters handed to the computation.
+  int64_t parameter_bytes = 0;
+  bool cache_hit = false;
+  int64_t start_ns = 0;
+  int64_t end_ns = 0;
+  std::array<int64_t, kNumPhases> phase_start_ns{};
+  std::array<int64_t, kNumPhases> phase_end_ns{};
+  std::array<int64_t, kNumPhases> phase_duration_ns{};
+};
+
+// Ring buffer of the records of the latest XLA_STEP_TIMELINE_SIZE graph
+// executions, to find out where the time of host bound steps goes.
+class StepTimeline {
+ public:
+  static StepTimeline* Get();
+
+  explicit StepTimeline(size_t capacity);
+
+  // Returns a new record. It is added to the timeline, stamped with its end
+  // time, when the last reference to it goes away, which for executed graphs
+  // happens on the execution thread once the computation has run. Records
+  // with no nodes are dropped.
+  std::shared_ptr<StepRecord> NewStep();
+
+  // Returns the retained records, from the oldest to the newest.
+  std::vector<StepRecord> GetSteps();
+
+  void Clear();
+
+  // Renders the records as Chrome trace events (chrome://tracing, Perfetto).
+  static std::string ToChromeTrace(const std::vector<StepRecord>& steps);
+
+  // The step being traced by the calling thread, or nullptr.
+  static StepRecord* CurrentStep();
+
+  static const std::shared_ptr<StepRecord>& CurrentStepPtr();
+
+ private:
+  void Add(StepRecord* record);
+
+  const size_t capacity_;
+  std::mutex lock_;
+  std::vector<StepRecord> steps_;
+  size_t count_ = 0;
+  int64_t next_step_id_ = 0;
+};
+
+// Makes a step the current one of the calling thread while in scope.
+class StepScope {
+ public:
+  explicit StepScope(std::shared_ptr<StepRecord> step);
+
+  ~StepScope();
+
+ private:
+  std::shared_ptr<StepRecord> previous_;
+};
+
+// Stamps the start and the end of a phase on a step, if any, and adds the time
+// in between to the duration of the phase.
+class StepPhaseTimer {
+ public:
+  StepPhaseTimer(StepRecord* step, StepPhase phase);
+
+  ~StepPhaseTimer();
+
+  // Stamps the end of the phase now rather than when going out of scope.
+  void Stop();
+
+ private:
+  StepRecord* step_;
+  size_t phase_;
+  int64_t start_ns_ = 0;
+};
+
+}  // namespace torch_xla
+
+#endif  // XLA_TORCH_XLA_CSRC_STEP_TIMELINE_H_
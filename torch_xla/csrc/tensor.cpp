@@ -21,6 +21,7 @@
 
 #include "torch_xla/csrc/aten_xla_bridge.h"
 #include "torch_xla/csrc/debug_util.h"
+#include "torch_xla/csrc/device_constant_pool.h"
 #include "torch_xla/csrc/dtype.h"
 #include "torch_xla/csrc/helpers.h"
 #include "torch_xla/csrc/layout_manager.h"
@@ -388,8 +389,11 @@ torch::lazy::Value XLATensor::GetIrValue() const {
     // same IR node, and not create new ones (even though the lowering context
     // will still collapse them all into a single XLA parameter op). So call
     // which wants the XLA data will still find it, w/out having to fetch it
-    // via a computation client from-server call.
-    AssignIrValue(CreateTensorNode(handle, /*read_only=*/false));
+    // via a computation client from-server call. Shared data keeps its info,
+    // as the tensor does not own it.
+    AssignIrValue(IsSharedDeviceData(handle)
+                      ? torch::lazy::MakeNode<DeviceData>(handle)
+                      : CreateTensorNode(handle, /*read_only=*/false));
     return data()->ir_value;
   }
   std::optional<at::Tensor> tensor_data = CurrentTensorData();
@@ -415,21 +419,37 @@ std::optional<at::Tensor> XLATensor::CurrentTensorData() const {
 
 torch::lazy::Value XLATensor::GetIrValueForTensor(
     const at::Tensor& tensor, const torch::lazy::BackendDevice& device) const {
-  torch::lazy::BackendDataPtr data;
-  bool read_only = false;
-  if (tensor.dim() == 0 && tensor.numel() == 1) {
+  static const int64_t inline_constant_max_elements =
+      runtime::sys_util::GetEnvInt("XLA_INLINE_CONSTANT_MAX_ELEMENTS", 0);
+  bool is_scalar = tensor.dim() == 0 && tensor.numel() == 1;
+  if (is_scalar) {
     at::Scalar value = tensor.item();
     if (torch::lazy::IsSpecialScalar(value)) {
       return ScalarOp(std::move(value),
                       MakeXlaPrimitiveType(tensor.scalar_type(), &device));
     }
-    data = XLAGraphExecutor::Get()->GetDeviceData(tensor.cpu(), device);
-    read_only = true;
-  } else {
-    TORCH_LAZY_TIMED("IrValueTensorToXlaData");
-    data = TensorToXlaData(tensor, device);
   }
-  return CreateTensorNode(std::move(data), read_only);
+  if (tensor.numel() > 0 && tensor.numel() <= inline_constant_max_elements) {
+    // The value becomes part of the graph, and of its hash.
+    TORCH_LAZY_COUNTER("InlinedConstant", 1);
+    return ConstantOp(GetTensorLiteral(tensor, /*shape=*/nullptr, &device));
+  }
+  DeviceConstantPool* constant_pool = DeviceConstantPool::Get();
+  if (constant_pool->IsPoolable(tensor)) {
+    return torch::lazy::MakeNode<DeviceData>(
+        constant_pool->GetDeviceData(tensor.cpu(), device));
+  }
+  if (is_scalar) {
+    // The data comes from the scalar data cache and is shared, so it must not
+    // be tied to the ID of this tensor.
+    torch::lazy::BackendDataPtr data =
+        XLAGraphExecutor::Get()->GetDeviceData(tensor.cpu(), device);
+    MarkSharedDeviceData(data);
+    return torch::lazy::MakeNode<DeviceData>(std::move(data));
+  }
+  TORCH_LAZY_TIMED("IrValueTensorToXlaData");
+  return CreateTensorNode(TensorToXlaData(tensor, device),
+                          /*read_only=*/false);
 }
 
 View::IrNode XLATensor::GetViewUpdate(const std::shared_ptr<View>& view) const {
@@ -168,7 +168,7 @@ torch::lazy::Value MaybeExpand(const torch::lazy::Value& input,
   if (GetXlaShape(input).dimensions() == target_shape.dimensions()) {
     return input;
   }
-  return torch::lazy::MakeNode<Expand>(
+  return MakeXlaNode<Expand>(
       input, torch::lazy::ToVector<int64_t>(target_shape.dimensions()));
 }
 
@@ -287,7 +287,7 @@ torch::lazy::Value GetFloatingIrValue(const XLATensorPtr& input,
   xla::PrimitiveType input_type = GetXlaShape(input_value).element_type();
   if (xla::primitive_util::IsIntegralType(input_type) ||
       input_type == xla::PRED) {
-    input_value = torch::lazy::MakeNode<Cast>(input_value, float_type);
+    input_value = MakeXlaNode<Cast>(input_value, float_type);
   }
   return input_value;
 }
@@ -295,7 +295,7 @@ torch::lazy::Value GetFloatingIrValue(const XLATensorPtr& input,
 torch::lazy::Value GetBooleanIrValue(torch::lazy::Value input_value) {
   if (GetXlaShape(input_value).element_type() != xla::PrimitiveType::PRED) {
     input_value =
-        torch::lazy::MakeNode<Cast>(input_value, xla::PrimitiveType::PRED);
+        MakeXlaNode<Cast>(input_value, xla::PrimitiveType::PRED);
   }
   return input_value;
 }
@@ -350,7 +350,7 @@ XLATensorPtr all_reduce(const XLATensorPtr& input, AllReduceType reduce_type,
                         double scale, std::vector<std::vector<int64_t>> groups,
                         bool pin_layout) {
   std::vector<torch::lazy::Value> input_values({input->GetIrValue()});
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllReduce>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllReduce>(
       reduce_type, input_values, GetAllReduceToken(input->GetDevice()), scale,
       std::move(groups), pin_layout);
   SetAllReduceToken(input->GetDevice(),
@@ -366,7 +366,7 @@ void all_reduce(const std::vector<XLATensorPtr>& inputs,
   for (auto& input : inputs) {
     input_values.push_back(input->GetIrValue());
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllReduce>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllReduce>(
       reduce_type, input_values, GetAllReduceToken(inputs.front()->GetDevice()),
       scale, std::move(groups), pin_layout);
   for (size_t i = 0; i < inputs.size(); ++i) {
@@ -395,7 +395,7 @@ void all_reduce(const std::vector<XLATensorPtr>& inputs,
 XLATensorPtr all_reduce(const XLATensorPtr& input, AllReduceType reduce_type,
                         double scale,
                         std::vector<std::vector<int64_t>> groups) {
-  return input->CreateFrom(torch::lazy::MakeNode<AllReduce>(
+  return input->CreateFrom(MakeXlaNode<AllReduce>(
       reduce_type, input->GetIrValue(), scale, std::move(groups)));
 }
 
@@ -404,7 +404,7 @@ std::pair<XLATensorPtr, torch::lazy::Value> reduce_scatter(
     AllReduceType reduce_type, double scale, int64_t scatter_dim,
     int64_t shard_count, std::vector<std::vector<int64_t>> groups,
     bool pin_layout) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<ReduceScatter>(
+  torch::lazy::NodePtr node = MakeXlaNode<ReduceScatter>(
       reduce_type, input->GetIrValue(), token, scale, scatter_dim, shard_count,
       std::move(groups), pin_layout);
   return {input->CreateFrom(torch::lazy::Value(node, 0)),
@@ -417,7 +417,7 @@ XLATensorPtr reduce_scatter(const XLATensorPtr& input,
                             std::vector<std::vector<int64_t>> groups) {
   auto canonical_scatter_dim = torch::lazy::GetCanonicalDimensionIndex(
       scatter_dim, input->shape().get().rank());
-  return input->CreateFrom(torch::lazy::MakeNode<ReduceScatter>(
+  return input->CreateFrom(MakeXlaNode<ReduceScatter>(
       reduce_type, input->GetIrValue(), scale, canonical_scatter_dim,
       shard_count, std::move(groups)));
 }
@@ -429,7 +429,7 @@ torch::lazy::Value reduce_scatter_out(XLATensorPtr& output,
                                       int64_t scatter_dim, int64_t shard_count,
                                       std::vector<std::vector<int64_t>> groups,
                                       bool pin_layout) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<ReduceScatter>(
+  torch::lazy::NodePtr node = MakeXlaNode<ReduceScatter>(
       reduce_type, input->GetIrValue(), token, scale, scatter_dim, shard_count,
       std::move(groups), pin_layout);
   output->SetIrValue(torch::lazy::Value(node, 0));
@@ -448,7 +448,7 @@ reduce_scatter_coalesced(const std::vector<XLATensorPtr>& inputs,
   for (auto& input : inputs) {
     input_values.push_back(input->GetIrValue());
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<ReduceScatterCoalesced>(
+  torch::lazy::NodePtr node = MakeXlaNode<ReduceScatterCoalesced>(
       reduce_type, input_values, token, scale, scatter_dim, shard_count,
       std::move(groups), pin_layout);
   std::vector<XLATensorPtr> result;
@@ -469,7 +469,7 @@ torch::lazy::Value reduce_scatter_coalesced_out(
   for (auto& input : inputs) {
     input_values.push_back(input->GetIrValue());
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<ReduceScatterCoalesced>(
+  torch::lazy::NodePtr node = MakeXlaNode<ReduceScatterCoalesced>(
       reduce_type, input_values, token, scale, scatter_dim, shard_count,
       std::move(groups), pin_layout);
   for (size_t i = 0; i < inputs.size(); ++i) {
@@ -482,7 +482,7 @@ std::pair<XLATensorPtr, torch::lazy::Value> all_to_all(
     const XLATensorPtr& input, const torch::lazy::Value& token,
     int64_t split_dimension, int64_t concat_dimension, int64_t split_count,
     std::vector<std::vector<int64_t>> groups, bool pin_layout) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllToAll>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllToAll>(
       input->GetIrValue(), token, split_dimension, concat_dimension,
       split_count, std::move(groups), pin_layout);
   return {input->CreateFrom(torch::lazy::Value(node, 0)),
@@ -493,7 +493,7 @@ XLATensorPtr all_gather(const XLATensorPtr& input, int64_t dim,
                         int64_t shard_count,
                         std::vector<std::vector<int64_t>> groups,
                         bool pin_layout) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllGather>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllGather>(
       input->GetIrValue(), GetAllReduceToken(input->GetDevice()), dim,
       shard_count, std::move(groups), pin_layout);
   SetAllReduceToken(input->GetDevice(),
@@ -507,7 +507,7 @@ torch::lazy::Value all_gather_out(XLATensorPtr& output,
                                   int64_t shard_count,
                                   std::vector<std::vector<int64_t>> groups,
                                   bool pin_layout) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllGather>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllGather>(
       input->GetIrValue(), token, dim, shard_count, std::move(groups),
       pin_layout);
   output->SetIrValue(torch::lazy::Value(node, 0));
@@ -523,7 +523,7 @@ std::pair<std::vector<XLATensorPtr>, torch::lazy::Value> all_gather_coalesced(
   for (auto& input : inputs) {
     input_values.push_back(input->GetIrValue());
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllGatherCoalesced>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllGatherCoalesced>(
       input_values, token, dim, shard_count, std::move(groups), pin_layout);
   std::vector<XLATensorPtr> result;
   for (size_t i = 0; i < inputs.size(); ++i) {
@@ -541,7 +541,7 @@ torch::lazy::Value all_gather_coalesced_out(
   for (auto& input : inputs) {
     input_values.push_back(input->GetIrValue());
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AllGatherCoalesced>(
+  torch::lazy::NodePtr node = MakeXlaNode<AllGatherCoalesced>(
       input_values, token, dim, shard_count, std::move(groups), pin_layout);
   for (size_t i = 0; i < inputs.size(); ++i) {
     outputs[i]->SetIrValue(torch::lazy::Value(node, i));
@@ -552,7 +552,7 @@ torch::lazy::Value all_gather_coalesced_out(
 std::pair<XLATensorPtr, torch::lazy::Value> collective_permute(
     const XLATensorPtr& input, const torch::lazy::Value& token,
     std::vector<std::pair<int64_t, int64_t>> source_target_pairs) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<CollectivePermute>(
+  torch::lazy::NodePtr node = MakeXlaNode<CollectivePermute>(
       input->GetIrValue(), token, std::move(source_target_pairs));
   return {input->CreateFrom(torch::lazy::Value(node, 0)),
           torch::lazy::Value(node, 1)};
@@ -580,7 +580,7 @@ std::vector<XLATensorPtr> custom_call(
         output_shapes[i]));
   }
 
-  auto node = torch::lazy::MakeNode<CustomCall>(
+  auto node = MakeXlaNode<CustomCall>(
       values, target, xla::ShapeUtil::MakeTupleShape(output_xla_shapes),
       has_side_effect, backend_config, api_version);
 
@@ -597,7 +597,7 @@ void custom_sharding_(
     const XLATensorPtr& input,
     const std::shared_ptr<XLATensor::ShardingSpec>& sharding_spec,
     const CustomSharding::Type& type) {
-  input->SetInPlaceIrValue(torch::lazy::MakeNode<CustomSharding>(
+  input->SetInPlaceIrValue(MakeXlaNode<CustomSharding>(
       input->GetIrValue(), input->shape().get(), type));
   input->SetShardingSpec(*sharding_spec);
 }
@@ -623,7 +623,7 @@ std::vector<XLATensorPtr> gpu_custom_call(
         output_shapes[i]));
   }
 
-  auto node = torch::lazy::MakeNode<GpuCustomCall>(
+  auto node = MakeXlaNode<GpuCustomCall>(
       values, xla::ShapeUtil::MakeTupleShape(output_xla_shapes), payload);
 
   std::vector<XLATensorPtr> outputs;
@@ -656,7 +656,7 @@ std::vector<XLATensorPtr> tpu_custom_call(
         output_shapes[i]));
   }
 
-  auto node = torch::lazy::MakeNode<TpuCustomCall>(
+  auto node = MakeXlaNode<TpuCustomCall>(
       values, xla::ShapeUtil::MakeTupleShape(output_xla_shapes), payload);
 
   std::vector<XLATensorPtr> outputs;
@@ -670,14 +670,14 @@ std::vector<XLATensorPtr> tpu_custom_call(
 
 XLATensorPtr get_dimensions_size(const XLATensorPtr& input,
                                  std::vector<int64_t> dimensions) {
-  return input->CreateFrom(torch::lazy::MakeNode<GetDimensionsSize>(
+  return input->CreateFrom(MakeXlaNode<GetDimensionsSize>(
                                input->GetIrValue(), std::move(dimensions)),
                            at::ScalarType::Int);
 }
 
 std::pair<XLATensorPtr, torch::lazy::Value> recv(
     XLATensorPtr& output, const torch::lazy::Value& token, int64_t channel_id) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<ir::ops::Recv>(
+  torch::lazy::NodePtr node = MakeXlaNode<ir::ops::Recv>(
       token, GetXlaShape(output->GetIrValue()), channel_id);
   output->SetIrValue(torch::lazy::Value(node, 0));
   return {output->CreateFrom(torch::lazy::Value(node, 0)),
@@ -687,7 +687,7 @@ std::pair<XLATensorPtr, torch::lazy::Value> recv(
 std::pair<XLATensorPtr, torch::lazy::Value> send(
     const XLATensorPtr& input, const torch::lazy::Value& token,
     int64_t channel_id) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<ir::ops::Send>(
+  torch::lazy::NodePtr node = MakeXlaNode<ir::ops::Send>(
       input->GetIrValue(), token, channel_id);
   return {input->CreateFrom(torch::lazy::Value(node, 0)),
           torch::lazy::Value(node, 1)};
@@ -709,7 +709,7 @@ void sgd_optimizer_step_(const XLATensorPtr& found_inf, XLATensorPtr& step,
   torch::lazy::Value dampening_value =
       XLAGraphExecutor::Get()->GetIrValueForScalar(dampening, param->shape(),
                                                    param->GetDevice());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<SgdOptimizerStep>(
+  torch::lazy::NodePtr node = MakeXlaNode<SgdOptimizerStep>(
       found_inf->GetIrValue(), step->GetIrValue(), param->GetIrValue(),
       buf->GetIrValue(), d_p->GetIrValue(), weight_decay_value, momentum_value,
       lr_value, dampening_value,
@@ -740,7 +740,7 @@ void adam_optimizer_step_(const XLATensorPtr& found_inf, XLATensorPtr& step,
                                                    param->GetDevice());
   torch::lazy::Value eps_value = XLAGraphExecutor::Get()->GetIrValueForScalar(
       eps, param->shape(), param->GetDevice());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AdamOptimizerStep>(
+  torch::lazy::NodePtr node = MakeXlaNode<AdamOptimizerStep>(
       found_inf->GetIrValue(), step->GetIrValue(), param->GetIrValue(),
       grad_value, exp_avg->GetIrValue(), exp_avg_sq->GetIrValue(),
       max_exp_avg_sq->GetIrValue(), beta1_value, beta2_value, lr_value,
@@ -764,7 +764,7 @@ std::vector<XLATensorPtr> user_computation(
   for (auto& input : inputs) {
     input_values.push_back(input->GetIrValue());
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<UserComputation>(
+  torch::lazy::NodePtr node = MakeXlaNode<UserComputation>(
       torch::lazy::OpKind::Get(opname), input_values, std::move(computation));
   // Cast can be one of the user computation and we don't want to inherit the
   // logical_element_type in this case
@@ -817,7 +817,7 @@ XLATensorPtr __rshift__(const XLATensorPtr& input, const XLATensorPtr& other,
 
 std::tuple<XLATensorPtr, XLATensorPtr> adaptive_max_pool2d(
     const XLATensorPtr& input, std::vector<int64_t> output_size) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AdaptiveMaxPool2d>(
+  torch::lazy::NodePtr node = MakeXlaNode<AdaptiveMaxPool2d>(
       input->GetIrValue(), output_size);
   XLATensorPtr out = input->CreateFrom(torch::lazy::Value(node, 0));
   XLATensorPtr indices =
@@ -833,13 +833,13 @@ XLATensorPtr adaptive_max_pool2d_backward(const XLATensorPtr& grad_output,
 
 XLATensorPtr _adaptive_avg_pool2d(const XLATensorPtr& input,
                                   std::vector<int64_t> output_size) {
-  return input->CreateFrom(torch::lazy::MakeNode<AdaptiveAvgPool2d>(
+  return input->CreateFrom(MakeXlaNode<AdaptiveAvgPool2d>(
       input->GetIrValue(), std::move(output_size)));
 }
 
 XLATensorPtr _adaptive_avg_pool2d_backward(const XLATensorPtr& grad_output,
                                            const XLATensorPtr& input) {
-  return input->CreateFrom(torch::lazy::MakeNode<AdaptiveAvgPool2dBackward>(
+  return input->CreateFrom(MakeXlaNode<AdaptiveAvgPool2dBackward>(
       grad_output->GetIrValue(), input->GetIrValue()));
 }
 
@@ -852,7 +852,7 @@ void _amp_foreach_non_finite_check_and_unscale_(std::vector<XLATensorPtr> self,
     inputs.push_back(x->GetIrValue());
   }
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<AmpForachNonFiniteCheckAndUnscale>(
+      MakeXlaNode<AmpForachNonFiniteCheckAndUnscale>(
           inputs, found_inf->GetIrValue(), new_inv_scale->GetIrValue());
   for (size_t i = 0; i < self.size(); ++i) {
     self[i]->SetInPlaceIrValue(torch::lazy::Value(node, i));
@@ -865,7 +865,7 @@ void _amp_update_scale_(XLATensorPtr& current_scale,
                         const XLATensorPtr& found_inf,
                         double scale_growth_factor, double scale_backoff_factor,
                         int growth_interval) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<AmpUpdateScale>(
+  torch::lazy::NodePtr node = MakeXlaNode<AmpUpdateScale>(
       growth_tracker->GetIrValue(), current_scale->GetIrValue(),
       found_inf->GetIrValue(), scale_growth_factor, scale_backoff_factor,
       growth_interval);
@@ -874,7 +874,7 @@ void _amp_update_scale_(XLATensorPtr& current_scale,
 }
 
 XLATensorPtr abs(const XLATensorPtr& input) {
-  return input->CreateFrom(torch::lazy::MakeNode<Abs>(input->GetIrValue()));
+  return input->CreateFrom(MakeXlaNode<Abs>(input->GetIrValue()));
 }
 
 XLATensorPtr add(const XLATensorPtr& input, const XLATensorPtr& other,
@@ -948,7 +948,7 @@ XLATensorPtr as_strided(const XLATensorPtr& input, std::vector<int64_t> size,
     return input->CreateViewTensor(CreateAsStridedViewInfo(
         input_shape, std::move(size), std::move(stride), storage_offset));
   }
-  return input->CreateFrom(torch::lazy::MakeNode<AsStrided>(
+  return input->CreateFrom(MakeXlaNode<AsStrided>(
       input->GetIrValue(), std::move(size), std::move(stride),
       storage_offset.value_or(0)));
 }
@@ -957,7 +957,7 @@ void as_strided_(XLATensorPtr& input, std::vector<int64_t> size,
                  std::vector<int64_t> stride,
                  std::optional<int64_t> storage_offset) {
   if (input->data()->view == nullptr) {
-    input->SetIrValue(torch::lazy::MakeNode<AsStrided>(
+    input->SetIrValue(MakeXlaNode<AsStrided>(
         input->GetIrValue(), std::move(size), std::move(stride),
         storage_offset.value_or(0)));
   } else {
@@ -976,7 +976,7 @@ XLATensorPtr avg_pool_nd(const XLATensorPtr& input, int64_t spatial_dim_count,
   kernel_size = CheckIntList(kernel_size, spatial_dim_count, "kernel_size");
   stride = CheckIntList(stride, spatial_dim_count, "stride", kernel_size);
   padding = CheckIntList(padding, spatial_dim_count, "padding");
-  return input->CreateFrom(torch::lazy::MakeNode<AvgPoolNd>(
+  return input->CreateFrom(MakeXlaNode<AvgPoolNd>(
       input->GetIrValue(), spatial_dim_count, std::move(kernel_size),
       std::move(stride), std::move(padding), ceil_mode, count_include_pad,
       divisor_override));
@@ -992,7 +992,7 @@ XLATensorPtr avg_pool_nd_backward(const XLATensorPtr& out_backprop,
   kernel_size = CheckIntList(kernel_size, spatial_dim_count, "kernel_size");
   stride = CheckIntList(stride, spatial_dim_count, "stride", kernel_size);
   padding = CheckIntList(padding, spatial_dim_count, "padding");
-  return out_backprop->CreateFrom(torch::lazy::MakeNode<AvgPoolNdBackward>(
+  return out_backprop->CreateFrom(MakeXlaNode<AvgPoolNdBackward>(
       out_backprop->GetIrValue(), input->GetIrValue(), spatial_dim_count,
       std::move(kernel_size), std::move(stride), std::move(padding), ceil_mode,
       count_include_pad));
@@ -1008,14 +1008,14 @@ XLATensorPtr baddbmm(const XLATensorPtr& input, const XLATensorPtr& batch1,
   torch::lazy::Value bias_multiplier =
       XLAGraphExecutor::Get()->GetIrValueForScalar(
           beta, input->shape().get().element_type(), input->GetDevice());
-  return input->CreateFrom(torch::lazy::MakeNode<Baddbmm>(
+  return input->CreateFrom(MakeXlaNode<Baddbmm>(
       input->GetIrValue(), batch1->GetIrValue(), batch2->GetIrValue(),
       bias_multiplier, product_multiplier));
 }
 
 XLATensorPtr bernoulli(const XLATensorPtr& input, double probability) {
   auto input_shape = input->shape();
-  return input->CreateFrom(torch::lazy::MakeNode<Bernoulli>(
+  return input->CreateFrom(MakeXlaNode<Bernoulli>(
       XLAGraphExecutor::Get()->GetIrValueForScalar(probability, input_shape,
                                                    input->GetDevice()),
       XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()),
@@ -1023,31 +1023,31 @@ XLATensorPtr bernoulli(const XLATensorPtr& input, double probability) {
 }
 
 XLATensorPtr bernoulli(const XLATensorPtr& input) {
-  return input->CreateFrom(torch::lazy::MakeNode<Bernoulli>(
+  return input->CreateFrom(MakeXlaNode<Bernoulli>(
       input->GetIrValue(),
       XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()),
       input->shape().get()));
 }
 
 void bernoulli_(XLATensorPtr& input, const XLATensorPtr& probability) {
-  input->SetInPlaceIrValue(torch::lazy::MakeNode<Bernoulli>(
+  input->SetInPlaceIrValue(MakeXlaNode<Bernoulli>(
       probability->GetIrValue(),
       XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()),
       input->shape().get()));
 }
 
 XLATensorPtr bitwise_and(const XLATensorPtr& input, const XLATensorPtr& other) {
-  return input->CreateFrom(torch::lazy::MakeNode<BitwiseAndTensor>(
+  return input->CreateFrom(MakeXlaNode<BitwiseAndTensor>(
       input->GetIrValue(), other->GetIrValue()));
 }
 
 XLATensorPtr bitwise_or(const XLATensorPtr& input, const XLATensorPtr& other) {
-  return input->CreateFrom(torch::lazy::MakeNode<BitwiseOrTensor>(
+  return input->CreateFrom(MakeXlaNode<BitwiseOrTensor>(
       input->GetIrValue(), other->GetIrValue()));
 }
 
 XLATensorPtr bitwise_xor(const XLATensorPtr& input, const XLATensorPtr& other) {
-  return input->CreateFrom(torch::lazy::MakeNode<BitwiseXorTensor>(
+  return input->CreateFrom(MakeXlaNode<BitwiseXorTensor>(
       input->GetIrValue(), other->GetIrValue()));
 }
 
@@ -1097,15 +1097,14 @@ XLATensorPtr cat(absl::Span<const XLATensorPtr> tensors, int64_t dim,
   if (values.empty()) {
     return tensors[0];
   }
-  return tensors[0]->CreateFrom(torch::lazy::MakeNode<Cat>(values, dim, dtype),
-                                dtype);
+  return tensors[0]->CreateFrom(MakeXlaNode<Cat>(values, dim, dtype), dtype);
 }
 
 XLATensorPtr cdist_forward(const XLATensorPtr& x1, const XLATensorPtr& x2,
                            double p) {
   torch::lazy::Value exponent_node =
       XLAGraphExecutor::Get()->GetIrValueForScalar(p, x1->GetDevice());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<CdistForward>(
+  torch::lazy::NodePtr node = MakeXlaNode<CdistForward>(
       x1->GetIrValue(), x2->GetIrValue(), exponent_node,
       /*use_hamming=*/p == 0.0,
       /*use_chebyshev=*/std::isinf(p));
@@ -1153,7 +1152,7 @@ XLATensorPtr constant_pad_nd(const XLATensorPtr& input,
                              const at::Scalar& value) {
   std::vector<int64_t> complete_pad(pad.begin(), pad.end());
   complete_pad.resize(2 * input->shape().get().rank());
-  return input->CreateFrom(torch::lazy::MakeNode<ConstantPadNd>(
+  return input->CreateFrom(MakeXlaNode<ConstantPadNd>(
       input->GetIrValue(), complete_pad, value));
 }
 
@@ -1163,7 +1162,7 @@ XLATensorPtr convolution_overrideable(
     std::vector<int64_t> padding, std::vector<int64_t> dilation,
     bool transposed, std::vector<int64_t> output_padding, int64_t groups) {
   torch::lazy::NodePtr ir_value =
-      torch::lazy::MakeNode<ConvolutionOverrideable>(
+      MakeXlaNode<ConvolutionOverrideable>(
           input->GetIrValue(), weight->GetIrValue(), bias->GetIrValue(),
           std::move(stride), std::move(padding), std::move(dilation),
           transposed, std::move(output_padding), groups);
@@ -1176,7 +1175,7 @@ XLATensorPtr convolution_overrideable(
     std::vector<int64_t> dilation, bool transposed,
     std::vector<int64_t> output_padding, int64_t groups) {
   torch::lazy::NodePtr ir_value =
-      torch::lazy::MakeNode<ConvolutionOverrideable>(
+      MakeXlaNode<ConvolutionOverrideable>(
           input->GetIrValue(), weight->GetIrValue(), std::move(stride),
           std::move(padding), std::move(dilation), transposed,
           std::move(output_padding), groups);
@@ -1190,7 +1189,7 @@ convolution_backward_overrideable(
     std::vector<int64_t> padding, std::vector<int64_t> dilation,
     bool transposed, std::vector<int64_t> output_padding, int64_t groups) {
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<ConvolutionBackwardOverrideable>(
+      MakeXlaNode<ConvolutionBackwardOverrideable>(
           out_backprop->GetIrValue(), input->GetIrValue(), weight->GetIrValue(),
           std::move(stride), std::move(padding), std::move(dilation),
           transposed, std::move(output_padding), groups);
@@ -1207,7 +1206,7 @@ convolution_backward_overrideable(
 XLATensorPtr count_nonzero(const XLATensorPtr& input,
                            std::vector<int64_t> dims) {
   torch::lazy::NodePtr ir_value =
-      torch::lazy::MakeNode<CountNonzero>(input->GetIrValue(), dims);
+      MakeXlaNode<CountNonzero>(input->GetIrValue(), dims);
   return input->CreateFrom(ir_value);
 }
 
@@ -1224,8 +1223,7 @@ XLATensorPtr cumprod(const XLATensorPtr& input, int64_t dim,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<CumProd>(input->GetIrValue(), canonical_dim, dtype),
-      dtype);
+      MakeXlaNode<CumProd>(input->GetIrValue(), canonical_dim, dtype), dtype);
 }
 
 XLATensorPtr cumsum(const XLATensorPtr& input, int64_t dim,
@@ -1236,8 +1234,7 @@ XLATensorPtr cumsum(const XLATensorPtr& input, int64_t dim,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<CumSum>(input->GetIrValue(), canonical_dim, dtype),
-      dtype);
+      MakeXlaNode<CumSum>(input->GetIrValue(), canonical_dim, dtype), dtype);
 }
 
 XLATensorPtr diag(const XLATensorPtr& input, int64_t offset) {
@@ -1268,7 +1265,7 @@ XLATensorPtr diagonal(const XLATensorPtr& input, int64_t offset, int64_t dim1,
     return input->CreateViewTensor(std::move(view_info));
   }
 
-  return input->CreateFrom(torch::lazy::MakeNode<Diagonal>(
+  return input->CreateFrom(MakeXlaNode<Diagonal>(
       input->GetIrValue(), offset, canonical_dim1, canonical_dim2));
 }
 
@@ -1293,9 +1290,9 @@ XLATensorPtr div(const XLATensorPtr& input, const XLATensorPtr& other,
   torch::lazy::Value res = Div(input_value, other_value);
   if (rounding_mode.has_value()) {
     if (*rounding_mode == "trunc") {
-      res = torch::lazy::MakeNode<Trunc>(res);
+      res = MakeXlaNode<Trunc>(res);
     } else if (*rounding_mode == "floor") {
-      res = torch::lazy::MakeNode<Floor>(res);
+      res = MakeXlaNode<Floor>(res);
     } else {
       XLA_CHECK(false)
           << "rounding_mode must be one of None, 'trunc', or 'floor'";
@@ -1311,7 +1308,7 @@ XLATensorPtr div(const XLATensorPtr& input, const XLATensorPtr& other,
       xla::PrimitiveType res_intended_type =
           MakeXlaPrimitiveType(*logical_element_type, &input->GetDevice());
       if (GetXlaShape(res).element_type() != res_intended_type) {
-        res = torch::lazy::MakeNode<Cast>(res, res_intended_type);
+        res = MakeXlaNode<Cast>(res, res_intended_type);
       }
     }
     return input->CreateFrom(res, logical_element_type);
@@ -1332,11 +1329,11 @@ XLATensorPtr div(const XLATensorPtr& input, const at::Scalar& other) {
   }
   at::ScalarType op_math_type = at::toOpMathType(scalar_type);
   torch::lazy::Value input_value =
-      torch::lazy::MakeNode<Cast>(input->GetIrValue(), op_math_type);
+      MakeXlaNode<Cast>(input->GetIrValue(), op_math_type);
   torch::lazy::Value other_value = XLAGraphExecutor::Get()->GetIrValueForScalar(
       other, XlaTypeFromTorchType(op_math_type), input->GetDevice());
   return input->CreateFrom(
-      torch::lazy::MakeNode<Cast>(Div(input_value, other_value), scalar_type),
+      MakeXlaNode<Cast>(Div(input_value, other_value), scalar_type),
       scalar_type);
 }
 
@@ -1348,7 +1345,7 @@ XLATensorPtr einsum(const std::string& equation,
     irs.push_back(tensor->GetIrValue());
   }
 
-  return tensors[0]->CreateFrom(torch::lazy::MakeNode<Einsum>(irs, equation));
+  return tensors[0]->CreateFrom(MakeXlaNode<Einsum>(irs, equation));
 }
 
 std::tuple<XLATensorPtr, XLATensorPtr> einsum_backward(
@@ -1360,7 +1357,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> einsum_backward(
     irs.push_back(tensor->GetIrValue());
   }
 
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<EinsumBackward>(
+  torch::lazy::NodePtr node = MakeXlaNode<EinsumBackward>(
       grad_output->GetIrValue(), irs, equation);
 
   if (node->num_outputs() == 2) {
@@ -1408,7 +1405,7 @@ embedding_bag(const XLATensorPtr& weight, const XLATensorPtr& indices,
               const XLATensorPtr& offsets, int64_t mode,
               const XLATensorPtr& per_sample_weights,
               bool include_last_offset) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<EmbeddingBag>(
+  torch::lazy::NodePtr node = MakeXlaNode<EmbeddingBag>(
       weight->GetIrValue(), indices->GetIrValue(), offsets->GetIrValue(), mode,
       per_sample_weights->GetIrValue(), include_last_offset);
   return std::make_tuple(weight->CreateFrom(torch::lazy::Value(node, 0)),
@@ -1423,7 +1420,7 @@ XLATensorPtr exp(const XLATensorPtr& input) {
 
 XLATensorPtr expand(const XLATensorPtr& input, std::vector<int64_t> size) {
   auto input_shape = input->shape();
-  auto output = input->CreateFrom(torch::lazy::MakeNode<Expand>(
+  auto output = input->CreateFrom(MakeXlaNode<Expand>(
       input->GetIrValue(),
       GetExpandDimensions(input_shape.get(), std::move(size))));
   output->SetStorage(input->Storage());
@@ -1434,14 +1431,14 @@ XLATensorPtr expand_symint(const XLATensorPtr& input,
                            c10::SymIntArrayRef sym_size) {
   SymIntElements size_elements = SymIntElements(sym_size);
   XLATensorPtr output = input->CreateFrom(
-      torch::lazy::MakeNode<ExpandSymInt>(input->GetIrValue(), size_elements));
+      MakeXlaNode<ExpandSymInt>(input->GetIrValue(), size_elements));
   output->SetStorage(input->Storage());
   return output;
 }
 
 void exponential_(XLATensorPtr& input, double lambd) {
   auto input_shape = input->shape();
-  input->SetInPlaceIrValue(torch::lazy::MakeNode<Exponential>(
+  input->SetInPlaceIrValue(MakeXlaNode<Exponential>(
       XLAGraphExecutor::Get()->GetIrValueForScalar(
           lambd, input_shape.get().element_type(), input->GetDevice()),
       XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()),
@@ -1482,7 +1479,7 @@ XLATensorPtr flip(const XLATensorPtr& input, absl::Span<const int64_t> dims) {
   std::set<int64_t> unique_dims(dimensions.begin(), dimensions.end());
   XLA_CHECK_EQ(unique_dims.size(), dimensions.size());
   return input->CreateFrom(
-      torch::lazy::MakeNode<Flip>(input->GetIrValue(), dimensions));
+      MakeXlaNode<Flip>(input->GetIrValue(), dimensions));
 }
 
 XLATensorPtr fmod(const XLATensorPtr& input, const XLATensorPtr& other,
@@ -1558,7 +1555,7 @@ XLATensorPtr gather(const XLATensorPtr& input, int64_t dim,
       XLA_CHECK_LE(index->size(dim), input->size(dim));
     }
   }
-  return input->CreateFrom(torch::lazy::MakeNode<Gather>(
+  return input->CreateFrom(MakeXlaNode<Gather>(
       input->GetIrValue(), canonical_dim, index->GetIrValue()));
 }
 
@@ -1674,14 +1671,14 @@ void index_put_(XLATensorPtr& input, const XLATensorPtr& canonical_base,
 XLATensorPtr index_select(const XLATensorPtr& input, int64_t dim,
                           const XLATensorPtr& index) {
   torch::lazy::Value index_value = EnsureRank1(index->GetIrValue());
-  return input->CreateFrom(torch::lazy::MakeNode<IndexSelect>(
+  return input->CreateFrom(MakeXlaNode<IndexSelect>(
       input->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank()),
       index_value));
 }
 
 XLATensorPtr isnan(const XLATensorPtr& input) {
-  torch::lazy::Value result = torch::lazy::MakeNode<Isnan>(input->GetIrValue());
+  torch::lazy::Value result = MakeXlaNode<Isnan>(input->GetIrValue());
   torch::lazy::Value casted = GetBooleanIrValue(result);
   return input->CreateFrom(casted, at::ScalarType::Bool);
 }
@@ -1689,7 +1686,7 @@ XLATensorPtr isnan(const XLATensorPtr& input) {
 std::tuple<XLATensorPtr, XLATensorPtr> kthvalue(const XLATensorPtr& input,
                                                 int64_t k, int64_t dim,
                                                 bool keepdim) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<KthValue>(
+  torch::lazy::NodePtr node = MakeXlaNode<KthValue>(
       input->GetIrValue(), k,
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank()),
       keepdim);
@@ -1710,7 +1707,7 @@ XLATensorPtr hardtanh_backward(const XLATensorPtr& grad_output,
                                const XLATensorPtr& input,
                                const at::Scalar& min_val,
                                const at::Scalar& max_val) {
-  return grad_output->CreateFrom(torch::lazy::MakeNode<HardtanhBackward>(
+  return grad_output->CreateFrom(MakeXlaNode<HardtanhBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), min_val, max_val));
 }
 
@@ -1749,7 +1746,7 @@ XLATensorPtr linalg_vector_norm(const XLATensorPtr& input,
   xla::PrimitiveType res_intended_type =
       MakeXlaPrimitiveType(*dtype, &input->GetDevice());
   if (GetXlaShape(res).element_type() != res_intended_type) {
-    res = torch::lazy::MakeNode<Cast>(res, res_intended_type);
+    res = MakeXlaNode<Cast>(res, res_intended_type);
   }
   return input->CreateFrom(res, dtype);
 }
@@ -1762,8 +1759,7 @@ XLATensorPtr linspace(const at::Scalar& start, const at::Scalar& end,
   torch::lazy::Value end_val = XLAGraphExecutor::Get()->GetIrValueForScalar(
       end, xla::PrimitiveType::F32, device);
   return XLATensor::Create(
-      torch::lazy::MakeNode<Linspace>(start_val, end_val, steps), device,
-      element_type);
+      MakeXlaNode<Linspace>(start_val, end_val, steps), device, element_type);
 }
 
 XLATensorPtr log(const XLATensorPtr& input) {
@@ -1808,10 +1804,10 @@ XLATensorPtr log_softmax(const XLATensorPtr& input, int64_t dim,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<LogSoftmax>(input->GetIrValue(),
-                                        torch::lazy::GetCanonicalDimensionIndex(
-                                            dim, input->shape().get().rank()),
-                                        dtype, std::move(shapes)),
+      MakeXlaNode<LogSoftmax>(input->GetIrValue(),
+                              torch::lazy::GetCanonicalDimensionIndex(
+                                  dim, input->shape().get().rank()),
+                              dtype, std::move(shapes)),
       dtype);
 }
 
@@ -1837,7 +1833,7 @@ void log1p_(XLATensorPtr& input) {
 XLATensorPtr logsumexp(const XLATensorPtr& input,
                        std::vector<int64_t> dimensions,
                        bool keep_reduced_dimensions) {
-  return input->CreateFrom(torch::lazy::MakeNode<Logsumexp>(
+  return input->CreateFrom(MakeXlaNode<Logsumexp>(
       input->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndices(
           torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -1866,7 +1862,7 @@ XLATensorPtr lt(const XLATensorPtr& input, const XLATensorPtr& other) {
 
 XLATensorPtr mark_tensor(const XLATensorPtr& input, const std::string& info) {
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<MarkTensor>(input->GetIrValue(), info);
+      MakeXlaNode<MarkTensor>(input->GetIrValue(), info);
   return input->CreateFrom(torch::lazy::Value(node));
 }
 
@@ -1882,14 +1878,14 @@ XLATensorPtr masked_scatter(XLATensorPtr& input, const XLATensorPtr& mask,
   if (input->shape().get().dimensions() < mask->shape().get().dimensions()) {
     input_value = MaybeExpand(input->GetIrValue(), mask->shape());
   }
-  return input->CreateFrom(torch::lazy::MakeNode<MaskedScatter>(
+  return input->CreateFrom(MakeXlaNode<MaskedScatter>(
       input_value, MaybeExpand(mask->GetIrValue(), GetXlaShape(input_value)),
       source->GetIrValue()));
 }
 
 XLATensorPtr masked_select(const XLATensorPtr& input,
                            const XLATensorPtr& mask) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<MaskedSelect>(
+  torch::lazy::NodePtr node = MakeXlaNode<MaskedSelect>(
       input->GetIrValue(), mask->GetIrValue());
   return input->CreateFrom(torch::lazy::Value(node, 0));
 }
@@ -1906,7 +1902,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> max(const XLATensorPtr& input,
                                            int64_t dim, bool keepdim) {
   int64_t canonical_dim =
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<MaxInDim>(
+  torch::lazy::NodePtr node = MakeXlaNode<MaxInDim>(
       input->GetIrValue(), canonical_dim, keepdim);
   return std::make_tuple(
       input->CreateFrom(torch::lazy::Value(node, 0)),
@@ -1917,7 +1913,7 @@ void max_out(XLATensorPtr& max, XLATensorPtr& max_values,
              const XLATensorPtr& input, int64_t dim, bool keepdim) {
   int64_t canonical_dim =
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<MaxInDim>(
+  torch::lazy::NodePtr node = MakeXlaNode<MaxInDim>(
       input->GetIrValue(), canonical_dim, keepdim);
   max->SetIrValue(torch::lazy::Value(node, 0));
   max_values->SetIrValue(torch::lazy::Value(node, 1));
@@ -1930,7 +1926,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> max_pool_nd(
   kernel_size = CheckIntList(kernel_size, spatial_dim_count, "kernel_size");
   stride = CheckIntList(stride, spatial_dim_count, "stride", kernel_size);
   padding = CheckIntList(padding, spatial_dim_count, "padding");
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<MaxPoolNd>(
+  torch::lazy::NodePtr node = MakeXlaNode<MaxPoolNd>(
       input->GetIrValue(), spatial_dim_count, std::move(kernel_size),
       std::move(stride), std::move(padding), ceil_mode);
   return std::make_tuple(
@@ -1945,7 +1941,7 @@ XLATensorPtr max_pool_nd_backward(
   kernel_size = CheckIntList(kernel_size, spatial_dim_count, "kernel_size");
   stride = CheckIntList(stride, spatial_dim_count, "stride", kernel_size);
   padding = CheckIntList(padding, spatial_dim_count, "padding");
-  return out_backprop->CreateFrom(torch::lazy::MakeNode<MaxPoolNdBackward>(
+  return out_backprop->CreateFrom(MakeXlaNode<MaxPoolNdBackward>(
       out_backprop->GetIrValue(), input->GetIrValue(), spatial_dim_count,
       std::move(kernel_size), std::move(stride), std::move(padding),
       ceil_mode));
@@ -1953,7 +1949,7 @@ XLATensorPtr max_pool_nd_backward(
 
 XLATensorPtr max_unpool(const XLATensorPtr& input, const XLATensorPtr& indices,
                         std::vector<int64_t> output_size) {
-  return input->CreateFrom(torch::lazy::MakeNode<MaxUnpoolNd>(
+  return input->CreateFrom(MakeXlaNode<MaxUnpoolNd>(
       input->GetIrValue(), indices->GetIrValue(), std::move(output_size)));
 }
 
@@ -1964,7 +1960,7 @@ XLATensorPtr mean(const XLATensorPtr& input, std::vector<int64_t> dimensions,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<Mean>(
+      MakeXlaNode<Mean>(
           input->GetIrValue(),
           torch::lazy::GetCanonicalDimensionIndices(
               torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -1987,7 +1983,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> min(const XLATensorPtr& input,
                                            int64_t dim, bool keepdim) {
   int64_t canonical_dim =
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<MinInDim>(
+  torch::lazy::NodePtr node = MakeXlaNode<MinInDim>(
       input->GetIrValue(), canonical_dim, keepdim);
   return std::make_tuple(
       input->CreateFrom(torch::lazy::Value(node, 0)),
@@ -1998,7 +1994,7 @@ void min_out(XLATensorPtr& min, XLATensorPtr& min_indices,
              const XLATensorPtr& input, int64_t dim, bool keepdim) {
   int64_t canonical_dim =
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<MinInDim>(
+  torch::lazy::NodePtr node = MakeXlaNode<MinInDim>(
       input->GetIrValue(), canonical_dim, keepdim);
   min->SetIrValue(torch::lazy::Value(node, 0));
   min_indices->SetIrValue(torch::lazy::Value(node, 1));
@@ -2007,8 +2003,7 @@ void min_out(XLATensorPtr& min, XLATensorPtr& min_indices,
 XLATensorPtr mish(const XLATensorPtr& input) {
   return input->CreateFrom(
       input->GetIrValue() *
-      torch::lazy::MakeNode<Tanh>(
-          tensor_ops::Softplus(input, 1, 20)->GetIrValue()));
+      MakeXlaNode<Tanh>(tensor_ops::Softplus(input, 1, 20)->GetIrValue()));
 }
 
 XLATensorPtr mm(const XLATensorPtr& input, const XLATensorPtr& weight) {
@@ -2022,15 +2017,15 @@ XLATensorPtr mse_loss(const XLATensorPtr& input, const XLATensorPtr& target,
   // case of mse_loss(long, float16) -> float16, we want to derive the dtype
   // from IR value instead of input's logical_element_type.
   return input->CreateFrom(
-      torch::lazy::MakeNode<MseLoss>(input->GetIrValue(), target->GetIrValue(),
-                                     GetXlaReductionMode(reduction)),
+      MakeXlaNode<MseLoss>(input->GetIrValue(), target->GetIrValue(),
+                           GetXlaReductionMode(reduction)),
       std::nullopt);
 }
 
 XLATensorPtr mse_loss_backward(const XLATensorPtr& grad_output,
                                const XLATensorPtr& input,
                                const XLATensorPtr& target, int64_t reduction) {
-  return input->CreateFrom(torch::lazy::MakeNode<MseLossBackward>(
+  return input->CreateFrom(MakeXlaNode<MseLossBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), target->GetIrValue(),
       GetXlaReductionMode(reduction)));
 }
@@ -2057,7 +2052,7 @@ XLATensorPtr multinomial(const XLATensorPtr& input, int64_t num_samples,
                          bool replacement) {
   auto input_shape = input->shape();
   return input->CreateFrom(
-      torch::lazy::MakeNode<Multinomial>(
+      MakeXlaNode<Multinomial>(
           input->GetIrValue(),
           XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()), num_samples,
           replacement),
@@ -2112,7 +2107,7 @@ XLATensorPtr narrow(const XLATensorPtr& input, int64_t dim, int64_t start,
     return input->CreateViewTensor(std::move(view_info));
   }
 
-  return input->CreateFrom(torch::lazy::MakeNode<GenericSlice>(
+  return input->CreateFrom(MakeXlaNode<GenericSlice>(
       input->GetIrValue(), std::move(indices), narrow_shape.dimensions()));
 }
 
@@ -2129,7 +2124,7 @@ std::tuple<XLATensorPtr, XLATensorPtr, XLATensorPtr> native_batch_norm(
       GetIrValueOrDefault(running_mean, 0, features_shape, input->GetDevice());
   torch::lazy::Value running_var_value =
       GetIrValueOrDefault(running_var, 0, features_shape, input->GetDevice());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<NativeBatchNormForward>(
+  torch::lazy::NodePtr node = MakeXlaNode<NativeBatchNormForward>(
       input->GetIrValue(), weight_value, bias_value, running_mean_value,
       running_var_value, training, eps);
   XLATensorPtr output = input->CreateFrom(torch::lazy::Value(node, 0));
@@ -2139,11 +2134,11 @@ std::tuple<XLATensorPtr, XLATensorPtr, XLATensorPtr> native_batch_norm(
     mean = input->CreateFrom(torch::lazy::Value(node, 1));
     variance_inverse = input->CreateFrom(torch::lazy::Value(node, 3));
     if (running_mean) {
-      running_mean->SetIrValue(torch::lazy::MakeNode<LinearInterpolation>(
+      running_mean->SetIrValue(MakeXlaNode<LinearInterpolation>(
           mean->GetIrValue(), running_mean->GetIrValue(), momentum));
     }
     if (running_var) {
-      running_var->SetIrValue(torch::lazy::MakeNode<LinearInterpolation>(
+      running_var->SetIrValue(MakeXlaNode<LinearInterpolation>(
           torch::lazy::Value(node, 2), running_var->GetIrValue(), momentum));
     }
   } else {
@@ -2162,7 +2157,7 @@ std::tuple<XLATensorPtr, XLATensorPtr, XLATensorPtr> native_batch_norm_backward(
   xla::Shape features_shape = BatchNormFeaturesShape(input);
   torch::lazy::Value weight_value =
       GetIrValueOrDefault(weight, 1, features_shape, input->GetDevice());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<NativeBatchNormBackward>(
+  torch::lazy::NodePtr node = MakeXlaNode<NativeBatchNormBackward>(
       grad_out->GetIrValue(), input->GetIrValue(), weight_value,
       save_mean->GetIrValue(), save_invstd->GetIrValue(), training, eps);
   XLATensorPtr grad_input = input->CreateFrom(torch::lazy::Value(node, 0));
@@ -2174,7 +2169,7 @@ std::tuple<XLATensorPtr, XLATensorPtr, XLATensorPtr> native_batch_norm_backward(
 
 std::tuple<XLATensorPtr, XLATensorPtr> native_dropout(
     const XLATensorPtr& input, double p, std::optional<bool> train) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<NativeDropout>(
+  torch::lazy::NodePtr node = MakeXlaNode<NativeDropout>(
       input->GetIrValue(),
       XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()), p, train);
   return std::make_tuple(
@@ -2197,7 +2192,7 @@ XLATensorPtr neg(const XLATensorPtr& input) {
 XLATensorPtr nll_loss(const XLATensorPtr& input, const XLATensorPtr& target,
                       const XLATensorPtr& weight, int64_t reduction,
                       int ignore_index) {
-  return input->CreateFrom(torch::lazy::MakeNode<NllLoss>(
+  return input->CreateFrom(MakeXlaNode<NllLoss>(
       input->GetIrValue(), target->GetIrValue(), GetOptionalIrValue(weight),
       GetXlaReductionMode(reduction), ignore_index));
 }
@@ -2205,7 +2200,7 @@ XLATensorPtr nll_loss(const XLATensorPtr& input, const XLATensorPtr& target,
 XLATensorPtr nll_loss2d(const XLATensorPtr& input, const XLATensorPtr& target,
                         const XLATensorPtr& weight, int64_t reduction,
                         int ignore_index) {
-  return input->CreateFrom(torch::lazy::MakeNode<NllLoss2d>(
+  return input->CreateFrom(MakeXlaNode<NllLoss2d>(
       input->GetIrValue(), target->GetIrValue(), GetOptionalIrValue(weight),
       GetXlaReductionMode(reduction), ignore_index));
 }
@@ -2216,7 +2211,7 @@ XLATensorPtr nll_loss2d_backward(const XLATensorPtr& grad_output,
                                  const XLATensorPtr& weight, int64_t reduction,
                                  int ignore_index,
                                  const XLATensorPtr& total_weight) {
-  return input->CreateFrom(torch::lazy::MakeNode<NllLoss2dBackward>(
+  return input->CreateFrom(MakeXlaNode<NllLoss2dBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), target->GetIrValue(),
       GetOptionalIrValue(weight), GetOptionalIrValue(total_weight),
       GetXlaReductionMode(reduction), ignore_index));
@@ -2228,7 +2223,7 @@ XLATensorPtr nll_loss_backward(const XLATensorPtr& grad_output,
                                const XLATensorPtr& weight, int64_t reduction,
                                int ignore_index,
                                const XLATensorPtr& total_weight) {
-  return input->CreateFrom(torch::lazy::MakeNode<NllLossBackward>(
+  return input->CreateFrom(MakeXlaNode<NllLossBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), target->GetIrValue(),
       GetOptionalIrValue(weight), GetOptionalIrValue(total_weight),
       GetXlaReductionMode(reduction), ignore_index));
@@ -2239,14 +2234,14 @@ XLATensorPtr nms(const XLATensorPtr& boxes, const XLATensorPtr& scores,
   const torch::lazy::BackendDevice& device = boxes->GetDevice();
   torch::lazy::NodePtr xla_iou_threshold =
       ScalarOp(iou_threshold, MakeXlaPrimitiveType(at::kDouble, &device));
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<Nms>(
+  torch::lazy::NodePtr node = MakeXlaNode<Nms>(
       boxes->GetIrValue(), scores->GetIrValue(), xla_iou_threshold);
   return XLATensor::Create(node, device, at::ScalarType::Long);
 }
 
 XLATensorPtr nonzero(const XLATensorPtr& input) {
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<NonZero>(input->GetIrValue());
+      MakeXlaNode<NonZero>(input->GetIrValue());
   // Nonzero result type should not depend on input type, hence we shouldn't
   // use input->CreateFrom which will inherit the logical_element_type.
   return XLATensor::Create(torch::lazy::Value(node, 0), input->GetDevice());
@@ -2265,7 +2260,7 @@ XLATensorPtr norm(const XLATensorPtr& input, const std::optional<at::Scalar>& p,
 }
 
 XLATensorPtr normal(double mean, const XLATensorPtr& std) {
-  return std->CreateFrom(torch::lazy::MakeNode<Normal>(
+  return std->CreateFrom(MakeXlaNode<Normal>(
       XLAGraphExecutor::Get()->GetIrValueForScalar(mean, std->shape(),
                                                    std->GetDevice()),
       std->GetIrValue(),
@@ -2273,7 +2268,7 @@ XLATensorPtr normal(double mean, const XLATensorPtr& std) {
 }
 
 XLATensorPtr normal(const XLATensorPtr& mean, double std) {
-  return mean->CreateFrom(torch::lazy::MakeNode<Normal>(
+  return mean->CreateFrom(MakeXlaNode<Normal>(
       mean->GetIrValue(),
       XLAGraphExecutor::Get()->GetIrValueForScalar(std, mean->shape(),
                                                    mean->GetDevice()),
@@ -2281,13 +2276,13 @@ XLATensorPtr normal(const XLATensorPtr& mean, double std) {
 }
 
 XLATensorPtr normal(const XLATensorPtr& mean, const XLATensorPtr& std) {
-  return mean->CreateFrom(torch::lazy::MakeNode<Normal>(
+  return mean->CreateFrom(MakeXlaNode<Normal>(
       mean->GetIrValue(), MaybeExpand(std->GetIrValue(), mean->shape()),
       XLAGraphExecutor::Get()->GetRngSeed(mean->GetDevice())));
 }
 
 void normal_(XLATensorPtr& input, double mean, double std) {
-  input->SetInPlaceIrValue(torch::lazy::MakeNode<Normal>(
+  input->SetInPlaceIrValue(MakeXlaNode<Normal>(
       XLAGraphExecutor::Get()->GetIrValueForScalar(mean, input->shape(),
                                                    input->GetDevice()),
       XLAGraphExecutor::Get()->GetIrValueForScalar(std, input->shape(),
@@ -2297,7 +2292,7 @@ void normal_(XLATensorPtr& input, double mean, double std) {
 
 XLATensorPtr not_supported(std::string description, xla::Shape shape,
                            const torch::lazy::BackendDevice& device) {
-  return XLATensor::Create(torch::lazy::MakeNode<NotSupported>(
+  return XLATensor::Create(MakeXlaNode<NotSupported>(
                                std::move(description), std::move(shape)),
                            device);
 }
@@ -2308,7 +2303,7 @@ void optimization_barrier_(std::vector<XLATensorPtr>& tensors) {
   for (XLATensorPtr& tensor : tensors) {
     irs.push_back(tensor->GetIrValue());
   }
-  torch::lazy::NodePtr result = torch::lazy::MakeNode<OptimizationBarrier>(irs);
+  torch::lazy::NodePtr result = MakeXlaNode<OptimizationBarrier>(irs);
   for (int i = 0; i < tensors.size(); i++) {
     tensors[i]->SetInPlaceIrValue(torch::lazy::Value(result, i));
   }
@@ -2328,7 +2323,7 @@ XLATensorPtr permute(const XLATensorPtr& input,
   }
 
   return input->CreateFrom(
-      torch::lazy::MakeNode<Permute>(input->GetIrValue(), dimensions));
+      MakeXlaNode<Permute>(input->GetIrValue(), dimensions));
 }
 
 XLATensorPtr pow(const XLATensorPtr& input, const at::Scalar& exponent,
@@ -2388,7 +2383,7 @@ XLATensorPtr prod(const XLATensorPtr& input, std::vector<int64_t> dimensions,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<Prod>(
+      MakeXlaNode<Prod>(
           input->GetIrValue(),
           torch::lazy::GetCanonicalDimensionIndices(
               torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -2400,14 +2395,14 @@ XLATensorPtr prod(const XLATensorPtr& input, std::vector<int64_t> dimensions,
 void put_(XLATensorPtr& input, const XLATensorPtr& index,
           const XLATensorPtr& source, bool accumulate) {
   input->SetInPlaceIrValue(
-      torch::lazy::MakeNode<Put>(input->GetIrValue(), index->GetIrValue(),
-                                 source->GetIrValue(), accumulate));
+      MakeXlaNode<Put>(input->GetIrValue(), index->GetIrValue(),
+                       source->GetIrValue(), accumulate));
 }
 
 std::tuple<XLATensorPtr, XLATensorPtr> qr(const XLATensorPtr& input,
                                           bool some) {
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<QR>(input->GetIrValue(), some);
+      MakeXlaNode<QR>(input->GetIrValue(), some);
   return std::make_tuple(input->CreateFrom(torch::lazy::Value(node, 0)),
                          input->CreateFrom(torch::lazy::Value(node, 1)));
 }
@@ -2417,7 +2412,7 @@ XLATensorPtr quantize_tensor(const XLATensorPtr& input,
                              const std::vector<int>& zero_point_list,
                              int quant_min, int quant_max,
                              const std::string& dtype, int axis) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<QuantizeTensor>(
+  torch::lazy::NodePtr node = MakeXlaNode<QuantizeTensor>(
       input->GetIrValue(), scale_list, zero_point_list, quant_min, quant_max,
       dtype, axis);
   return input->CreateFrom(torch::lazy::Value(node));
@@ -2428,7 +2423,7 @@ XLATensorPtr dequantize_tensor(const XLATensorPtr& input,
                                const std::vector<int>& zero_point_list,
                                int quant_min, int quant_max,
                                const std::string& dtype, int axis) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<DequantizeTensor>(
+  torch::lazy::NodePtr node = MakeXlaNode<DequantizeTensor>(
       input->GetIrValue(), scale_list, zero_point_list, quant_min, quant_max,
       dtype, axis);
   return input->CreateFrom(torch::lazy::Value(node));
@@ -2437,7 +2432,7 @@ XLATensorPtr dequantize_tensor(const XLATensorPtr& input,
 XLATensorPtr cast_int4(const XLATensorPtr& weight,
                        const std::vector<int>& int4_weight_values) {
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<CastInt4>(weight->GetIrValue(), int4_weight_values);
+      MakeXlaNode<CastInt4>(weight->GetIrValue(), int4_weight_values);
   return weight->CreateFrom(torch::lazy::Value(node));
 }
 
@@ -2451,7 +2446,7 @@ XLATensorPtr dynamic_expand(const XLATensorPtr& input,
                             int target_dim) {
   std::vector<int64_t> expanded_size =
       GetExpandDimensions(input->shape().get(), size);
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<DynamicExpand>(
+  torch::lazy::NodePtr node = MakeXlaNode<DynamicExpand>(
       input->GetIrValue(), expanded_size, src_tensor->GetIrValue(), src_dim,
       target_dim);
   return input->CreateFrom(torch::lazy::Value(node));
@@ -2467,7 +2462,7 @@ XLATensorPtr dynamic_view(const XLATensorPtr& input,
   xla::Shape shape =
       XlaHelpers::GetDynamicReshape(input_shape, complete_dimensions);
 
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<DynamicView>(
+  torch::lazy::NodePtr node = MakeXlaNode<DynamicView>(
       input->GetIrValue(), torch::lazy::ToVector<int64_t>(shape.dimensions()),
       src_tensor->GetIrValue(), src_dim, target_dim, mul_scaler);
   return input->CreateFrom(torch::lazy::Value(node));
@@ -2478,7 +2473,7 @@ XLATensorPtr dynamic_view(const XLATensorPtr& input,
 void random_(XLATensorPtr& input, int64_t from, int64_t to) {
   XLA_CHECK_LE(from, to);
   auto input_shape = input->shape();
-  input->SetInPlaceIrValue(torch::lazy::MakeNode<DiscreteUniform>(
+  input->SetInPlaceIrValue(MakeXlaNode<DiscreteUniform>(
       XLAGraphExecutor::Get()->GetIrValueForScalar(
           from, xla::PrimitiveType::S64, input->GetDevice()),
       XLAGraphExecutor::Get()->GetIrValueForScalar(to, xla::PrimitiveType::S64,
@@ -2490,7 +2485,7 @@ XLATensorPtr randperm(int64_t n, const torch::lazy::BackendDevice& device,
                       at::ScalarType scalar_type) {
   // These are all PyTorch defaults. PyTorch/XLA doesn't support non default
   // params here yet.
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<RandPerm>(
+  torch::lazy::NodePtr node = MakeXlaNode<RandPerm>(
       n, at::ScalarType::Long, at::Layout::Strided, at::DeviceType::XLA,
       /*pin_memory=*/false);
   return XLATensor::Create(node, device, scalar_type);
@@ -2500,7 +2495,7 @@ XLATensorPtr reflection_pad1d(const XLATensorPtr& input,
                               std::vector<int64_t> padding) {
   // `ReflectionPad2d` is used due to `at::aten::reflection_pad2d_backward`
   // named already
-  return input->CreateFrom(torch::lazy::MakeNode<ReflectionPad2d>(
+  return input->CreateFrom(MakeXlaNode<ReflectionPad2d>(
       input->GetIrValue(), std::move(padding)));
 }
 
@@ -2509,20 +2504,20 @@ XLATensorPtr reflection_pad1d_backward(const XLATensorPtr& grad_output,
                                        std::vector<int64_t> padding) {
   // `ReflectionPad2dBackward` is used due to
   // `at::aten::reflection_pad2d_backward` named already
-  return input->CreateFrom(torch::lazy::MakeNode<ReflectionPad2dBackward>(
+  return input->CreateFrom(MakeXlaNode<ReflectionPad2dBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr reflection_pad2d(const XLATensorPtr& input,
                               std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReflectionPad2d>(
+  return input->CreateFrom(MakeXlaNode<ReflectionPad2d>(
       input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr reflection_pad2d_backward(const XLATensorPtr& grad_output,
                                        const XLATensorPtr& input,
                                        std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReflectionPad2dBackward>(
+  return input->CreateFrom(MakeXlaNode<ReflectionPad2dBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), std::move(padding)));
 }
 
@@ -2530,7 +2525,7 @@ XLATensorPtr reflection_pad3d(const XLATensorPtr& input,
                               std::vector<int64_t> padding) {
   // `ReflectionPad2d` is used due to `at::aten::reflection_pad2d_backward`
   // named already
-  return input->CreateFrom(torch::lazy::MakeNode<ReflectionPad2d>(
+  return input->CreateFrom(MakeXlaNode<ReflectionPad2d>(
       input->GetIrValue(), std::move(padding)));
 }
 
@@ -2539,7 +2534,7 @@ XLATensorPtr reflection_pad3d_backward(const XLATensorPtr& grad_output,
                                        std::vector<int64_t> padding) {
   // `ReflectionPad2dBackward` is used due to
   // `at::aten::reflection_pad2d_backward` named already
-  return input->CreateFrom(torch::lazy::MakeNode<ReflectionPad2dBackward>(
+  return input->CreateFrom(MakeXlaNode<ReflectionPad2dBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), std::move(padding)));
 }
 
@@ -2555,47 +2550,47 @@ XLATensorPtr remainder(const XLATensorPtr& input, const at::Scalar& other) {
 
 XLATensorPtr replication_pad1d(const XLATensorPtr& input,
                                std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReplicationPad>(
+  return input->CreateFrom(MakeXlaNode<ReplicationPad>(
       input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr replication_pad1d_backward(const XLATensorPtr& grad_output,
                                         const XLATensorPtr& input,
                                         std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReplicationPadBackward>(
+  return input->CreateFrom(MakeXlaNode<ReplicationPadBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr replication_pad2d(const XLATensorPtr& input,
                                std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReplicationPad>(
+  return input->CreateFrom(MakeXlaNode<ReplicationPad>(
       input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr replication_pad2d_backward(const XLATensorPtr& grad_output,
                                         const XLATensorPtr& input,
                                         std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReplicationPadBackward>(
+  return input->CreateFrom(MakeXlaNode<ReplicationPadBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr replication_pad3d(const XLATensorPtr& input,
                                std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReplicationPad>(
+  return input->CreateFrom(MakeXlaNode<ReplicationPad>(
       input->GetIrValue(), std::move(padding)));
 }
 
 XLATensorPtr replication_pad3d_backward(const XLATensorPtr& grad_output,
                                         const XLATensorPtr& input,
                                         std::vector<int64_t> padding) {
-  return input->CreateFrom(torch::lazy::MakeNode<ReplicationPadBackward>(
+  return input->CreateFrom(MakeXlaNode<ReplicationPadBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), std::move(padding)));
 }
 
 void resize_(XLATensorPtr& input, std::vector<int64_t> size) {
   if (input->data()->view == nullptr) {
     input->SetIrValue(
-        torch::lazy::MakeNode<Resize>(input->GetIrValue(), std::move(size)));
+        MakeXlaNode<Resize>(input->GetIrValue(), std::move(size)));
   } else {
     auto input_shape = input->shape();
     xla::Shape resize_shape =
@@ -2616,7 +2611,7 @@ XLATensorPtr roll(const XLATensorPtr& input, absl::Span<const int64_t> shifts,
   }
   auto canonical_dims = torch::lazy::GetCanonicalDimensionIndices(
       torch::lazy::ToVector<int64_t>(dims), input->shape().get().rank());
-  return input->CreateFrom(torch::lazy::MakeNode<Roll>(
+  return input->CreateFrom(MakeXlaNode<Roll>(
       input->GetIrValue(), torch::lazy::ToVector<int64_t>(shifts),
       canonical_dims));
 }
@@ -2624,7 +2619,7 @@ XLATensorPtr roll(const XLATensorPtr& input, absl::Span<const int64_t> shifts,
 XLATensorPtr rrelu_with_noise(const XLATensorPtr& input, XLATensorPtr& noise,
                               const at::Scalar& lower, const at::Scalar& upper,
                               bool training) {
-  torch::lazy::NodePtr output_node = torch::lazy::MakeNode<RreluWithNoise>(
+  torch::lazy::NodePtr output_node = MakeXlaNode<RreluWithNoise>(
       input->GetIrValue(),
       XLAGraphExecutor::Get()->GetRngSeed(input->GetDevice()), lower, upper,
       training);
@@ -2637,7 +2632,7 @@ XLATensorPtr rrelu_with_noise_backward(const XLATensorPtr& grad_output,
                                        const XLATensorPtr& noise,
                                        const at::Scalar& lower,
                                        const at::Scalar& upper, bool training) {
-  return grad_output->CreateFrom(torch::lazy::MakeNode<RreluWithNoiseBackward>(
+  return grad_output->CreateFrom(MakeXlaNode<RreluWithNoiseBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), noise->GetIrValue(),
       lower, upper, training));
 }
@@ -2682,8 +2677,8 @@ void copy_(XLATensorPtr& input, XLATensorPtr& src) {
     if (input->dtype() == src->dtype()) {
       copy_value = src->GetIrValue();
     } else {
-      copy_value = torch::lazy::MakeNode<Cast>(src->GetIrValue(),
-                                               input->dtype(), src->dtype());
+      copy_value = MakeXlaNode<Cast>(src->GetIrValue(), input->dtype(),
+                                     src->dtype());
     }
     input->SetIrValue(MaybeExpand(copy_value, input->shape()));
   } else {
@@ -2705,7 +2700,7 @@ void copy_(XLATensorPtr& input, XLATensorPtr& src) {
 
 XLATensorPtr scatter(const XLATensorPtr& input, int64_t dim,
                      const XLATensorPtr& index, const XLATensorPtr& src) {
-  return input->CreateFrom(torch::lazy::MakeNode<Scatter>(
+  return input->CreateFrom(MakeXlaNode<Scatter>(
       input->GetIrValue(), index->GetIrValue(), src->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndex(dim,
                                               input->shape().get().rank())));
@@ -2715,7 +2710,7 @@ XLATensorPtr scatter(const XLATensorPtr& input, int64_t dim,
                      const XLATensorPtr& index, const at::Scalar& value) {
   torch::lazy::Value constant = XLAGraphExecutor::Get()->GetIrValueForScalar(
       value, input->shape(), input->GetDevice());
-  return input->CreateFrom(torch::lazy::MakeNode<Scatter>(
+  return input->CreateFrom(MakeXlaNode<Scatter>(
       input->GetIrValue(), index->GetIrValue(), constant,
       torch::lazy::GetCanonicalDimensionIndex(dim,
                                               input->shape().get().rank())));
@@ -2723,7 +2718,7 @@ XLATensorPtr scatter(const XLATensorPtr& input, int64_t dim,
 
 XLATensorPtr scatter_add(const XLATensorPtr& input, int64_t dim,
                          const XLATensorPtr& index, const XLATensorPtr& src) {
-  return input->CreateFrom(torch::lazy::MakeNode<ScatterAdd>(
+  return input->CreateFrom(MakeXlaNode<ScatterAdd>(
       input->GetIrValue(), index->GetIrValue(), src->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndex(dim,
                                               input->shape().get().rank())));
@@ -2733,7 +2728,7 @@ XLATensorPtr scatter_add(const XLATensorPtr& input, int64_t dim,
                          const XLATensorPtr& index, const at::Scalar& value) {
   torch::lazy::Value constant = XLAGraphExecutor::Get()->GetIrValueForScalar(
       value, input->shape(), input->GetDevice());
-  return input->CreateFrom(torch::lazy::MakeNode<ScatterAdd>(
+  return input->CreateFrom(MakeXlaNode<ScatterAdd>(
       input->GetIrValue(), index->GetIrValue(), constant,
       torch::lazy::GetCanonicalDimensionIndex(dim,
                                               input->shape().get().rank())));
@@ -2742,7 +2737,7 @@ XLATensorPtr scatter_add(const XLATensorPtr& input, int64_t dim,
 XLATensorPtr scatter_reduce(const XLATensorPtr& input, int64_t dim,
                             const XLATensorPtr& index, const XLATensorPtr& src,
                             c10::string_view reduce, bool include_self) {
-  return input->CreateFrom(torch::lazy::MakeNode<ScatterReduce>(
+  return input->CreateFrom(MakeXlaNode<ScatterReduce>(
       input->GetIrValue(), index->GetIrValue(), src->GetIrValue(), reduce,
       include_self,
       torch::lazy::GetCanonicalDimensionIndex(dim,
@@ -2777,7 +2772,7 @@ XLATensorPtr slice(const XLATensorPtr& input, int64_t dim, int64_t start,
     // `GetCanonicalDimensionIndex` doesn't support case where dim size = 0.
     // So we add a special handling in torch_xla.
     return input->CreateFrom(
-        torch::lazy::MakeNode<Select>(input->GetIrValue(), dim, 0, 0, step));
+        MakeXlaNode<Select>(input->GetIrValue(), dim, 0, 0, step));
   }
   start = torch::lazy::GetCanonicalPosition(input_dims, dim, start);
   end = torch::lazy::GetCanonicalPosition(input_dims, dim, end);
@@ -2793,7 +2788,7 @@ XLATensorPtr slice(const XLATensorPtr& input, int64_t dim, int64_t start,
     ViewInfo view_info(ViewInfo::Type::kSelect, input_shape, std::move(select));
     return input->CreateViewTensor(std::move(view_info));
   }
-  return input->CreateFrom(torch::lazy::MakeNode<Select>(
+  return input->CreateFrom(MakeXlaNode<Select>(
       input->GetIrValue(), dim, start, end, step));
 }
 
@@ -2824,10 +2819,10 @@ XLATensorPtr softmax(const XLATensorPtr& input, int64_t dim,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<Softmax>(input->GetIrValue(),
-                                     torch::lazy::GetCanonicalDimensionIndex(
-                                         dim, input->shape().get().rank()),
-                                     dtype),
+      MakeXlaNode<Softmax>(input->GetIrValue(),
+                           torch::lazy::GetCanonicalDimensionIndex(
+                               dim, input->shape().get().rank()),
+                           dtype),
       dtype);
 }
 
@@ -2866,13 +2861,13 @@ std::vector<XLATensorPtr> split(const XLATensorPtr& input, int64_t split_size,
     // no matter what split_size is.
     xla::Literal literal(input_shape.get());
     return {
-        input->CreateFrom(torch::lazy::MakeNode<Constant>(std::move(literal)))};
+        input->CreateFrom(MakeXlaNode<Constant>(std::move(literal)))};
   }
   std::vector<int64_t> split_sizes;
   for (; dim_size > 0; dim_size -= split_size) {
     split_sizes.push_back(std::min<int64_t>(dim_size, split_size));
   }
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<Split>(
+  torch::lazy::NodePtr node = MakeXlaNode<Split>(
       input->GetIrValue(), std::move(split_sizes), split_dim);
   return input->MakeOutputTensors(node);
 }
@@ -2883,7 +2878,7 @@ std::vector<XLATensorPtr> split_with_sizes(const XLATensorPtr& input,
   auto input_shape = input->shape();
   int split_dim =
       torch::lazy::GetCanonicalDimensionIndex(dim, input_shape.get().rank());
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<Split>(
+  torch::lazy::NodePtr node = MakeXlaNode<Split>(
       input->GetIrValue(), std::move(split_size), split_dim);
   return input->MakeOutputTensors(node);
 }
@@ -2932,12 +2927,12 @@ XLATensorPtr stack(absl::Span<const XLATensorPtr> tensors, int64_t dim) {
   int64_t canonical_dim = torch::lazy::GetCanonicalDimensionIndex(
       dim, tensors.front()->shape().get().rank() + 1);
   return tensors[0]->CreateFrom(
-      torch::lazy::MakeNode<Stack>(values, canonical_dim));
+      MakeXlaNode<Stack>(values, canonical_dim));
 }
 
 XLATensorPtr std(const XLATensorPtr& input, std::vector<int64_t> dimensions,
                  bool keep_reduced_dimensions, double correction) {
-  return input->CreateFrom(torch::lazy::MakeNode<Std>(
+  return input->CreateFrom(MakeXlaNode<Std>(
       input->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndices(
           torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -2949,7 +2944,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> std_mean(const XLATensorPtr& input,
                                                 std::vector<int64_t> dimensions,
                                                 double correction,
                                                 bool keep_reduced_dimensions) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<StdMean>(
+  torch::lazy::NodePtr node = MakeXlaNode<StdMean>(
       input->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndices(
           torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -3007,7 +3002,7 @@ XLATensorPtr sum(const XLATensorPtr& input, std::vector<int64_t> dimensions,
     dtype = input->dtype_optional();
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<Sum>(
+      MakeXlaNode<Sum>(
           input->GetIrValue(),
           torch::lazy::GetCanonicalDimensionIndices(
               torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -3019,7 +3014,7 @@ XLATensorPtr sum(const XLATensorPtr& input, std::vector<int64_t> dimensions,
 std::tuple<XLATensorPtr, XLATensorPtr, XLATensorPtr> svd(
     const XLATensorPtr& input, bool some, bool compute_uv) {
   torch::lazy::NodePtr node =
-      torch::lazy::MakeNode<SVD>(input->GetIrValue(), some, compute_uv);
+      MakeXlaNode<SVD>(input->GetIrValue(), some, compute_uv);
   return std::make_tuple(input->CreateFrom(torch::lazy::Value(node, 0)),
                          input->CreateFrom(torch::lazy::Value(node, 1)),
                          input->CreateFrom(torch::lazy::Value(node, 2)));
@@ -3033,12 +3028,12 @@ XLATensorPtr tanh_backward(const XLATensorPtr& grad_output,
 XLATensorPtr threshold(const XLATensorPtr& input, float threshold,
                        float value) {
   return input->CreateFrom(
-      torch::lazy::MakeNode<Threshold>(input->GetIrValue(), threshold, value));
+      MakeXlaNode<Threshold>(input->GetIrValue(), threshold, value));
 }
 
 XLATensorPtr threshold_backward(const XLATensorPtr& grad_output,
                                 const XLATensorPtr& input, float threshold) {
-  return grad_output->CreateFrom(torch::lazy::MakeNode<ThresholdBackward>(
+  return grad_output->CreateFrom(MakeXlaNode<ThresholdBackward>(
       grad_output->GetIrValue(), input->GetIrValue(), threshold));
 }
 
@@ -3067,7 +3062,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> topk(const XLATensorPtr& input,
                                             int64_t k, int64_t dim,
                                             bool largest, bool sorted,
                                             bool stable) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<TopK>(
+  torch::lazy::NodePtr node = MakeXlaNode<TopK>(
       input->GetIrValue(), k,
       torch::lazy::GetCanonicalDimensionIndex(dim, input->shape().get().rank()),
       largest, sorted, stable);
@@ -3115,7 +3110,7 @@ XLATensorPtr transpose(const XLATensorPtr& input, int64_t dim0, int64_t dim1) {
     std::vector<int64_t> permute_dims = torch::lazy::MakeTransposePermutation(
         /*dim0=*/dim0, /*dim1=*/dim1, /*rank=*/input_shape.get().rank());
     result = input->CreateFrom(
-        torch::lazy::MakeNode<Permute>(input->GetIrValue(), permute_dims));
+        MakeXlaNode<Permute>(input->GetIrValue(), permute_dims));
   }
 
   return result;
@@ -3125,7 +3120,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> triangular_solve(
     const XLATensorPtr& rhs, const XLATensorPtr& lhs, bool left_side,
     bool upper, bool transpose, bool unitriangular) {
   // TriangularSolve takes lower instead of upper, hence the negation.
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<TriangularSolve>(
+  torch::lazy::NodePtr node = MakeXlaNode<TriangularSolve>(
       rhs->GetIrValue(), lhs->GetIrValue(), left_side, !upper, transpose,
       unitriangular);
   return std::make_tuple(rhs->CreateFrom(torch::lazy::Value(node, 0)),
@@ -3147,7 +3142,7 @@ std::vector<XLATensorPtr> unbind(const XLATensorPtr& input, int64_t dim) {
 void uniform_(XLATensorPtr& input, double from, double to) {
   XLA_CHECK_LE(from, to);
   auto input_shape = input->shape();
-  input->SetInPlaceIrValue(torch::lazy::MakeNode<Uniform>(
+  input->SetInPlaceIrValue(MakeXlaNode<Uniform>(
       XLAGraphExecutor::Get()->GetIrValueForScalar(
           from, input_shape.get().element_type(), input->GetDevice()),
       XLAGraphExecutor::Get()->GetIrValueForScalar(
@@ -3168,13 +3163,13 @@ void unsqueeze_(XLATensorPtr& input, int64_t dim) {
   int squeeze_dim = torch::lazy::GetCanonicalDimensionIndex(
       dim, input->shape().get().rank() + 1);
   input->SetIrValue(
-      torch::lazy::MakeNode<Unsqueeze>(input->GetIrValue(), squeeze_dim));
+      MakeXlaNode<Unsqueeze>(input->GetIrValue(), squeeze_dim));
 }
 
 XLATensorPtr upsample_bilinear2d(const XLATensorPtr& input,
                                  std::vector<int64_t> output_size,
                                  bool align_corners) {
-  return input->CreateFrom(torch::lazy::MakeNode<UpsampleBilinear>(
+  return input->CreateFrom(MakeXlaNode<UpsampleBilinear>(
       input->GetIrValue(), std::move(output_size), align_corners));
 }
 
@@ -3183,21 +3178,21 @@ XLATensorPtr upsample_bilinear2d_backward(const XLATensorPtr& grad_output,
                                           std::vector<int64_t> input_size,
                                           bool align_corners) {
   return grad_output->CreateFrom(
-      torch::lazy::MakeNode<UpsampleBilinearBackward>(
+      MakeXlaNode<UpsampleBilinearBackward>(
           grad_output->GetIrValue(), std::move(output_size),
           std::move(input_size), align_corners));
 }
 
 XLATensorPtr upsample_nearest2d(const XLATensorPtr& input,
                                 std::vector<int64_t> output_size) {
-  return input->CreateFrom(torch::lazy::MakeNode<UpsampleNearest>(
+  return input->CreateFrom(MakeXlaNode<UpsampleNearest>(
       input->GetIrValue(), std::move(output_size)));
 }
 
 XLATensorPtr upsample_nearest2d_backward(const XLATensorPtr& grad_output,
                                          std::vector<int64_t> output_size,
                                          std::vector<int64_t> input_size) {
-  return grad_output->CreateFrom(torch::lazy::MakeNode<UpsampleNearestBackward>(
+  return grad_output->CreateFrom(MakeXlaNode<UpsampleNearestBackward>(
       grad_output->GetIrValue(), std::move(output_size),
       std::move(input_size)));
 }
@@ -3226,7 +3221,7 @@ XLATensorPtr view(const XLATensorPtr& input,
     ViewInfo view_info(ViewInfo::Type::kReshape, std::move(shape), input_shape);
     return input->CreateViewTensor(std::move(view_info));
   }
-  return input->CreateFrom(torch::lazy::MakeNode<ViewOp>(
+  return input->CreateFrom(MakeXlaNode<ViewOp>(
       input->GetIrValue(), torch::lazy::ToVector<int64_t>(shape.dimensions())));
 }
 
@@ -3246,7 +3241,7 @@ XLATensorPtr view_symint(const XLATensorPtr& input,
     return input->CreateViewTensor(std::move(view_info));
   }
   return input->CreateFrom(
-      torch::lazy::MakeNode<ViewOp>(input->GetIrValue(), result_shape));
+      MakeXlaNode<ViewOp>(input->GetIrValue(), result_shape));
 }
 
 XLATensorPtr view_as_complex_copy(const XLATensorPtr& input) {
@@ -3261,7 +3256,7 @@ XLATensorPtr view_as_real_copy(const XLATensorPtr& input) {
 
 XLATensorPtr var(const XLATensorPtr& input, std::vector<int64_t> dimensions,
                  double correction, bool keep_reduced_dimensions) {
-  return input->CreateFrom(torch::lazy::MakeNode<Var>(
+  return input->CreateFrom(MakeXlaNode<Var>(
       input->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndices(
           torch_xla::runtime::util::ToVector<int64_t>(dimensions),
@@ -3273,7 +3268,7 @@ std::tuple<XLATensorPtr, XLATensorPtr> var_mean(const XLATensorPtr& input,
                                                 std::vector<int64_t> dimensions,
                                                 double correction,
                                                 bool keep_reduced_dimensions) {
-  torch::lazy::NodePtr node = torch::lazy::MakeNode<VarMean>(
+  torch::lazy::NodePtr node = MakeXlaNode<VarMean>(
       input->GetIrValue(),
       torch::lazy::GetCanonicalDimensionIndices(
           torch_xla::runtime::util::ToVector<int64_t>(dimensions),
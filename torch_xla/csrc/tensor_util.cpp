@@ -6,8 +6,10 @@
 #include <torch/csrc/lazy/core/util.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <functional>
+#include <future>
 #include <list>
 #include <numeric>
 #include <thread>
@@ -19,10 +21,12 @@
 #include "torch_xla/csrc/layout_manager.h"
 #include "torch_xla/csrc/ops/device_data.h"
 #include "torch_xla/csrc/runtime/computation_client.h"
+#include "torch_xla/csrc/runtime/convert_kernels.h"
 #include "torch_xla/csrc/runtime/debug_macros.h"
 #include "torch_xla/csrc/runtime/runtime.h"
 #include "torch_xla/csrc/runtime/sys_util.h"
 #include "torch_xla/csrc/runtime/tf_logging.h"
+#include "torch_xla/csrc/runtime/tiled_copy.h"
 #include "torch_xla/csrc/runtime/util.h"
 #include "torch_xla/csrc/thread_pool.h"
 #include "torch_xla/csrc/torch_util.h"
@@ -155,18 +159,6 @@ void StridedCopy(D* dest, int64_t dest_stride, const S* source,
   }
 }
 
-// Computes the offset of the value at a given index, assuming a contiguous/flat
-// tensor data representation.
-template <typename S>
-int64_t GetFlatTensorOffset(const S& strides,
-                            const std::vector<int64_t>& indices) {
-  int64_t base = 0;
-  for (size_t i = 0; i < indices.size(); ++i) {
-    base += indices[i] * strides[i];
-  }
-  return base;
-}
-
 // The tsl::bfloat16 does not have implicit cast operations, so using
 // std::copy() for it, is not going to work.
 struct CopyDirect {};
@@ -249,96 +241,106 @@ void CopyData<tsl::bfloat16, at::BFloat16>(tsl::bfloat16* dest,
   CheckedMemcpy<tsl::bfloat16, at::BFloat16>(dest, source, n);
 }
 
-std::vector<int64_t> GetIterationDimensions(const xla::Shape& shape) {
-  // We want to favor the most minor dimension as core iteration dimension, as
-  // this walks one of the two tensors buffers in a cache friendly fashion.
-  // Though, if the most minor dimension is too small, we will end up doing more
-  // StridedCopy() iterations in CopyTensors().
-  // So we select the most minor dimension, unless one of the other dimensions
-  // is more than kMinorDimScale times the most minor one.
-  static const int64_t kMinorDimScale = 8;
-  std::vector<int64_t> iter_dims =
-      torch::lazy::ToVector<int64_t>(shape.layout().minor_to_major());
-  size_t index = 0;
-  int64_t scaled_dim_size = kMinorDimScale * shape.dimensions(iter_dims[index]);
-  for (size_t i = 1; i < iter_dims.size(); ++i) {
-    int64_t dim = iter_dims[i];
-    if (shape.dimensions(dim) > scaled_dim_size) {
-      index = i;
-      scaled_dim_size = shape.dimensions(dim);
-    }
-  }
-  std::swap(iter_dims[0], iter_dims[index]);
-  return iter_dims;
-}
-
-struct CopyPartition {
-  explicit CopyPartition(absl::Span<const int64_t> dimensions)
-      : base(dimensions.size()), limit(dimensions.begin(), dimensions.end()) {}
-
-  std::vector<int64_t> base;
-  std::vector<int64_t> limit;
-};
-
-std::vector<CopyPartition> CreateCopyPartitions(
-    absl::Span<const int64_t> dimensions, int64_t strided_copy_dimension) {
-  // The minimum number of elements copy that can be assigned to a thread.
-  static const int64_t kMinThreadElements = 100000;
+// Converts n elements with one of the runtime::ConvertKernels. Large buffers
+// are split in blocks converted in parallel, as a single core cannot saturate
+// the memory bandwidth.
+template <typename D, typename S, typename KD, typename KS>
+void ConvertData(D* dest, const S* source, int64_t n,
+                 void (*kernel)(const KS*, KD*, int64_t)) {
+  static_assert(sizeof(S) == sizeof(KS) && sizeof(D) == sizeof(KD),
+                "Types size mismatch");
+  // The minimum number of elements converted by a thread.
+  static const int64_t kMinBlockElements = 256 * 1024;
+  // Block boundaries are kept aligned to this number of elements, so that
+  // threads do not write to the same cache lines.
+  static const int64_t kBlockAlignment = 64;
+  const KS* kernel_source = reinterpret_cast<const KS*>(source);
+  KD* kernel_dest = reinterpret_cast<KD*>(dest);
   // Use at most 50% of the available cores.
   int64_t max_parts =
       std::max<int64_t>(std::thread::hardware_concurrency() / 2, 1);
-  // Find the maximum dimension which is not the strided copy dimension.
-  int64_t max_dim = -1;
-  for (int64_t i = 0; i < dimensions.size(); ++i) {
-    if (i != strided_copy_dimension &&
-        (max_dim < 0 || dimensions[i] > dimensions[max_dim])) {
-      max_dim = i;
-    }
+  int64_t num_parts = std::min<int64_t>(max_parts, n / kMinBlockElements);
+  if (num_parts <= 1) {
+    kernel(kernel_source, kernel_dest, n);
+    return;
   }
-
-  int64_t num_elements = runtime::util::Multiply<int64_t>(dimensions);
-  int64_t max_dim_unit_elements = num_elements / dimensions[max_dim];
-  int64_t max_dim_size = dimensions[max_dim];
-  int64_t part_size =
-      std::max<int64_t>(std::max<int64_t>(max_dim_size / max_parts, 1),
-                        kMinThreadElements / max_dim_unit_elements);
-  std::vector<CopyPartition> parts;
-  int64_t csize = 0;
-  while (csize < max_dim_size) {
-    int64_t n = std::min<int64_t>(part_size, max_dim_size - csize);
-    CopyPartition p(dimensions);
-    p.base[max_dim] = csize;
-    p.limit[max_dim] = csize + n;
-    csize += n;
-    parts.emplace_back(std::move(p));
+  int64_t block_size = (n + num_parts - 1) / num_parts;
+  block_size =
+      (block_size + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+  num_parts = (n + block_size - 1) / block_size;
+  absl::BlockingCounter counter(num_parts);
+  for (int64_t i = 0; i < num_parts; ++i) {
+    auto convert_fn = [&, i]() {
+      int64_t start = i * block_size;
+      kernel(kernel_source + start, kernel_dest + start,
+             std::min<int64_t>(block_size, n - start));
+      counter.DecrementCount();
+    };
+    thread::Schedule(std::move(convert_fn));
   }
-  return parts;
+  counter.Wait();
 }
 
-template <typename SType, typename DType>
-void SlicedCopy(absl::Span<const int64_t> dimensions, const SType* src_data,
-                absl::Span<const int64_t> src_strides, DType* dest_data,
-                absl::Span<const int64_t> dest_strides,
-                absl::Span<const int64_t> iter_dims,
-                const CopyPartition& part) {
-  std::vector<int64_t> indices(part.base);
-  int64_t inner_src_stride = src_strides[iter_dims.front()];
-  int64_t inner_dest_stride = dest_strides[iter_dims.front()];
-  int64_t n = 0;
-  while (n < indices.size()) {
-    StridedCopy(dest_data + GetFlatTensorOffset(dest_strides, indices),
-                inner_dest_stride,
-                src_data + GetFlatTensorOffset(src_strides, indices),
-                inner_src_stride, dimensions[iter_dims.front()]);
-    for (n = 1; n < indices.size(); ++n) {
-      int64_t dim = iter_dims[n];
-      indices[dim] += 1;
-      if (indices[dim] < part.limit[dim]) {
-        break;
-      }
-      indices[dim] = part.base[dim];
-    }
-  }
+// Routes the conversions which have a vectorized kernel to it.
+template <>
+void CopyData<tsl::bfloat16, float>(tsl::bfloat16* dest, const float* source,
+                                    int64_t n, const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().float_to_bfloat16);
+}
+template <>
+void CopyData<at::BFloat16, float>(at::BFloat16* dest, const float* source,
+                                   int64_t n, const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().float_to_bfloat16);
+}
+template <>
+void CopyData<float, tsl::bfloat16>(float* dest, const tsl::bfloat16* source,
+                                    int64_t n, const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().bfloat16_to_float);
+}
+template <>
+void CopyData<float, at::BFloat16>(float* dest, const at::BFloat16* source,
+                                   int64_t n, const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().bfloat16_to_float);
+}
+template <>
+void CopyData<xla::half, float>(xla::half* dest, const float* source,
+                                int64_t n, const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().float_to_half);
+}
+template <>
+void CopyData<at::Half, float>(at::Half* dest, const float* source, int64_t n,
+                               const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().float_to_half);
+}
+template <>
+void CopyData<float, xla::half>(float* dest, const xla::half* source,
+                                int64_t n, const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().half_to_float);
+}
+template <>
+void CopyData<float, at::Half>(float* dest, const at::Half* source, int64_t n,
+                               const CopyCasted&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().half_to_float);
+}
+template <>
+void CopyData<float, double>(float* dest, const double* source, int64_t n,
+                             const CopyDirect&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().double_to_float);
+}
+template <>
+void CopyData<int32_t, int64_t>(int32_t* dest, const int64_t* source,
+                                int64_t n, const CopyDirect&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().int64_to_int32);
+}
+template <>
+void CopyData<bool, uint8_t>(bool* dest, const uint8_t* source, int64_t n,
+                             const CopyDirect&) {
+  ConvertData(dest, source, n, runtime::GetConvertKernels().uint8_to_bool);
+}
+template <>
+void CopyData<uint8_t, bool>(uint8_t* dest, const bool* source, int64_t n,
+                             const CopyDirect&) {
+  CheckedMemcpy<uint8_t, bool>(dest, source, n);
 }
 
 template <typename SType, typename DType>
@@ -359,19 +361,40 @@ void CopyTensors(const void* src_buffer, const xla::Shape& src_shape,
                            typename CopyType < NeedCast<SType>::value ||
                                NeedCast<DType>::value > ::type());
   } else if (total_elements > 0) {
-    // We issue a multi-threaded copy by slicing the bigger dimension and
-    // assigning its copy to different threads. This code is only valid for
-    // ranks >= 2, but the layout check above covers the case.
-    std::vector<int64_t> src_strides = ComputeShapeStrides(src_shape);
-    std::vector<int64_t> dest_strides = ComputeShapeStrides(dest_shape);
-    std::vector<int64_t> iter_dims = GetIterationDimensions(dest_shape);
-    std::vector<CopyPartition> parts =
-        CreateCopyPartitions(dest_shape.dimensions(), iter_dims.front());
-    absl::BlockingCounter counter(parts.size());
-    for (size_t i = 0; i < parts.size(); ++i) {
+    // Layout changing copies are done tile by tile, so that both buffers are
+    // walked in a cache friendly fashion, and the tiles are split among
+    // threads for big tensors.
+    static const int64_t kTileRowBytes = 256;
+    // The minimum number of elements copy that can be assigned to a thread.
+    static const int64_t kMinThreadElements = 100000;
+    int64_t element_size = std::max(sizeof(SType), sizeof(DType));
+    int64_t tile_size = std::max<int64_t>(kTileRowBytes / element_size, 16);
+    runtime::TiledCopyPlan plan(
+        dest_shape.dimensions(), ComputeShapeStrides(src_shape),
+        ComputeShapeStrides(dest_shape), tile_size);
+    int64_t src_stride = plan.row_src_stride();
+    int64_t dest_stride = plan.row_dest_stride();
+    auto copy_tiles = [&](int64_t begin, int64_t end) {
+      plan.ForEachRow(begin, end, [&](int64_t dest_offset, int64_t src_offset,
+                                      int64_t n) {
+        StridedCopy(dest_data + dest_offset, dest_stride,
+                    src_data + src_offset, src_stride, n);
+      });
+    };
+    // Use at most 50% of the available cores.
+    int64_t max_parts =
+        std::max<int64_t>(std::thread::hardware_concurrency() / 2, 1);
+    int64_t num_tiles = plan.num_tiles();
+    int64_t num_parts = std::min<int64_t>(
+        {max_parts, total_elements / kMinThreadElements, num_tiles});
+    if (num_parts <= 1) {
+      copy_tiles(0, num_tiles);
+      return;
+    }
+    absl::BlockingCounter counter(num_parts);
+    for (int64_t i = 0; i < num_parts; ++i) {
       auto copy_fn = [&, i]() {
-        SlicedCopy<SType, DType>(dest_shape.dimensions(), src_data, src_strides,
-                                 dest_data, dest_strides, iter_dims, parts[i]);
+        copy_tiles(num_tiles * i / num_parts, num_tiles * (i + 1) / num_parts);
         counter.DecrementCount();
       };
       thread::Schedule(std::move(copy_fn));
@@ -745,11 +768,8 @@ std::vector<torch::lazy::BackendDataPtr> CreateTensorsData(
       // Shards the input tensors with padding, to split evenly.
       // The execution requires consistent shard sizes, and the zero-padded
       // values should be ignored.
-      std::vector<at::Tensor> local_shards =
-          ShardingUtil::ShardTensor(tensors[i], shardings[i], local_devices,
-                                    /*padded=*/true);
-      new_handles.push_back(ShardingUtil::CreateShardedData(
-          local_shards, local_devices, shardings[i]));
+      new_handles.push_back(ShardingUtil::ShardAndTransferTensor(
+          tensors[i], shardings[i], local_devices));
     } else {
       source_tensors.push_back(std::make_shared<runtime::AtenSource>(
           tensors[i], std::move(shape), devices[i]));
@@ -818,6 +838,72 @@ std::vector<at::Tensor> XlaDataToTensors(
   return tensors;
 }
 
+TensorFuture::TensorFuture(std::shared_future<void> transfer,
+                           at::Tensor tensor, at::ScalarType dest_element_type)
+    : transfer_(std::move(transfer)),
+      tensor_(std::move(tensor)),
+      dest_element_type_(dest_element_type) {}
+
+bool TensorFuture::IsReady() const {
+  return transfer_.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+at::Tensor TensorFuture::Get() const {
+  transfer_.get();
+  if (tensor_.scalar_type() == dest_element_type_) {
+    return tensor_;
+  }
+  return tensor_.to(dest_element_type_);
+}
+
+std::vector<TensorFuture> XlaDataToTensorsAsync(
+    absl::Span<const torch::lazy::BackendDataPtr> xla_data,
+    absl::Span<const at::ScalarType> dest_element_type) {
+  XLA_CHECK_EQ(xla_data.size(), dest_element_type.size());
+  std::vector<runtime::ComputationClient::DataPtr> handles =
+      UnwrapXlaData(xla_data);
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(handles.size());
+  std::vector<runtime::ComputationClient::DataPtr> transfer_handles;
+  std::vector<xla::MutableBorrowingLiteral> destinations;
+  for (auto& handle : handles) {
+    const xla::Shape& shape = handle->shape();
+    at::Tensor& tensor = tensors.emplace_back(at::empty(
+        XlaHelpers::I64List(shape.dimensions()),
+        at::TensorOptions(TorchTypeFromXlaType(shape.element_type()))));
+    if (tensor.numel() > 0) {
+      // The tensor memory is row-major, which the runtime converts to while
+      // copying out of the device.
+      xla::Shape host_shape = MakeTorchTensorLayout(
+          shape.dimensions(), /*dynamic_dimensions=*/{}, shape.element_type());
+      destinations.emplace_back(static_cast<const char*>(tensor.data_ptr()),
+                                host_shape);
+      transfer_handles.push_back(handle);
+    }
+  }
+  std::vector<std::shared_future<void>> transfers =
+      runtime::GetComputationClient()->TransferFromDeviceAsync(
+          transfer_handles, std::move(destinations));
+
+  std::vector<TensorFuture> futures;
+  futures.reserve(tensors.size());
+  size_t transfer_index = 0;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    std::shared_future<void> transfer;
+    if (tensors[i].numel() > 0) {
+      transfer = transfers[transfer_index++];
+    } else {
+      std::promise<void> promise;
+      promise.set_value();
+      transfer = promise.get_future().share();
+    }
+    futures.emplace_back(std::move(transfer), std::move(tensors[i]),
+                         dest_element_type[i]);
+  }
+  return futures;
+}
+
 torch::lazy::hash_t TensorHash(const at::Tensor& tensor) {
   at::Tensor ctensor = tensor.contiguous();
   int64_t size = ctensor.numel() * ctensor.element_size();
@@ -5,6 +5,7 @@
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/lazy/core/hash.h>
 
+#include <future>
 #include <string>
 #include <vector>
 
@@ -36,6 +37,31 @@ std::vector<at::Tensor> XlaDataToTensors(
     absl::Span<const torch::lazy::BackendDataPtr> xla_data,
     absl::Span<const at::ScalarType> dest_element_type);
 
+// A tensor being transferred from the device by XlaDataToTensorsAsync().
+class TensorFuture {
+ public:
+  TensorFuture(std::shared_future<void> transfer, at::Tensor tensor,
+               at::ScalarType dest_element_type);
+
+  // Whether the transfer has completed, in which case Get() won't block.
+  bool IsReady() const;
+
+  // Waits for the transfer to complete, and returns the tensor.
+  at::Tensor Get() const;
+
+ private:
+  std::shared_future<void> transfer_;
+  at::Tensor tensor_;
+  at::ScalarType dest_element_type_;
+};
+
+// Same as XlaDataToTensors(), but returns as soon as the transfers have been
+// issued. The device data is written directly into the memory of the returned
+// tensors, without going through an intermediate xla::Literal.
+std::vector<TensorFuture> XlaDataToTensorsAsync(
+    absl::Span<const torch::lazy::BackendDataPtr> xla_data,
+    absl::Span<const at::ScalarType> dest_element_type);
+
 bool TensorCompare(const at::Tensor& t1, const at::Tensor& t2);
 
 // Uploads an ATEN tensor data to the device and fetches the corresponding
@@ -17,5 +17,13 @@ void Schedule(std::function<void()> fn) {
   pool.Schedule(std::move(fn));
 }
 
+void ScheduleCompile(std::function<void()> fn) {
+  static size_t num_threads = torch_xla::runtime::sys_util::GetEnvInt(
+      "XLA_COMPILE_THREAD_POOL_SIZE", 1);
+  static tsl::thread::ThreadPool pool(tsl::Env::Default(), "pytorchxla_compile",
+                                      num_threads);
+  pool.Schedule(std::move(fn));
+}
+
 }  // namespace thread
 }  // namespace torch_xla
@@ -10,6 +10,10 @@ namespace thread {
 // events.
 void Schedule(std::function<void()> fn);
 
+// Schedules a compilation closure to be run on a dedicated pool, so that long
+// running compilations do not occupy the threads used by Schedule().
+void ScheduleCompile(std::function<void()> fn);
+
 }  // namespace thread
 }  // namespace torch_xla
 
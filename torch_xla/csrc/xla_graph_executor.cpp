@@ -20,6 +20,7 @@
 #include <mutex>
 #include <set>
 #include <stdexcept>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -28,10 +29,12 @@
 #include "absl/strings/str_join.h"
 #include "stablehlo/dialect/Serialization.h"  // from @stablehlo
 #include "torch_xla/csrc/aten_xla_bridge.h"
+#include "torch_xla/csrc/device_constant_pool.h"
 #include "torch_xla/csrc/dtype.h"
 #include "torch_xla/csrc/helpers.h"
 #include "torch_xla/csrc/ir_dump_util.h"
 #include "torch_xla/csrc/layout_manager.h"
+#include "torch_xla/csrc/node_pool.h"
 #include "torch_xla/csrc/ops/arithmetic_ir_ops.h"
 #include "torch_xla/csrc/ops/cast.h"
 #include "torch_xla/csrc/ops/device_data.h"
@@ -51,6 +54,7 @@
 #include "torch_xla/csrc/runtime/sys_util.h"
 #include "torch_xla/csrc/runtime/xla_util.h"
 #include "torch_xla/csrc/shape_helper.h"
+#include "torch_xla/csrc/step_timeline.h"
 #include "torch_xla/csrc/tensor_util.h"
 #include "torch_xla/csrc/thread_pool.h"
 #include "torch_xla/csrc/torch_util.h"
@@ -77,13 +81,198 @@ bool ShouldSyncIrValue(const torch::lazy::Value& ir_value) {
   return ir_value->op() != xla_not_supported;
 }
 
-XLAGraphExecutor::ComputationCache* CreateComputationCache() {
+// Always execute sharded when running in SPMD mode.
+bool IsShardedExecution(const torch::lazy::BackendDevice& device) {
+  return device == GetVirtualDevice() || UseVirtualDevice();
+}
+
+size_t GetMaxComputationCacheSize() {
   static const size_t kMaxCacheSize =
       runtime::sys_util::GetEnvInt("XLA_COMPILATION_CACHE_SIZE", 2048);
+  return kMaxCacheSize;
+}
+
+using CompileRecipeCache =
+    runtime::util::Cache<torch::lazy::hash_t,
+                         const XLAGraphExecutor::CompileRecipe,
+                         torch::lazy::HashReducer>;
+
+// Recipes of the graphs evicted from the computation cache, which are only
+// executed by hash and thus cannot be lowered again.
+CompileRecipeCache* GetEvictedRecipeCache() {
+  static CompileRecipeCache* cache =
+      new CompileRecipeCache(GetMaxComputationCacheSize());
+  return cache;
+}
+
+// The post order of a synced graph, recorded so that the post order of a later
+// graph with the same structure can be recovered from its roots, without a
+// full traversal. Training steps trace the same graph over and over.
+struct PostOrderPlan {
+  // The roots the plan was recorded from. While they are alive, the recorded
+  // graph is unchanged, since IR nodes are immutable.
+  std::vector<std::weak_ptr<torch::lazy::Node>> roots;
+  // Only dereferenced while `roots` are alive.
+  std::vector<const torch::lazy::Node*> post_order;
+  std::vector<torch::lazy::hash_t> node_hashes;
+  // The positions of the operands of the i-th node of the post order are
+  // operand_positions[operand_begin[i], operand_begin[i + 1]).
+  std::vector<size_t> operand_begin;
+  std::vector<size_t> operand_positions;
+  std::vector<size_t> root_positions;
+  // The positions of the nodes holding device data.
+  std::vector<size_t> data_positions;
+  // The positions of the nodes whose hash is shared by another node. Only
+  // those can be merged into a single node in a graph with the same hashes.
+  std::vector<size_t> shared_hash_positions;
+};
+
+using PostOrderPlanCache =
+    runtime::util::Cache<torch::lazy::hash_t, const PostOrderPlan,
+                         torch::lazy::HashReducer>;
+
+PostOrderPlanCache* GetPostOrderPlanCache() {
+  static PostOrderPlanCache* cache = new PostOrderPlanCache(64);
+  return cache;
+}
+
+torch::lazy::hash_t GetRootsHash(
+    const std::vector<torch::lazy::Value>& ir_values) {
+  torch::lazy::hash_t hash = ir_values.size();
+  for (const torch::lazy::Value& ir_value : ir_values) {
+    hash = torch::lazy::HashCombine(hash, ir_value.hash());
+  }
+  return hash;
+}
+
+std::shared_ptr<const PostOrderPlan> RecordPostOrderPlan(
+    const std::vector<torch::lazy::Value>& ir_values,
+    const std::vector<const torch::lazy::Node*>& post_order) {
+  auto plan = std::make_shared<PostOrderPlan>();
+  plan->post_order = post_order;
+  std::unordered_map<const torch::lazy::Node*, size_t> positions;
+  std::unordered_map<torch::lazy::hash_t, size_t, torch::lazy::HashReducer>
+      hash_counts;
+  for (size_t i = 0; i < post_order.size(); ++i) {
+    const torch::lazy::Node* node = post_order[i];
+    positions.emplace(node, i);
+    plan->node_hashes.push_back(node->hash());
+    ++hash_counts[node->hash()];
+    plan->operand_begin.push_back(plan->operand_positions.size());
+    for (const torch::lazy::Output& operand : node->operands()) {
+      // Operands come before their users in the post order.
+      plan->operand_positions.push_back(positions.at(operand.node));
+    }
+    if (DeviceData::Cast(node) != nullptr) {
+      plan->data_positions.push_back(i);
+    }
+  }
+  plan->operand_begin.push_back(plan->operand_positions.size());
+  for (size_t i = 0; i < post_order.size(); ++i) {
+    if (hash_counts[plan->node_hashes[i]] > 1) {
+      plan->shared_hash_positions.push_back(i);
+    }
+  }
+  for (const torch::lazy::Value& ir_value : ir_values) {
+    plan->roots.push_back(ir_value.node);
+    plan->root_positions.push_back(positions.at(ir_value.node.get()));
+  }
+  return plan;
+}
+
+// Recovers the post order of the graph rooted at `ir_values` from the plan.
+// Returns false if the graph does not have the structure of the recorded one,
+// node sharing included, in which case it needs a full traversal.
+//
+// Node hashes do not depend on the data held by the device data nodes, so the
+// graph traced by each training step matches the plan recorded at the
+// previous step, although its nodes are new. Its post order is then rebuilt
+// from the recorded operand positions, which is still linear in the number of
+// nodes but skips the hash map lookups of the full traversal. The recorded
+// post order is only reused as is when the very same roots are synced again.
+bool ReplayPostOrderPlan(const PostOrderPlan& plan,
+                         const std::vector<torch::lazy::Value>& ir_values,
+                         std::vector<const torch::lazy::Node*>* post_order) {
+  if (ir_values.size() != plan.roots.size()) {
+    return false;
+  }
+  bool same_graph = true;
+  for (size_t i = 0; i < ir_values.size() && same_graph; ++i) {
+    same_graph = plan.roots[i].lock() == ir_values[i].node;
+  }
+  if (same_graph) {
+    // The roots are alive and held by `ir_values`, and so is the graph.
+    TORCH_LAZY_COUNTER("IncrementalPostOrderReuse", 1);
+    *post_order = plan.post_order;
+    return true;
+  }
+
+  post_order->assign(plan.post_order.size(), nullptr);
+  auto place = [&](size_t position, const torch::lazy::Node* node) {
+    const torch::lazy::Node*& slot = (*post_order)[position];
+    if (slot == nullptr && node->hash() == plan.node_hashes[position]) {
+      slot = node;
+    }
+    return slot == node;
+  };
+  for (size_t i = 0; i < ir_values.size(); ++i) {
+    if (!place(plan.root_positions[i], ir_values[i].node.get())) {
+      return false;
+    }
+  }
+  // Users come after their operands in the post order, so walking it
+  // backwards reaches every node from an already placed user.
+  for (size_t i = post_order->size(); i-- > 0;) {
+    const torch::lazy::Node* node = (*post_order)[i];
+    size_t begin = plan.operand_begin[i];
+    size_t end = plan.operand_begin[i + 1];
+    if (node == nullptr || node->operands().size() != end - begin) {
+      return false;
+    }
+    for (size_t j = begin; j < end; ++j) {
+      if (!place(plan.operand_positions[j], node->operand(j - begin).node)) {
+        return false;
+      }
+    }
+  }
+  // Distinct recorded nodes with the same hash could be a single node in the
+  // new graph, which would then appear twice.
+  std::vector<const torch::lazy::Node*> shared_hash_nodes;
+  shared_hash_nodes.reserve(plan.shared_hash_positions.size());
+  for (size_t position : plan.shared_hash_positions) {
+    shared_hash_nodes.push_back((*post_order)[position]);
+  }
+  std::sort(shared_hash_nodes.begin(), shared_hash_nodes.end());
+  if (std::adjacent_find(shared_hash_nodes.begin(), shared_hash_nodes.end()) !=
+      shared_hash_nodes.end()) {
+    return false;
+  }
+  TORCH_LAZY_COUNTER("IncrementalPostOrderReplay", 1);
+  return true;
+}
+
+runtime::ComputationClient::CompileInstance CopyCompileInstance(
+    const runtime::ComputationClient::CompileInstance& instance,
+    const xla::Shape* output_shape) {
+  return runtime::ComputationClient::CompileInstance(
+      xla::XlaComputation(instance.computation.proto()),
+      instance.compilation_device, instance.devices, output_shape,
+      instance.parameter_is_tupled_arguments, instance.is_sharded,
+      instance.allow_spmd_sharding_propagation_to_output,
+      instance.use_auto_spmd_partitioning, instance.auto_spmd_mesh_shape,
+      instance.auto_spmd_mesh_ids, instance.eager_mode);
+}
+
+XLAGraphExecutor::ComputationCache* CreateComputationCache() {
+  static const size_t kMaxCacheSize = GetMaxComputationCacheSize();
+  static const size_t kMaxCacheBytes =
+      runtime::sys_util::GetEnvInt("XLA_COMPILATION_CACHE_MAX_BYTES", 0);
   static const bool readonlyPersistentCache =
       runtime::sys_util::GetEnvBool("XLA_PERSISTENT_CACHE_READ_ONLY", false);
   static std::string persistentCacheDir =
       runtime::sys_util::GetEnvString("XLA_PERSISTENT_CACHE_PATH", "");
+  static const size_t kMaxPersistentCacheBytes =
+      runtime::sys_util::GetEnvInt("XLA_PERSISTENT_CACHE_MAX_BYTES", 0);
   if (!persistentCacheDir.empty()) {
     auto serialize_fn =
         [](XLAGraphExecutor::ComputationCache::TypePtr computation)
@@ -91,7 +280,7 @@ XLAGraphExecutor::ComputationCache* CreateComputationCache() {
       return runtime::GetComputationClient()->SerializeComputation(
           computation->computation);
     };
-    auto deserialize_fn = [](std::string serialization)
+    auto deserialize_fn = [](std::string_view serialization)
         -> XLAGraphExecutor::ComputationCache::TypePtr {
       runtime::ComputationClient::ComputationPtr computation =
           runtime::GetComputationClient()->DeserializeComputation(
@@ -109,7 +298,19 @@ XLAGraphExecutor::ComputationCache* CreateComputationCache() {
     }
     return new XLAGraphExecutor::PersistentCache(
         kMaxCacheSize, persistentCacheDir, readonlyPersistentCache,
-        serialize_fn, deserialize_fn);
+        serialize_fn, deserialize_fn, kMaxPersistentCacheBytes);
+  }
+  if (kMaxCacheBytes > 0) {
+    auto cost_fn = [](const XLAGraphExecutor::CachedComputation& computation) {
+      return XLAGraphExecutor::MemoryCache::EntryCost{
+          computation.memory_bytes(), computation.compile_seconds};
+    };
+    return new XLAGraphExecutor::MemoryCache(kMaxCacheSize, kMaxCacheBytes,
+                                             cost_fn);
+  }
+  if (runtime::sys_util::GetEnvBool("XLA_CONCURRENT_COMPILATION_CACHE",
+                                    false)) {
+    return new XLAGraphExecutor::ConcurrentMemoryCache(kMaxCacheSize);
   }
   return new XLAGraphExecutor::MemoryCache(kMaxCacheSize);
 }
@@ -273,9 +474,7 @@ torch::lazy::Value XLAGraphExecutor::GetDeviceDataIrValue(
     const torch::lazy::BackendDevice& device) {
   torch::lazy::BackendDataPtr data =
       GetDeviceData(value, MaybeUpcastToHostTorchType(type), device);
-  data->SetInfo(
-      std::make_shared<torch::lazy::LazyGraphExecutor::DeviceDataInfo>(
-          /*tensor_id=*/-1, /*read_only=*/true));
+  MarkSharedDeviceData(data);
   return torch::lazy::MakeNode<DeviceData>(std::move(data));
 }
 
@@ -300,8 +499,8 @@ torch::lazy::Value XLAGraphExecutor::GetIrValueForScalar(
     const torch::lazy::BackendDevice& device) {
   torch::lazy::Value ir_value = GetIrValueForScalar(value, type, device);
   if (!dimensions.empty()) {
-    ir_value = torch::lazy::MakeNode<Expand>(
-        ir_value, torch::lazy::ToVector<int64_t>(dimensions));
+    ir_value = MakeXlaNode<Expand>(ir_value,
+                                   torch::lazy::ToVector<int64_t>(dimensions));
   }
   return ir_value;
 }
@@ -311,7 +510,7 @@ torch::lazy::Value XLAGraphExecutor::GetIrValueForScalar(
     c10::SymIntArrayRef sym_size, const torch::lazy::BackendDevice& device) {
   torch::lazy::Value ir_value = GetIrValueForScalar(value, type, device);
   SymIntElements size_elements = SymIntElements(sym_size);
-  return torch::lazy::MakeNode<ExpandSymInt>(ir_value, size_elements);
+  return MakeXlaNode<ExpandSymInt>(ir_value, size_elements);
 }
 
 torch::lazy::Value XLAGraphExecutor::GetIrValueForScalar(
@@ -343,7 +542,7 @@ torch::lazy::Value XLAGraphExecutor::GetIrValueForScalar(
           : shape.element_type();
   torch::lazy::Value ir_value =
       GetIrValueForScalar(value, primitive_type, device);
-  return torch::lazy::MakeNode<ExpandSymInt>(ir_value, size_elements);
+  return MakeXlaNode<ExpandSymInt>(ir_value, size_elements);
 }
 
 torch::lazy::Value XLAGraphExecutor::GetRngSeed(
@@ -432,6 +631,9 @@ void XLAGraphExecutor::MarkStep(const torch::lazy::BackendDevice& device,
   // NOTE: [TORCH_LAZY_COUNTER v.s. XLA_COUNTER].
   XLA_COUNTER("MarkStep", 1);
   DeviceContextArena::Get()->MarkStep(device);
+  if (NodePool::IsEnabled()) {
+    NodePool::MarkStep();
+  }
   if (reset_scope) {
     torch::lazy::ScopePusher::ResetScopes();
   }
@@ -451,20 +653,6 @@ std::vector<size_t> GetBufferDonorIndexFromUserConfig(
   return buffer_donor_indexs;
 }
 
-std::vector<size_t> XLAGraphExecutor::SetBufferDonorsFromUserConfig(
-    LoweringContext* lowering_ctx) {
-  const std::vector<torch::lazy::BackendDataPtr>& parameters_data =
-      lowering_ctx->GetParametersData();
-  std::vector<size_t> buffer_donor_indexs =
-      GetBufferDonorIndexFromUserConfig(parameters_data);
-  for (size_t i : buffer_donor_indexs) {
-    lowering_ctx->builder()->AddBufferDonor(/*param_number=*/i,
-                                            /*param_index=*/{});
-  }
-  TORCH_LAZY_VALUE_METRIC("InputOutputAliasCount", buffer_donor_indexs.size());
-  return buffer_donor_indexs;
-}
-
 void XLAGraphExecutor::WaitDeviceOps(absl::Span<const std::string> devices) {
   std::set<torch::lazy::BackendDevice> wait_devices;
   if (!devices.empty()) {
@@ -578,10 +766,146 @@ bool XLAGraphExecutor::IsComputationCacheInitialized() {
 XLAGraphExecutor::ComputationCache* XLAGraphExecutor::GetComputationCache() {
   if (computation_cache_ == nullptr) {
     computation_cache_ = CreateComputationCache();
+    if (auto* memory_cache = dynamic_cast<MemoryCache*>(computation_cache_)) {
+      memory_cache->SetEvictionCallback(
+          [this](const torch::lazy::hash_t& hash,
+                 const ComputationCache::TypePtr& computation) {
+            OnComputationEvicted(hash, computation);
+          });
+      retain_compile_recipes_ = memory_cache->GetMaxBytes() > 0;
+    }
   }
   return computation_cache_;
 }
 
+XLAGraphExecutor::ComputationCache::TypePtr
+XLAGraphExecutor::GetOrWaitCachedComputation(const torch::lazy::hash_t& hash) {
+  ComputationCache::TypePtr cached_computation =
+      GetComputationCache()->Get(hash);
+  if (cached_computation != nullptr) {
+    return cached_computation;
+  }
+  std::optional<PendingComputation> pending = LookupPendingCompile(hash);
+  if (!pending) {
+    // The compilation might have completed between the two lookups.
+    cached_computation = GetComputationCache()->Get(hash);
+    if (cached_computation == nullptr) {
+      cached_computation = RecompileEvictedComputation(hash);
+    }
+    return cached_computation;
+  }
+  TORCH_LAZY_TIMED("AsyncCompileWait");
+  return pending->get();
+}
+
+XLAGraphExecutor::CompileRecipe::CompileRecipe(
+    const runtime::ComputationClient::CompileInstance& instance,
+    std::vector<size_t> buffer_donor_indices)
+    : output_shape(*instance.output_shape),
+      instance(CopyCompileInstance(instance, &output_shape)),
+      buffer_donor_indices(std::move(buffer_donor_indices)) {}
+
+runtime::ComputationClient::CompileInstance
+XLAGraphExecutor::CompileRecipe::MakeInstance() const {
+  return CopyCompileInstance(instance, &output_shape);
+}
+
+void XLAGraphExecutor::OnComputationEvicted(
+    const torch::lazy::hash_t& hash,
+    const ComputationCache::TypePtr& computation) {
+  TF_VLOG(3) << "Evicted computation " << torch::lazy::HashToString(hash)
+             << " from the computation cache (bytes="
+             << computation->memory_bytes()
+             << ", compile_seconds=" << computation->compile_seconds << ")";
+  TORCH_LAZY_COUNTER("ComputationCacheEviction", 1);
+  TORCH_LAZY_COUNTER("ComputationCacheEvictedBytes",
+                     computation->memory_bytes());
+  TORCH_LAZY_COUNTER("ComputationCacheEvictedCompileMs",
+                     static_cast<int64_t>(computation->compile_seconds * 1e3));
+  if (computation->recipe != nullptr) {
+    GetEvictedRecipeCache()->Add(hash, computation->recipe);
+  }
+}
+
+XLAGraphExecutor::ComputationCache::TypePtr
+XLAGraphExecutor::RecompileEvictedComputation(const torch::lazy::hash_t& hash) {
+  std::shared_ptr<const CompileRecipe> recipe =
+      GetEvictedRecipeCache()->Get(hash);
+  if (recipe == nullptr) {
+    // Another thread might have compiled it again since it was looked up.
+    return GetComputationCache()->Get(hash);
+  }
+  auto promise = std::make_shared<std::promise<ComputationCache::TypePtr>>();
+  PendingComputation computation = promise->get_future().share();
+  {
+    std::lock_guard<std::mutex> lock(pending_compiles_lock_);
+    std::vector<PendingCompile>& in_flight = pending_compiles_[hash];
+    for (const PendingCompile& pending : in_flight) {
+      if (pending.buffer_donor_indices == recipe->buffer_donor_indices) {
+        computation = pending.computation;
+        promise = nullptr;
+        break;
+      }
+    }
+    if (promise != nullptr) {
+      in_flight.push_back(
+          {recipe->buffer_donor_indices,
+           std::make_shared<xla::ProgramShape>(
+               ConsumeValue(recipe->instance.computation.GetProgramShape())),
+           computation});
+    }
+  }
+  if (promise == nullptr) {
+    TORCH_LAZY_COUNTER("EvictedComputationRecompileDedup", 1);
+    TORCH_LAZY_TIMED("AsyncCompileWait");
+    return computation.get();
+  }
+  TORCH_LAZY_COUNTER("EvictedComputationRecompile", 1);
+  TF_VLOG(3) << "Compiling again evicted graph hash "
+             << torch::lazy::HashToString(hash);
+  ComputationCache::TypePtr cached_computation;
+  try {
+    std::vector<runtime::ComputationClient::CompileInstance> instances;
+    instances.push_back(recipe->MakeInstance());
+    int64_t start_ns = runtime::sys_util::NowNs();
+    std::vector<std::shared_ptr<runtime::ComputationClient::Computation>>
+        computations =
+            runtime::GetComputationClient()->Compile(std::move(instances));
+    double compile_seconds = (runtime::sys_util::NowNs() - start_ns) * 1e-9;
+    cached_computation = GetComputationCache()->Add(
+        hash, std::make_shared<CachedComputation>(
+                  std::move(computations.front()), recipe->instance.is_sharded,
+                  compile_seconds, recipe));
+    GetEvictedRecipeCache()->Erase(hash);
+    promise->set_value(cached_computation);
+  } catch (...) {
+    promise->set_exception(std::current_exception());
+    ErasePendingCompile(hash, recipe->buffer_donor_indices);
+    throw;
+  }
+  ErasePendingCompile(hash, recipe->buffer_donor_indices);
+  return cached_computation;
+}
+
+void XLAGraphExecutor::ErasePendingCompile(
+    const torch::lazy::hash_t& hash,
+    const std::vector<size_t>& buffer_donor_indices) {
+  std::lock_guard<std::mutex> lock(pending_compiles_lock_);
+  auto it = pending_compiles_.find(hash);
+  if (it == pending_compiles_.end()) {
+    return;
+  }
+  std::vector<PendingCompile>& in_flight = it->second;
+  in_flight.erase(std::find_if(in_flight.begin(), in_flight.end(),
+                               [&](const PendingCompile& pending) {
+                                 return pending.buffer_donor_indices ==
+                                        buffer_donor_indices;
+                               }));
+  if (in_flight.empty()) {
+    pending_compiles_.erase(it);
+  }
+}
+
 void XLAGraphExecutor::ClearPendingIrs(
     std::vector<XLATensorPtr> tensors,
     const torch::lazy::BackendDevice& device) {
@@ -619,6 +943,8 @@ XLAGraphExecutor::SyncTensorCollection XLAGraphExecutor::CollectSyncTensors(
     const std::vector<XLATensorPtr>& tensors, const SyncTensorsConfig& config) {
   tsl::profiler::TraceMe activity("CollectSyncTensors",
                                   tsl::profiler::TraceMeLevel::kInfo);
+  StepPhaseTimer phase_timer(StepTimeline::CurrentStep(),
+                             StepPhase::kCollectSyncTensors);
   torch::lazy::Unique<torch::lazy::BackendDevice> unique_device;
   for (size_t i = 0; i < tensors.size(); ++i) {
     unique_device.set(tensors[i]->GetDevice());
@@ -672,10 +998,13 @@ XLAGraphExecutor::SyncTensorCollection XLAGraphExecutor::CollectSyncTensors(
             // result of the computation. Call `GetXlaData` to extract the
             // XlaData from the DeviceData Node and reset the IR. We also want
             // to update XlaData's tensorID to make it match with the current
-            // XLATensor.
-            tensors[i]->GetXlaData()->SetInfo(
-                std::make_shared<LazyGraphExecutor::DeviceDataInfo>(
-                    tensors[i]->GetUniqueId(), /*=read_only=*/false));
+            // XLATensor. Shared data keeps its info, as the tensor does not
+            // own it.
+            torch::lazy::BackendDataPtr data = tensors[i]->GetXlaData();
+            if (!IsSharedDeviceData(data)) {
+              data->SetInfo(std::make_shared<LazyGraphExecutor::DeviceDataInfo>(
+                  tensors[i]->GetUniqueId(), /*=read_only=*/false));
+            }
           } else {
             // Add only tensors which need to be synced.
             coll.hash = torch::lazy::HashCombine(coll.hash, ir_value.hash());
@@ -721,6 +1050,8 @@ void XLAGraphExecutor::TensorCollectionBarrier(SyncTensorCollection* coll) {
                                   tsl::profiler::TraceMeLevel::kInfo);
   TF_VLOG(4) << "waiting barrier for device " << coll->device.toString()
              << " start";
+  StepPhaseTimer phase_timer(StepTimeline::CurrentStep(),
+                             StepPhase::kTensorCollectionBarrier);
   torch::lazy::LazyGraphExecutor::TensorCollectionBarrier(coll);
   TF_VLOG(4) << "waiting barrier for device " << coll->device.toString()
              << " done";
@@ -734,16 +1065,16 @@ XLAGraphExecutor::ExecuteComputationWithBarrier(
                                   tsl::profiler::TraceMeLevel::kInfo);
   MaybeDumpGraph("dynamo", hash);
   auto cachedComputation =
-      XLAGraphExecutor::Get()->GetComputationCache()->Get(hash);
-  TF_VLOG(5) << "Cached computation (hash: " << torch::lazy::HashToString(hash)
-             << ") is_sharded=" << cachedComputation->is_sharded << std::endl;
+      XLAGraphExecutor::Get()->GetOrWaitCachedComputation(hash);
 
-  // TODO implement a fallback mechanism, or make sure those entries
-  // never get kicked out
+  // Evicted entries are compiled again from their CompileRecipe, so this only
+  // fails for hashes which have never been compiled.
   XLA_CHECK(cachedComputation)
       << "Failed to get computation by hash " << torch::lazy::HashToString(hash)
       << ". Maybe the entry get "
-         "kicked out of the LRU cache";
+         "kicked out of the computation cache";
+  TF_VLOG(5) << "Cached computation (hash: " << torch::lazy::HashToString(hash)
+             << ") is_sharded=" << cachedComputation->is_sharded << std::endl;
 
   DebugUtil::analyze_graph_execution_python_frame(
       DebugUtil::GraphAnalysisSource::DynamoExecution,
@@ -1025,6 +1356,8 @@ void XLAGraphExecutor::ExtractIRAndPrepareXlaData_(
     std::vector<torch::lazy::BackendDataPtr>& tensor_data_vec) {
   tsl::profiler::TraceMe activity("ExtractIRAndPrepareXlaData_",
                                   tsl::profiler::TraceMeLevel::kInfo);
+  StepPhaseTimer phase_timer(StepTimeline::CurrentStep(),
+                             StepPhase::kPrepareData);
   ir_values.reserve(indices.size());
   tensor_data_vec.reserve(indices.size());
   for (auto index : indices) {
@@ -1081,23 +1414,50 @@ XLAGraphExecutor::ScheduleSyncTensorsGraph(
     std::vector<torch::lazy::BackendDataPtr> parameters_data,
     std::vector<torch::lazy::BackendDataPtr> tensors_data,
     std::vector<XLATensor::ShardingSpecPtr> sharding_specs,
-    ComputationCache::TypePtr cached_computation) {
-  DebugUtil::analyze_graph_execution_python_frame(
-      DebugUtil::GraphAnalysisSource::Execution,
-      /*graph_hash=*/coll->hash,
-      /*program_shape=*/&(cached_computation->computation->program_shape()));
+    ComputationCache::TypePtr cached_computation,
+    PendingComputation pending_computation) {
+  if (cached_computation != nullptr) {
+    DebugUtil::analyze_graph_execution_python_frame(
+        DebugUtil::GraphAnalysisSource::Execution,
+        /*graph_hash=*/coll->hash,
+        /*program_shape=*/&(cached_computation->computation->program_shape()));
+  }
   tsl::profiler::TraceMe activity("ScheduleSyncTensorsGraph",
                                   tsl::profiler::TraceMeLevel::kInfo);
   TensorCollectionBarrier(coll);
+  std::shared_ptr<StepRecord> step = StepTimeline::CurrentStepPtr();
+  if (step != nullptr) {
+    step->parameter_count = parameters_data.size();
+    for (const auto& parameter : parameters_data) {
+      step->parameter_bytes += xla::ShapeUtil::ByteSizeOf(
+          UnwrapXlaData(parameter)->shape());
+    }
+  }
   std::shared_ptr<XLAGraphExecutor::Async> async = std::make_shared<Async>(
       coll, std::move(parameters_data), std::move(tensors_data),
       std::move(cached_computation));
+  async->pending_computation = std::move(pending_computation);
   auto syncfn = [async, hash = coll->hash, sharding_specs = sharding_specs,
-                 use_eager_mode = UseEagerMode()]() {
+                 use_eager_mode = UseEagerMode(),
+                 step = std::move(step)]() mutable {
     try {
+      // The Async is shared with the tracing thread, so the computation waited
+      // for is kept local rather than stored into it.
+      ComputationCache::TypePtr compiled_computation =
+          async->cached_computation;
+      if (compiled_computation == nullptr) {
+        // The computation is compiled by the background compile pool, so
+        // waiting here does not block any of the threads compiling it.
+        tsl::profiler::TraceMe activity("AsyncCompileWait",
+                                        tsl::profiler::TraceMeLevel::kInfo);
+        TORCH_LAZY_TIMED("AsyncCompileWait");
+        StepPhaseTimer phase_timer(step.get(), StepPhase::kAsyncCompileWait);
+        compiled_computation = async->pending_computation.get();
+      }
+      StepPhaseTimer phase_timer(step.get(), StepPhase::kExecute);
       std::vector<torch::lazy::BackendDataPtr> results;
       // Execute replicated if the compiled computation is partitioned.
-      if (async->cached_computation->is_sharded) {
+      if (compiled_computation->is_sharded) {
         std::vector<std::string> devices =
             runtime::GetComputationClient()->GetLocalDevices();
         runtime::ComputationClient::ExecuteReplicatedOptions execute_options;
@@ -1109,7 +1469,7 @@ XLAGraphExecutor::ScheduleSyncTensorsGraph(
         // "Assign"ed to the corresponding data placeholders.
         std::vector<runtime::ComputationClient::DataPtr> outputs =
             runtime::GetComputationClient()->ExecuteReplicated(
-                *async->cached_computation->computation,
+                *compiled_computation->computation,
                 UnwrapXlaData(async->parameters_data), devices,
                 execute_options);
         results = WrapXlaData(outputs);
@@ -1124,7 +1484,7 @@ XLAGraphExecutor::ScheduleSyncTensorsGraph(
                    << async->device << " ...";
         std::vector<runtime::ComputationClient::DataPtr> outputs =
             runtime::GetComputationClient()->ExecuteComputation(
-                *async->cached_computation->computation,
+                *compiled_computation->computation,
                 UnwrapXlaData(async->parameters_data), async->device.toString(),
                 {/*explode_tuple=*/true,
                  /*eager_mode=*/use_eager_mode});
@@ -1141,6 +1501,10 @@ XLAGraphExecutor::ScheduleSyncTensorsGraph(
           async->tensors_data[i] = std::move(results[i]);
         }
       }
+      // Hands the record over to the timeline before the device locks are
+      // released, so that it is there once the device ops are waited for.
+      phase_timer.Stop();
+      step.reset();
     } catch (...) {
       // There are two paths of discovery of an exception happening on an
       // asynchronous task. One happens if the creator of the asynchronous task
@@ -1187,12 +1551,80 @@ XLAGraphExecutor::ScheduleSyncTensorsGraph(
       std::move(sharding_specs), std::move(cached_computation));
 }
 
+std::shared_ptr<XLAGraphExecutor::Async>
+XLAGraphExecutor::ScheduleSyncTensorsGraph(
+    std::vector<XLATensorPtr>* tensors, SyncTensorCollection* coll,
+    std::vector<torch::lazy::BackendDataPtr> parameters_data,
+    PendingComputation pending_computation, bool is_sharded,
+    const std::vector<torch::lazy::BackendDataPtr>& tensor_data_vec) {
+  if (is_sharded) {
+    ComputationCache::TypePtr cached_computation;
+    {
+      TORCH_LAZY_TIMED("AsyncCompileWait");
+      cached_computation = pending_computation.get();
+    }
+    return ScheduleSyncTensorsGraph(
+        tensors, coll, std::move(parameters_data), coll->device.toString(),
+        std::move(cached_computation), tensor_data_vec);
+  }
+  auto tensors_data =
+      SetTensorData(tensors, coll->config, coll->indices, tensor_data_vec);
+  std::vector<XLATensor::ShardingSpecPtr> sharding_specs(coll->indices.size(),
+                                                         nullptr);
+  return ScheduleSyncTensorsGraph(coll, std::move(parameters_data),
+                                  std::move(tensors_data),
+                                  std::move(sharding_specs),
+                                  /*cached_computation=*/nullptr,
+                                  std::move(pending_computation));
+}
+
 XLAGraphExecutor::PostOrderData XLAGraphExecutor::RunPostOrder(
     const std::vector<torch::lazy::Value>& ir_values,
     SyncTensorCollection* coll) {
   tsl::profiler::TraceMe activity("RunPostOrder",
                                   tsl::profiler::TraceMeLevel::kInfo);
-  return torch::lazy::LazyGraphExecutor::RunPostOrder(ir_values, coll);
+  StepPhaseTimer phase_timer(StepTimeline::CurrentStep(),
+                             StepPhase::kPostOrder);
+  static const bool incremental_post_order =
+      runtime::sys_util::GetEnvBool("XLA_INCREMENTAL_POST_ORDER", false);
+  if (!incremental_post_order) {
+    return torch::lazy::LazyGraphExecutor::RunPostOrder(ir_values, coll);
+  }
+  torch::lazy::hash_t roots_hash = GetRootsHash(ir_values);
+  std::shared_ptr<const PostOrderPlan> plan =
+      GetPostOrderPlanCache()->Get(roots_hash);
+  PostOrderData po_data;
+  if (plan == nullptr ||
+      !ReplayPostOrderPlan(*plan, ir_values, &po_data.post_order)) {
+    TORCH_LAZY_COUNTER("IncrementalPostOrderMiss", 1);
+    po_data = torch::lazy::LazyGraphExecutor::RunPostOrder(ir_values, coll);
+    GetPostOrderPlanCache()->Add(
+        roots_hash, RecordPostOrderPlan(ir_values, po_data.post_order));
+    return po_data;
+  }
+  TORCH_LAZY_COUNTER("IncrementalPostOrderHit", 1);
+  // Same as the upstream RunPostOrder, but only visiting the nodes which hold
+  // device data. The emission map is left empty, as every node is in the
+  // post order.
+  std::unordered_map<torch::lazy::BackendData::Handle, size_t> data_handles;
+  for (size_t position : plan->data_positions) {
+    torch::lazy::BackendDataPtr backend_data =
+        torch::lazy::getBackend()->GetComputationDataFromNode(
+            po_data.post_order[position]);
+    if (!backend_data->HasValue()) {
+      TensorCollectionBarrier(coll);
+    }
+    torch::lazy::BackendData::Handle handle = backend_data->GetHandle();
+    auto it = data_handles.find(handle);
+    if (it != data_handles.end()) {
+      po_data.parameter_sequence.push_back(it->second);
+    } else {
+      po_data.parameter_sequence.push_back(po_data.parameters_data.size());
+      data_handles[handle] = po_data.parameters_data.size();
+      po_data.parameters_data.push_back(backend_data);
+    }
+  }
+  return po_data;
 }
 
 XLAGraphExecutor::ComputationCache::TypePtr
@@ -1255,9 +1687,9 @@ XLAGraphExecutor::TryRunCachedSync(
                            std::move(cached_computation), tensor_data_vec));
 }
 
-std::vector<size_t> XLAGraphExecutor::SetBufferDonors(
+std::vector<size_t> GetBufferDonorIndexFromOutputs(
     const std::vector<XLATensorPtr>& tensors, absl::Span<const size_t> indices,
-    LoweringContext* lowering_ctx) {
+    const std::vector<torch::lazy::BackendDataPtr>& parameters_data) {
   std::unordered_map<int64_t, size_t> output_tensor_id_map;
   std::vector<size_t> buffer_donor_indexs;
   // tensors[indices] represent all tensors that needs to be updated after
@@ -1268,8 +1700,6 @@ std::vector<size_t> XLAGraphExecutor::SetBufferDonors(
     int64_t tensor_id = tensors[tensor_index]->data()->alias_id;
     output_tensor_id_map[tensor_id] = i;
   }
-  const auto& parameters_data = lowering_ctx->GetParametersData();
-  std::vector<ssize_t> alias_map(indices.size(), -1);
   for (size_t i = 0; i < parameters_data.size(); ++i) {
     auto* data_info =
         static_cast<torch::lazy::LazyGraphExecutor::DeviceDataInfo*>(
@@ -1280,29 +1710,66 @@ std::vector<size_t> XLAGraphExecutor::SetBufferDonors(
       // this buffer is not needed after execution since XLATensor will get a
       // new buffer.
       if (it != output_tensor_id_map.end()) {
-        lowering_ctx->builder()->AddBufferDonor(/*param_number=*/i,
-                                                /*param_index=*/{});
         buffer_donor_indexs.push_back(i);
       }
     }
   }
-  TORCH_LAZY_VALUE_METRIC("InputOutputAliasCount", buffer_donor_indexs.size());
   return buffer_donor_indexs;
 }
 
-XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
+std::vector<size_t> XLAGraphExecutor::GetBufferDonorIndices(
+    const std::vector<XLATensorPtr>& tensors, const SyncTensorCollection& coll,
+    const std::vector<torch::lazy::BackendDataPtr>& parameters_data) {
+  static const bool enable_aliasing =
+      runtime::sys_util::GetEnvBool("XLA_ENABLE_PARAM_ALIASING", true);
+  // TODO(yeounoh) enable aliasing is disabled for partitioned computation,
+  // since the current aliasing compares the unpartitioned input and output
+  // shapes which can lead to an incorrect aliasing pairs if sharded.
+  if (!enable_aliasing || ShardingUtil::GetAutoSharding()) {
+    return {};
+  }
+  std::vector<size_t> buffer_donor_indexs;
+  if (coll.config.sync_ltc_data && coll.config.force_ltc_data) {
+    // We can only alias at the step barrier, when force_ltc_data is true.
+    // Consider the case:
+    //   1. Tensor A(DEVICE_DATA)
+    //   2. Tensor B = A + 0.9
+    //   3. A += 0.4
+    // If we activate aliasing for A's graph, and we do:
+    //   print(A)
+    //   print(A)
+    // The first print will update DEVICE_DATA' with DEVICE_DATA+0.4, and the
+    // second print will again update DEVICE_DATA" with DEVICE_DATA'+0.4,
+    // which will lead to incorrect results. We cannot normally turn A's state
+    // into DEVICE_DATA, as if any of the sources is a view, this will not
+    // lead to correct results (as A's value taken at different times need to
+    // reflect view source changes):
+    //   1. Tensor A = some_graph_with_view_source(V)
+    //   2. print(A)
+    //   3. V += 1
+    //   4. print(A)
+    // The second print should reflect the new value due to V's changes.
+    // Also in the first example, unless we are doing a step barrier and hence
+    // include all live tensors, if the B value is not part of the graph, it
+    // will later fetch the new value of A, which is incorrect.
+    // But, when we issue a step barrier (force_ltc_data == true) we have to
+    // turn everything into DEVICE_DATA, so we can activate aliasing.
+    buffer_donor_indexs =
+        GetBufferDonorIndexFromOutputs(tensors, coll.indices, parameters_data);
+  } else if (GetAliasWithBufferDonorConfig()) {
+    // only alias based on buffer donor if LTC can't auto infer the input
+    // output aliasing.
+    buffer_donor_indexs = GetBufferDonorIndexFromUserConfig(parameters_data);
+  }
+  return buffer_donor_indexs;
+}
+
+XLAGraphExecutor::LoweringResult XLAGraphExecutor::LowerForCompile(
     std::vector<XLATensorPtr>& tensors, absl::Span<const std::string> devices,
     const SyncTensorCollection& coll, PostOrderData* po_data,
     const std::vector<torch::lazy::Value>& ir_values) {
-  tsl::profiler::TraceMe activity(
-      [&] {
-        return tsl::profiler::TraceMeEncode(
-            "XLAGraphExecutor::Compile",
-            {{"graph_hash", torch::lazy::HashToString(coll.hash)}});
-      },
-      tsl::profiler::TraceMeLevel::kInfo);
-  static const bool enable_aliasing =
-      runtime::sys_util::GetEnvBool("XLA_ENABLE_PARAM_ALIASING", true);
+  tsl::profiler::TraceMe activity("LowerForCompile",
+                                  tsl::profiler::TraceMeLevel::kInfo);
   static const size_t parameter_wrapping_threadshold =
       runtime::sys_util::GetEnvInt("XLA_PARAMETER_WRAPPING_THREADSHOLD", 3200);
   static const bool use_autosharding = ShardingUtil::GetAutoSharding();
@@ -1314,49 +1781,17 @@ XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
         torch::lazy::Output(ir_value.node.get(), ir_value.index));
     lowering_ctx.AddResult(root);
   }
-  // Always execute sharded when running in SPMD mode
-  bool is_sharded = (coll.device == GetVirtualDevice()) || UseVirtualDevice();
+  bool is_sharded = IsShardedExecution(coll.device);
   // Annotate HLO sharding selectively in the compuation.
   ShardingUtil::SetHloSharding(&lowering_ctx);
 
-  std::vector<size_t> buffer_donor_indices;
-  // TODO(yeounoh) enable aliasing is disabled for partitioned computation,
-  // since the current aliasing compares the unpartitioned input and output
-  // shapes which can lead to an incorrect aliasing pairs if sharded.
-  if (enable_aliasing && !use_autosharding) {
-    if (coll.config.sync_ltc_data && coll.config.force_ltc_data) {
-      // We can only alias at the step barrier, when force_ltc_data is true.
-      // Consider the case:
-      //   1. Tensor A(DEVICE_DATA)
-      //   2. Tensor B = A + 0.9
-      //   3. A += 0.4
-      // If we activate aliasing for A's graph, and we do:
-      //   print(A)
-      //   print(A)
-      // The first print will update DEVICE_DATA' with DEVICE_DATA+0.4, and the
-      // second print will again update DEVICE_DATA" with DEVICE_DATA'+0.4,
-      // which will lead to incorrect results. We cannot normally turn A's state
-      // into DEVICE_DATA, as if any of the sources is a view, this will not
-      // lead to correct results (as A's value taken at different times need to
-      // reflect view source changes):
-      //   1. Tensor A = some_graph_with_view_source(V)
-      //   2. print(A)
-      //   3. V += 1
-      //   4. print(A)
-      // The second print should reflect the new value due to V's changes.
-      // Also in the first example, unless we are doing a step barrier and hence
-      // include all live tensors, if the B value is not part of the graph, it
-      // will later fetch the new value of A, which is incorrect.
-      // But, when we issue a step barrier (force_ltc_data == true) we have to
-      // turn everything into DEVICE_DATA, so we can activate aliasing.
-      buffer_donor_indices =
-          SetBufferDonors(tensors, coll.indices, &lowering_ctx);
-    } else if (GetAliasWithBufferDonorConfig()) {
-      // only alias based on buffer donor if LTC can't auto infer the input
-      // output aliasing.
-      buffer_donor_indices = SetBufferDonorsFromUserConfig(&lowering_ctx);
-    }
+  std::vector<size_t> buffer_donor_indices = GetBufferDonorIndices(
+      tensors, coll, lowering_ctx.GetParametersData());
+  for (size_t i : buffer_donor_indices) {
+    lowering_ctx.builder()->AddBufferDonor(/*param_number=*/i,
+                                           /*param_index=*/{});
   }
+  TORCH_LAZY_VALUE_METRIC("InputOutputAliasCount", buffer_donor_indices.size());
 
   xla::XlaComputation computation = ConsumeValue(lowering_ctx.BuildXla());
   xla::ProgramShape program_shape = ConsumeValue(computation.GetProgramShape());
@@ -1373,19 +1808,19 @@ XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
         computation, program_shape.parameters(), buffer_donor_indices));
     program_shape = ConsumeValue(computation.GetProgramShape());
   }
-  xla::Shape shape = MakeShapeWithDeviceLayout(
-      program_shape.result(), static_cast<XlaDeviceType>(coll.device.type()));
+  auto shape = std::make_unique<xla::Shape>(MakeShapeWithDeviceLayout(
+      program_shape.result(), static_cast<XlaDeviceType>(coll.device.type())));
 
-  std::vector<runtime::ComputationClient::CompileInstance> instances;
-  instances.push_back({std::move(computation), coll.device.toString(),
-                       runtime::GetComputationClient()->GetCompilationDevices(
-                           coll.device.toString(), devices),
-                       &shape, should_wrap_parameter, is_sharded});
-  instances.front().eager_mode = UseEagerMode();
+  runtime::ComputationClient::CompileInstance instance(
+      std::move(computation), coll.device.toString(),
+      runtime::GetComputationClient()->GetCompilationDevices(
+          coll.device.toString(), devices),
+      shape.get(), should_wrap_parameter, is_sharded);
+  instance.eager_mode = UseEagerMode();
   if (use_autosharding) {
     TF_VLOG(5) << "use_auto_spmd_partitioning is set.";
     TF_CHECK(is_sharded) << "Auto-sharding pass requires SPMD mode.";
-    instances.front().use_auto_spmd_partitioning = use_autosharding;
+    instance.use_auto_spmd_partitioning = use_autosharding;
     TORCH_LAZY_COUNTER("CompileWithAutoSharding", 1);
 
     // Apply XLA_AUTO_SPMD_MESH if it is set.
@@ -1393,10 +1828,9 @@ XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
     std::vector<int64_t> auto_spmd_mesh_shape =
         ShardingUtil::GetAutoShardingMesh();
     std::vector<int64_t> auto_spmd_mesh_ids =
-        ShardingUtil::GetAutoShardingMeshIds(
-            instances.front().computation.proto());
-    instances.front().auto_spmd_mesh_shape = auto_spmd_mesh_shape;
-    instances.front().auto_spmd_mesh_ids = auto_spmd_mesh_ids;
+        ShardingUtil::GetAutoShardingMeshIds(instance.computation.proto());
+    instance.auto_spmd_mesh_shape = auto_spmd_mesh_shape;
+    instance.auto_spmd_mesh_ids = auto_spmd_mesh_ids;
     TF_VLOG(5) << "auto_spmd_mesh_shape={"
                << absl::StrJoin(auto_spmd_mesh_shape, ",") << "}\n"
                << "auto_spmd_mesh_ids={"
@@ -1407,12 +1841,57 @@ XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
       DebugUtil::GraphAnalysisSource::Compilation,
       /*graph_hash=*/coll.hash, /*program_shape=*/&program_shape);
 
+  if (should_wrap_parameter) {
+    XLA_CHECK_EQ(program_shape.parameters_size(), 1);
+    XLA_CHECK_EQ(program_shape.parameters()[0].tuple_shapes_size(),
+                 po_data->parameters_data.size());
+  } else {
+    XLA_CHECK_EQ(program_shape.parameters_size(),
+                 po_data->parameters_data.size());
+  }
+
+  LoweringResult result;
+  result.device = coll.device;
+  result.emitted_nodes = lowering_ctx.GetEmittedNodeCount();
+  result.program_shape = std::move(program_shape);
+  result.output_shape = std::move(shape);
+  result.instance = std::move(instance);
+  result.is_sharded = is_sharded;
+  result.buffer_donor_indices = std::move(buffer_donor_indices);
+  return result;
+}
+
+XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
+    std::vector<XLATensorPtr>& tensors, absl::Span<const std::string> devices,
+    const SyncTensorCollection& coll, PostOrderData* po_data,
+    const std::vector<torch::lazy::Value>& ir_values, bool retain_recipe) {
+  tsl::profiler::TraceMe activity(
+      [&] {
+        return tsl::profiler::TraceMeEncode(
+            "XLAGraphExecutor::Compile",
+            {{"graph_hash", torch::lazy::HashToString(coll.hash)}});
+      },
+      tsl::profiler::TraceMeLevel::kInfo);
+  StepPhaseTimer phase_timer(StepTimeline::CurrentStep(), StepPhase::kCompile);
+  static const bool use_autosharding = ShardingUtil::GetAutoSharding();
+  LoweringResult lowering =
+      LowerForCompile(tensors, devices, coll, po_data, ir_values);
+
   TF_VLOG(3) << "Compiling IR graph hash "
              << torch::lazy::HashToString(coll.hash) << " on device "
              << coll.device << " ...";
+  std::shared_ptr<const CompileRecipe> recipe;
+  if (retain_recipe) {
+    recipe = std::make_shared<CompileRecipe>(lowering.instance,
+                                             lowering.buffer_donor_indices);
+  }
+  std::vector<runtime::ComputationClient::CompileInstance> instances;
+  instances.push_back(std::move(lowering.instance));
+  int64_t start_ns = runtime::sys_util::NowNs();
   std::vector<std::shared_ptr<runtime::ComputationClient::Computation>>
       computations =
           runtime::GetComputationClient()->Compile(std::move(instances));
+  double compile_seconds = (runtime::sys_util::NowNs() - start_ns) * 1e-9;
   DebugUtil::post_compilation_analysis(computations[0]);
   TF_VLOG(3) << "Compiling IR graph hash "
              << torch::lazy::HashToString(coll.hash) << " on device "
@@ -1435,20 +1914,130 @@ XLAGraphExecutor::CompilationResult XLAGraphExecutor::Compile(
                << torch::lazy::Hash(po_data->parameter_sequence);
   }
 
-  if (should_wrap_parameter) {
-    XLA_CHECK_EQ(program_shape.parameters_size(), 1);
-    XLA_CHECK_EQ(program_shape.parameters()[0].tuple_shapes_size(),
-                 po_data->parameters_data.size());
-  } else {
-    XLA_CHECK_EQ(program_shape.parameters_size(),
-                 po_data->parameters_data.size());
-  }
-
-  return {/*device=*/coll.device,
-          /*emitted_nodes=*/lowering_ctx.GetEmittedNodeCount(),
+  return {/*device=*/lowering.device,
+          /*emitted_nodes=*/lowering.emitted_nodes,
           /*computation=*/computations.front(),
           /*parameters_data=*/std::move(po_data->parameters_data),
-          /*is_sharded=*/is_sharded};
+          /*is_sharded=*/lowering.is_sharded,
+          /*compile_seconds=*/compile_seconds,
+          /*recipe=*/std::move(recipe)};
+}
+
+std::optional<XLAGraphExecutor::PendingComputation>
+XLAGraphExecutor::LookupPendingCompile(const torch::lazy::hash_t& hash) {
+  std::lock_guard<std::mutex> lock(pending_compiles_lock_);
+  auto it = pending_compiles_.find(hash);
+  if (it == pending_compiles_.end()) {
+    return std::nullopt;
+  }
+  return it->second.front().computation;
+}
+
+std::optional<XLAGraphExecutor::PendingCompile>
+XLAGraphExecutor::LookupPendingCompile(
+    const torch::lazy::hash_t& hash,
+    const std::vector<size_t>& buffer_donor_indices) {
+  std::lock_guard<std::mutex> lock(pending_compiles_lock_);
+  auto it = pending_compiles_.find(hash);
+  if (it == pending_compiles_.end()) {
+    return std::nullopt;
+  }
+  for (const PendingCompile& pending : it->second) {
+    if (pending.buffer_donor_indices == buffer_donor_indices) {
+      return pending;
+    }
+  }
+  return std::nullopt;
+}
+
+XLAGraphExecutor::PendingCompile XLAGraphExecutor::CompileAsync(
+    std::vector<XLATensorPtr>& tensors, absl::Span<const std::string> devices,
+    const SyncTensorCollection& coll, PostOrderData* po_data,
+    const std::vector<torch::lazy::Value>& ir_values, bool retain_recipe) {
+  // The in-flight computation is only shared if it donates the same buffers
+  // as this sync would. A warm up, for instance, does not donate any, while
+  // the step barrier executing the same graph does.
+  std::vector<size_t> buffer_donor_indices =
+      GetBufferDonorIndices(tensors, coll, po_data->parameters_data);
+  std::optional<PendingCompile> pending =
+      LookupPendingCompile(coll.hash, buffer_donor_indices);
+  if (pending) {
+    TORCH_LAZY_COUNTER("AsyncCompileDedup", 1);
+    TORCH_LAZY_VALUE_METRIC("InputOutputAliasCount",
+                            buffer_donor_indices.size());
+    return *pending;
+  }
+  // Lowering walks the IR graph, so it has to happen on the tracing thread.
+  // Only the ComputationClient compilation is moved to the background, and
+  // shows up in the step timeline as the AsyncCompileWait of the execution.
+  StepPhaseTimer phase_timer(StepTimeline::CurrentStep(), StepPhase::kCompile);
+  auto lowering = std::make_shared<LoweringResult>(
+      LowerForCompile(tensors, devices, coll, po_data, ir_values));
+  TORCH_LAZY_VALUE_METRIC("TensorsGraphSize", lowering->emitted_nodes);
+  TF_VLOG(5) << "TensorsGraphSize=" << lowering->emitted_nodes;
+
+  auto promise = std::make_shared<std::promise<ComputationCache::TypePtr>>();
+  PendingCompile scheduled{
+      lowering->buffer_donor_indices,
+      std::make_shared<xla::ProgramShape>(lowering->program_shape),
+      promise->get_future().share()};
+  {
+    std::lock_guard<std::mutex> lock(pending_compiles_lock_);
+    std::vector<PendingCompile>& in_flight = pending_compiles_[coll.hash];
+    for (const PendingCompile& pending : in_flight) {
+      if (pending.buffer_donor_indices == lowering->buffer_donor_indices) {
+        // Another thread scheduled the same graph while we were lowering it.
+        TORCH_LAZY_COUNTER("AsyncCompileDedup", 1);
+        return pending;
+      }
+    }
+    in_flight.push_back(scheduled);
+  }
+  TORCH_LAZY_COUNTER("AsyncCompile", 1);
+
+  std::shared_ptr<const CompileRecipe> recipe;
+  if (retain_recipe) {
+    recipe = std::make_shared<CompileRecipe>(lowering->instance,
+                                             lowering->buffer_donor_indices);
+  }
+  auto compilefn = [this, hash = coll.hash, lowering, promise, recipe]() {
+    tsl::profiler::TraceMe activity(
+        [&] {
+          return tsl::profiler::TraceMeEncode(
+              "XLAGraphExecutor::CompileAsync",
+              {{"graph_hash", torch::lazy::HashToString(hash)}});
+        },
+        tsl::profiler::TraceMeLevel::kInfo);
+    try {
+      TF_VLOG(3) << "Compiling IR graph hash "
+                 << torch::lazy::HashToString(hash) << " on device "
+                 << lowering->device << " in background ...";
+      std::vector<runtime::ComputationClient::CompileInstance> instances;
+      instances.push_back(std::move(lowering->instance));
+      int64_t start_ns = runtime::sys_util::NowNs();
+      std::vector<std::shared_ptr<runtime::ComputationClient::Computation>>
+          computations =
+              runtime::GetComputationClient()->Compile(std::move(instances));
+      double compile_seconds = (runtime::sys_util::NowNs() - start_ns) * 1e-9;
+      DebugUtil::post_compilation_analysis(computations[0]);
+      TF_VLOG(3) << "Compiling IR graph hash "
+                 << torch::lazy::HashToString(hash) << " on device "
+                 << lowering->device << " done!";
+      auto cached_computation = std::make_shared<CachedComputation>(
+          std::move(computations.front()), lowering->is_sharded,
+          compile_seconds, recipe);
+      // Publish into the computation cache before dropping the pending entry,
+      // so that a lookup always finds the graph in one of the two places.
+      GetComputationCache()->Add(hash, cached_computation);
+      promise->set_value(std::move(cached_computation));
+    } catch (...) {
+      TORCH_LAZY_COUNTER("AsyncCompileFailure", 1);
+      promise->set_exception(std::current_exception());
+    }
+    ErasePendingCompile(hash, lowering->buffer_donor_indices);
+  };
+  thread::ScheduleCompile(std::move(compilefn));
+  return scheduled;
 }
 
 std::shared_ptr<XLAGraphExecutor::Async>
@@ -1457,7 +2046,12 @@ XLAGraphExecutor::SyncTensorsGraphInternal(
     const SyncTensorsConfig& config, bool warm_up_cache_only) {
   tsl::profiler::TraceMe activity("SyncTensorsGraphInternal",
                                   tsl::profiler::TraceMeLevel::kInfo);
+  // The record is added to the StepTimeline once the step is done, which is
+  // after the execution for scheduled graphs, as the execution holds it too.
+  StepScope step_scope(StepTimeline::Get()->NewStep());
+  StepRecord* step = StepTimeline::CurrentStep();
   SyncTensorCollection coll = CollectSyncTensors(*tensors, config);
+  step->device = coll.device.toString();
   if (coll.indices.empty()) {
     // Enure previous execution is complete before exiting this
     // function. Caller of `SyncTensorsGraphInternal` might want to call
@@ -1481,6 +2075,7 @@ XLAGraphExecutor::SyncTensorsGraphInternal(
   ExtractIRAndPrepareXlaData_(tensors, coll.config, coll.indices, ir_values,
                               tensor_data_vec);
   PostOrderData po_data = RunPostOrder(ir_values, &coll);
+  step->node_count = po_data.post_order.size();
   coll.hash = torch::lazy::HashCombine(
       coll.hash, torch::lazy::Hash(po_data.parameter_sequence));
   if (GetAliasWithBufferDonorConfig()) {
@@ -1505,21 +2100,53 @@ XLAGraphExecutor::SyncTensorsGraphInternal(
   DebugUtil::SaveGraphHash(coll.hash);
   TF_VLOG(4) << "Parameter sequence graph hash "
              << torch::lazy::HashToString(coll.hash);
+  step->graph_hash = coll.hash;
 
   std::pair<bool, std::shared_ptr<XLAGraphExecutor::Async>> cache_res =
       TryRunCachedSync(tensors, &coll, &po_data, tensor_data_vec,
                        warm_up_cache_only);
   if (cache_res.first) {
     // we have a cache hit, execution has been scheduled by TryRunCachedSync.
+    step->cache_hit = true;
     return cache_res.second;
   }
+  static const bool use_async_compilation =
+      runtime::sys_util::GetEnvBool("XLA_ASYNC_COMPILATION", false);
+  // Auto-sharding reshards the parameters based on the compiled computation,
+  // which requires the compilation to complete before the execution is
+  // scheduled.
+  // Graphs which are only compiled to warm up the cache are later executed by
+  // hash (see ExecuteComputationWithBarrier), so their lowering is retained to
+  // be able to compile them again if the byte-budgeted cache evicts them.
+  // Auto-sharding is left out, as it also reshards the parameters at compile
+  // time.
+  bool retain_recipe = warm_up_cache_only && retain_compile_recipes_ &&
+                       !ShardingUtil::GetAutoSharding();
+  if (use_async_compilation && !ShardingUtil::GetAutoSharding()) {
+    bool is_sharded = IsShardedExecution(coll.device);
+    PendingCompile pending = CompileAsync(*tensors, devices, coll, &po_data,
+                                          ir_values, retain_recipe);
+    if (warm_up_cache_only) {
+      return nullptr;
+    }
+    // ScheduleSyncTensorsGraph only analyzes cached computations, as it runs
+    // the analysis from the program shape of the compiled computation.
+    DebugUtil::analyze_graph_execution_python_frame(
+        DebugUtil::GraphAnalysisSource::Execution,
+        /*graph_hash=*/coll.hash,
+        /*program_shape=*/pending.program_shape.get());
+    return ScheduleSyncTensorsGraph(
+        tensors, &coll, std::move(po_data.parameters_data),
+        std::move(pending.computation), is_sharded, tensor_data_vec);
+  }
   CompilationResult compile_result =
-      Compile(*tensors, devices, coll, &po_data, ir_values);
+      Compile(*tensors, devices, coll, &po_data, ir_values, retain_recipe);
 
   TORCH_LAZY_VALUE_METRIC("TensorsGraphSize", compile_result.emitted_nodes);
   TF_VLOG(5) << "TensorsGraphSize=" << compile_result.emitted_nodes;
   auto cached_computation = std::make_shared<CachedComputation>(
-      std::move(compile_result.computation), compile_result.is_sharded);
+      std::move(compile_result.computation), compile_result.is_sharded,
+      compile_result.compile_seconds, std::move(compile_result.recipe));
   GetComputationCache()->Add(coll.hash, cached_computation);
 
   if (warm_up_cache_only) {
@@ -5,8 +5,11 @@
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/lazy/core/ir_util.h>
 
+#include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
@@ -151,15 +154,58 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
 
   void MaybeDumpGraph(std::string name, torch::lazy::hash_t hash);
 
+  // A copy of a lowered graph, which allows compiling it again after its
+  // computation has been evicted from the computation cache. Only retained
+  // when XLA_COMPILATION_CACHE_MAX_BYTES is set, as only then the in-memory
+  // cache evicts entries based on their size. The persistent cache keeps the
+  // evicted computations on disk instead.
+  struct CompileRecipe {
+    CompileRecipe(const runtime::ComputationClient::CompileInstance& instance,
+                  std::vector<size_t> buffer_donor_indices);
+    CompileRecipe(const CompileRecipe&) = delete;
+    CompileRecipe& operator=(const CompileRecipe&) = delete;
+
+    // Returns a new instance which can be handed to the ComputationClient.
+    runtime::ComputationClient::CompileInstance MakeInstance() const;
+
+    xla::Shape output_shape;
+    runtime::ComputationClient::CompileInstance instance;
+    std::vector<size_t> buffer_donor_indices;
+  };
+
   // We don't use the upstream CachedComputation type given all fields are
   // different.
   struct CachedComputation {
     CachedComputation(runtime::ComputationClient::ComputationPtr computation,
-                      bool is_sharded = false)
-        : computation(std::move(computation)), is_sharded(is_sharded) {}
+                      bool is_sharded = false, double compile_seconds = 0,
+                      std::shared_ptr<const CompileRecipe> recipe = nullptr)
+        : computation(std::move(computation)),
+          is_sharded(is_sharded),
+          compile_seconds(compile_seconds),
+          recipe(std::move(recipe)) {}
+
+    // The bytes held by the compiled program. Computed on first use, as it
+    // queries the compiled memory stats, which only a byte-budgeted
+    // computation cache needs.
+    size_t memory_bytes() const {
+      std::call_once(memory_bytes_once_, [this]() {
+        memory_bytes_ =
+            computation != nullptr ? computation->memory_size_bytes() : 0;
+      });
+      return memory_bytes_;
+    }
 
     runtime::ComputationClient::ComputationPtr computation;
     bool is_sharded;
+    // Used by the computation cache to weigh the cost of evicting the entry.
+    double compile_seconds;
+    // Only set for graphs executed through ExecuteComputationWithBarrier,
+    // which have no IR to lower again once evicted.
+    std::shared_ptr<const CompileRecipe> recipe;
+
+   private:
+    mutable std::once_flag memory_bytes_once_;
+    mutable size_t memory_bytes_ = 0;
   };
 
   using ComputationCache =
@@ -168,13 +214,25 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
   using MemoryCache =
       runtime::util::Cache<torch::lazy::hash_t, CachedComputation,
                            torch::lazy::HashReducer>;
+  using ConcurrentMemoryCache =
+      runtime::util::ConcurrentCache<torch::lazy::hash_t, CachedComputation,
+                                     torch::lazy::HashReducer>;
   using PersistentCache =
       runtime::util::PersistentCache<torch::lazy::hash_t, CachedComputation,
                                      torch::lazy::HashReducer>;
+  // A computation which is being compiled in the background. It becomes ready
+  // once the compiled computation has been added to the computation cache.
+  using PendingComputation = std::shared_future<ComputationCache::TypePtr>;
 
   ComputationCache* GetComputationCache();
   bool IsComputationCacheInitialized();
 
+  // Looks up the computation cache, and if the graph is still being compiled
+  // in the background (XLA_ASYNC_COMPILATION=1), waits for the compilation to
+  // complete. Returns nullptr if the graph is neither cached nor pending.
+  ComputationCache::TypePtr GetOrWaitCachedComputation(
+      const torch::lazy::hash_t& hash);
+
   std::vector<torch::lazy::BackendDataPtr> ExecuteComputationWithBarrier(
       torch::lazy::hash_t hash, const std::vector<at::IValue>& graph_inputs,
       const torch::lazy::BackendDevice& device);
@@ -202,6 +260,28 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
     runtime::ComputationClient::ComputationPtr computation;
     std::vector<torch::lazy::BackendDataPtr> parameters_data;
     bool is_sharded = false;
+    double compile_seconds = 0;
+    std::shared_ptr<const CompileRecipe> recipe;
+  };
+
+  // The lowered form of a pending graph, ready to be handed to the
+  // ComputationClient for compilation.
+  struct LoweringResult {
+    torch::lazy::BackendDevice device;
+    size_t emitted_nodes = 0;
+    xla::ProgramShape program_shape;
+    // Owns the output shape referenced by `instance`.
+    std::unique_ptr<xla::Shape> output_shape;
+    runtime::ComputationClient::CompileInstance instance;
+    bool is_sharded = false;
+    std::vector<size_t> buffer_donor_indices;
+  };
+
+  struct PendingCompile {
+    std::vector<size_t> buffer_donor_indices;
+    // The program shape of the lowered graph, for the execution analysis.
+    std::shared_ptr<const xla::ProgramShape> program_shape;
+    PendingComputation computation;
   };
 
   struct Async : public torch::lazy::LazyGraphExecutor::Async {
@@ -211,6 +291,9 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
           ComputationCache::TypePtr cached_computation);
 
     ComputationCache::TypePtr cached_computation;
+    // Set instead of cached_computation when the computation is still being
+    // compiled in the background. The execution waits for it before running.
+    PendingComputation pending_computation;
   };
 
   class DeviceContextArena
@@ -321,12 +404,22 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
       std::vector<torch::lazy::BackendDataPtr> parameters_data,
       std::vector<torch::lazy::BackendDataPtr> tensors_data,
       std::vector<XLATensor::ShardingSpecPtr> sharding_specs,
-      ComputationCache::TypePtr cached_computation);
+      ComputationCache::TypePtr cached_computation,
+      PendingComputation pending_computation = PendingComputation());
   std::shared_ptr<Async> ScheduleSyncTensorsGraph(
       std::vector<XLATensorPtr>* tensors, SyncTensorCollection* coll,
       std::vector<torch::lazy::BackendDataPtr> parameters_data,
       std::string device, ComputationCache::TypePtr cached_computation,
       const std::vector<torch::lazy::BackendDataPtr>& tensor_data_vec);
+  // Schedules the execution of a graph whose computation is still being
+  // compiled in the background. Sharded graphs need the compiled output
+  // shardings to create their placeholders, so those wait for the compilation
+  // here, while unsharded ones wait on the execution thread.
+  std::shared_ptr<Async> ScheduleSyncTensorsGraph(
+      std::vector<XLATensorPtr>* tensors, SyncTensorCollection* coll,
+      std::vector<torch::lazy::BackendDataPtr> parameters_data,
+      PendingComputation pending_computation, bool is_sharded,
+      const std::vector<torch::lazy::BackendDataPtr>& tensor_data_vec);
 
   // Override to enable profiler.
   PostOrderData RunPostOrder(const std::vector<torch::lazy::Value>& ir_values,
@@ -345,20 +438,64 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
       const std::vector<torch::lazy::BackendDataPtr>& tensor_data_vec,
       bool warm_up_cache_only);
 
-  std::vector<size_t> SetBufferDonors(const std::vector<XLATensorPtr>& tensors,
-                                      absl::Span<const size_t> indices,
-                                      LoweringContext* lowering_ctx);
+  // Returns the indices of the parameters whose buffers the computation of
+  // the graph takes as donors.
+  std::vector<size_t> GetBufferDonorIndices(
+      const std::vector<XLATensorPtr>& tensors,
+      const SyncTensorCollection& coll,
+      const std::vector<torch::lazy::BackendDataPtr>& parameters_data);
 
-  std::vector<size_t> SetBufferDonorsFromUserConfig(
-      LoweringContext* lowering_ctx);
+  // Lowers the IR graph rooted at ir_values into an XLA computation, and
+  // prepares the instance to be passed to the ComputationClient Compile() API.
+  LoweringResult LowerForCompile(
+      std::vector<XLATensorPtr>& tensors, absl::Span<const std::string> devices,
+      const SyncTensorCollection& coll, PostOrderData* po_data,
+      const std::vector<torch::lazy::Value>& ir_values);
 
   // TODO(yeounoh) auto-sharding can change tensors shardings, which needs to be
   // accounted for in Dynamo integration.
+  // If retain_recipe is set, the result carries a CompileRecipe of the graph.
   CompilationResult Compile(std::vector<XLATensorPtr>& tensors,
                             absl::Span<const std::string> devices,
                             const SyncTensorCollection& coll,
                             PostOrderData* po_data,
-                            const std::vector<torch::lazy::Value>& ir_values);
+                            const std::vector<torch::lazy::Value>& ir_values,
+                            bool retain_recipe = false);
+
+  // Same as Compile(), but hands the compilation to the background compile
+  // pool and returns without waiting for it. Concurrent requests for the same
+  // graph hash and buffer donors share a single compilation, and only the
+  // first one lowers the graph.
+  PendingCompile CompileAsync(
+      std::vector<XLATensorPtr>& tensors, absl::Span<const std::string> devices,
+      const SyncTensorCollection& coll, PostOrderData* po_data,
+      const std::vector<torch::lazy::Value>& ir_values,
+      bool retain_recipe = false);
+
+  // Returns the in-flight background compilation for hash, if any.
+  std::optional<PendingComputation> LookupPendingCompile(
+      const torch::lazy::hash_t& hash);
+
+  // Same as above, but only returns a compilation whose computation takes the
+  // given parameters as buffer donors.
+  std::optional<PendingCompile> LookupPendingCompile(
+      const torch::lazy::hash_t& hash,
+      const std::vector<size_t>& buffer_donor_indices);
+
+  // Records the eviction of a computation from the computation cache, keeping
+  // its CompileRecipe around if it has one.
+  void OnComputationEvicted(const torch::lazy::hash_t& hash,
+                            const ComputationCache::TypePtr& computation);
+
+  // Compiles again a graph evicted from the computation cache, if its
+  // CompileRecipe has been retained. Concurrent callers share the same
+  // compilation. Returns nullptr if the graph cannot be compiled again.
+  ComputationCache::TypePtr RecompileEvictedComputation(
+      const torch::lazy::hash_t& hash);
+
+  // Drops the in-flight compilation of hash with the given buffer donors.
+  void ErasePendingCompile(const torch::lazy::hash_t& hash,
+                           const std::vector<size_t>& buffer_donor_indices);
 
   // We don't use the upstream SyncTensorsGraphInternal since
   // our CachedComputation is different from upstream.
@@ -367,7 +504,16 @@ class XLAGraphExecutor : public torch::lazy::LazyGraphExecutor {
       const SyncTensorsConfig& config, bool warm_up_cache_only = false);
 
   ComputationCache* computation_cache_;
+  // Whether graphs compiled to warm up the cache keep their CompileRecipe.
+  bool retain_compile_recipes_ = false;
   bool use_eager_mode_ = false;
+  // Background compilations which have not been added to the computation
+  // cache yet, keyed by graph hash. The same graph can be in flight with
+  // different buffer donors, as those depend on the sync which lowered it.
+  std::mutex pending_compiles_lock_;
+  std::unordered_map<torch::lazy::hash_t, std::vector<PendingCompile>,
+                     torch::lazy::HashReducer>
+      pending_compiles_;
 };
 
 }  // namespace torch_xla
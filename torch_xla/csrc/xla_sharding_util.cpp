@@ -1,6 +1,7 @@
 #include "torch_xla/csrc/xla_sharding_util.h"
 
 #include <ATen/TensorIndexing.h>
+#include <c10/util/accumulate.h>
 
 #include <cmath>
 #include <unordered_map>
@@ -15,6 +16,8 @@
 #include "torch_xla/csrc/ops/device_data.h"
 #include "torch_xla/csrc/runtime/computation_client.h"
 #include "torch_xla/csrc/runtime/runtime.h"
+#include "torch_xla/csrc/runtime/staging_buffer_pool.h"
+#include "torch_xla/csrc/runtime/tensor_source.h"
 #include "torch_xla/csrc/tensor.h"
 #include "torch_xla/csrc/tensor_methods.h"
 #include "torch_xla/csrc/tensor_util.h"
@@ -96,6 +99,147 @@ std::unordered_map<int, int> build_index_map(
   return device_index;
 }
 
+// Allocates a contiguous CPU tensor. Staged tensors are backed by a buffer of
+// the StagingBufferPool, which goes back to the pool once the tensor is freed.
+at::Tensor AllocateShard(at::IntArrayRef sizes, at::ScalarType dtype,
+                         bool staged) {
+  at::TensorOptions options = at::TensorOptions().device(at::kCPU).dtype(dtype);
+  size_t size = c10::multiply_integers(sizes) * c10::elementSize(dtype);
+  if (!staged || size == 0) {
+    return at::empty(sizes, options);
+  }
+  std::shared_ptr<void> buffer =
+      runtime::StagingBufferPool::Get()->Allocate(size);
+  void* ptr = buffer.get();
+  return at::from_blob(
+      ptr, sizes,
+      [buffer = std::move(buffer)](void*) mutable { buffer.reset(); },
+      options);
+}
+
+// Copies `slice` into the leading corner of `shard`, converting its type on
+// the way, and zeroes the rest of `shard`, which is the right padding.
+void FillShard(const at::Tensor& slice, const at::Tensor& shard) {
+  XLA_CHECK_EQ(slice.dim(), shard.dim());
+  at::Tensor corner = shard;
+  for (int64_t dim = 0; dim < slice.dim(); ++dim) {
+    XLA_CHECK_LE(slice.size(dim), shard.size(dim));
+    corner = corner.narrow(dim, 0, slice.size(dim));
+  }
+  corner.copy_(slice);
+  for (int64_t dim = 0; dim < slice.dim(); ++dim) {
+    int64_t pad = shard.size(dim) - slice.size(dim);
+    if (pad > 0) {
+      shard.narrow(dim, slice.size(dim), pad).zero_();
+    }
+  }
+}
+
+// Shards `tensor` into new tensors of type `dtype`. Each shard is written in a
+// single pass from a view of its slice of `tensor`, padding included, and the
+// shards are written in parallel. Replicated shards share a single copy.
+std::vector<at::Tensor> ShardTensorInto(
+    const at::Tensor& tensor, const XLATensor::ShardingSpecPtr& shardings,
+    const std::vector<std::string>& devices, bool padded,
+    at::ScalarType dtype, bool staged) {
+  xla::OpSharding sharding;
+  bool minibatch = false;
+  if (shardings != nullptr) {
+    sharding = shardings->sharding;
+    minibatch = shardings->minibatch;
+  }
+  TF_VLOG(5) << "ShardTensor with sharding type(" << sharding.type()
+             << ")... and minibatch = " << minibatch << std::endl;
+  std::vector<at::Tensor> shards(devices.size());
+  if (shardings == nullptr || sharding.type() == xla::OpSharding::REPLICATED ||
+      sharding.type() == xla::OpSharding::UNKNOWN) {
+    at::Tensor replica = tensor;
+    if (staged || dtype != tensor.scalar_type()) {
+      replica = AllocateShard(tensor.sizes(), dtype, staged);
+      replica.copy_(tensor);
+    }
+    // Every device reads the same replica. Buffers aliasing it are never
+    // donated, so no device can write into the others' data.
+    std::fill_n(shards.begin(), shards.size(), replica);
+  } else if (sharding.type() == xla::OpSharding::OTHER) {
+    std::vector<int64_t> shard_shape = ShardingUtil::GetShardShape(shardings);
+    XLA_CHECK_GE(tensor.dim(), shard_shape.size());
+
+    std::vector<std::vector<at::indexing::TensorIndex>> shard_indices;
+    if (minibatch) {
+      shard_indices =
+          ShardingUtil::GetShardIndicesForMinibatchTensor(shard_shape, devices);
+    } else {
+      auto replica_and_indices =
+          ShardingUtil::GetShardReplicaAndIndicesForDevices(
+              shard_shape, tensor.sizes().vec(), sharding, devices);
+      // Extract only the indices, the replica_id is unnecessary for sharding.
+      std::transform(replica_and_indices.begin(), replica_and_indices.end(),
+                     std::back_inserter(shard_indices),
+                     [](auto& pair) { return pair.second; });
+    }
+
+    absl::BlockingCounter counter(shard_indices.size());
+    for (size_t i = 0; i < shard_indices.size(); ++i) {
+      auto shard_fn = [&, i]() {
+        // Indexing with slices only creates a view of `tensor`.
+        at::Tensor slice = tensor.index(
+            c10::ArrayRef<at::indexing::TensorIndex>(shard_indices[i]));
+        // Dimensions beyond the tiled ones are copied whole.
+        std::vector<int64_t> sizes = slice.sizes().vec();
+        if (padded) {
+          std::copy(shard_shape.begin(), shard_shape.end(), sizes.begin());
+        }
+        shards[i] = AllocateShard(sizes, dtype, staged);
+        FillShard(slice, shards[i]);
+        counter.DecrementCount();
+      };
+      thread::Schedule(std::move(shard_fn));
+    }
+    counter.Wait();
+  } else {
+    XLA_CHECK(false) << "Unsupported OpSharding type " << sharding.type();
+  }
+  return shards;
+}
+
+// Transfers the shards to the devices. See ShardingUtil::CreateShardedData.
+runtime::ComputationClient::DataPtr TransferShards(
+    const std::vector<at::Tensor>& local_shards,
+    const std::vector<std::string>& devices,
+    const XLATensor::ShardingSpecPtr& sharding_spec, bool staged) {
+  XLA_CHECK(local_shards.size() == devices.size())
+      << "A device must be speficied for each shard";
+  std::vector<std::shared_ptr<const runtime::TensorSource>> source_tensors;
+  xla::Shape global_shape;
+  xla::OpSharding sharding;
+  if (sharding_spec == nullptr) {
+    // Unknown type is used to mark implicitly replicated data for
+    // auto-sharding.
+    // TODO(yeounoh) see if we can completely rely on Unknown without inference
+    // performance degradation.
+    sharding = ShardingUtil::GetAutoSharding()
+                   ? xla::HloSharding::Unknown().ToProto()
+                   : xla::HloSharding::Replicate().ToProto();
+    // if replicated, global_shape is shape of the tensor.
+    auto first_device = ParseDeviceString(devices[0]);
+    global_shape =
+        CreateComputationShapeFromTensor(local_shards[0], &first_device);
+  } else {
+    global_shape = sharding_spec->shape;
+    sharding = sharding_spec->sharding;
+  }
+  for (int64_t j = 0; j < devices.size(); ++j) {
+    auto shard_device = ParseDeviceString(devices[j]);
+    auto shard_shape =
+        CreateComputationShapeFromTensor(local_shards[j], &shard_device);
+    source_tensors.push_back(std::make_shared<runtime::AtenSource>(
+        local_shards[j], shard_shape, devices[j], staged));
+  }
+  return runtime::GetComputationClient()->TransferShardsToDevice(
+      source_tensors, GetVirtualDevice().toString(), global_shape, sharding);
+}
+
 xla::Array<int64_t> TileListToArray(const py::list& tile_assignment) {
   auto dims = TileAssignmentDimensions(tile_assignment);
   xla::Array<int64_t> tile_array(dims);
@@ -436,61 +580,23 @@ ShardingUtil::GetShardReplicaAndIndicesForDevices(
 std::vector<at::Tensor> ShardingUtil::ShardTensor(
     const at::Tensor& tensor, const XLATensor::ShardingSpecPtr shardings,
     const std::vector<std::string>& devices, bool padded) {
-  xla::OpSharding sharding;
-  bool minibatch = false;
-  if (shardings != nullptr) {
-    sharding = shardings->sharding;
-    minibatch = shardings->minibatch;
-  }
-  TF_VLOG(5) << "ShardTensor with sharding type(" << sharding.type()
-             << ")... and minibatch = " << minibatch << std::endl;
-  auto device_index = build_index_map(devices);
-  std::vector<at::Tensor> shards(devices.size());
-  if (shardings == nullptr || sharding.type() == xla::OpSharding::REPLICATED ||
-      sharding.type() == xla::OpSharding::UNKNOWN) {
-    std::fill_n(shards.begin(), shards.size(), tensor);
-  } else if (sharding.type() == xla::OpSharding::OTHER) {
-    XLA_CHECK(sharding.tile_shape().dimensions_size() <= 2);
-    XLA_CHECK(tensor.sizes().size() >= sharding.tile_shape().dimensions_size());
-
-    auto shard_shape = GetShardShape(shardings);
-
-    std::vector<std::vector<at::indexing::TensorIndex>> shard_indices;
-    if (minibatch) {
-      shard_indices = GetShardIndicesForMinibatchTensor(shard_shape, devices);
-    } else {
-      auto replica_and_indices = GetShardReplicaAndIndicesForDevices(
-          shard_shape, tensor.sizes().vec(), sharding, devices);
-      // Extract only the indices, the replica_id is unnecessary for sharding.
-      std::transform(replica_and_indices.begin(), replica_and_indices.end(),
-                     std::back_inserter(shard_indices),
-                     [](auto& pair) { return pair.second; });
-    }
+  return ShardTensorInto(tensor, shardings, devices, padded,
+                         tensor.scalar_type(), /*staged=*/false);
+}
 
-    for (size_t i = 0; i < shard_indices.size(); i++) {
-      at::Tensor shard = tensor.index(
-          c10::ArrayRef<at::indexing::TensorIndex>(shard_indices[i]));
-      shards[i] = shard.contiguous(at::MemoryFormat::Contiguous);
-    }
-    // Zero-pad to the right to ensure the sizes are even
-    if (shards.size() > 0 && padded) {
-      for (size_t i = 0; i < shards.size(); ++i) {
-        std::vector<long> pads;
-        for (size_t j = 0; j < shard_shape.size(); ++j) {
-          XLA_CHECK_GE(shard_shape[j], shards[i].sizes().at(j));
-          pads.push_back(shard_shape[j] - shards[i].sizes().at(j));
-          pads.push_back(0);  // no padding on lhs
-        }
-        // Padding starts from the last dimension
-        std::reverse(pads.begin(), pads.end());
-        shards[i] = at::constant_pad_nd(
-            shards[i], c10::IntArrayRef(pads.data(), pads.size()), 0);
-      }
-    }
-  } else {
-    XLA_CHECK(false) << "Unsupported OpSharding type " << sharding.type();
-  }
-  return shards;
+runtime::ComputationClient::DataPtr ShardingUtil::ShardAndTransferTensor(
+    const at::Tensor& tensor, const XLATensor::ShardingSpecPtr& sharding_spec,
+    const std::vector<std::string>& devices) {
+  tsl::profiler::TraceMe activity("ShardAndTransferTensor",
+                                  tsl::profiler::TraceMeLevel::kInfo);
+  XLA_CHECK(!devices.empty());
+  torch::lazy::BackendDevice first_device = ParseDeviceString(devices[0]);
+  at::ScalarType dtype = TorchTypeFromXlaType(
+      CreateComputationShapeFromTensor(tensor, &first_device).element_type());
+  std::vector<at::Tensor> local_shards =
+      ShardTensorInto(tensor, sharding_spec, devices, /*padded=*/true, dtype,
+                      /*staged=*/true);
+  return TransferShards(local_shards, devices, sharding_spec, /*staged=*/true);
 }
 
 std::vector<XLATensor::ShardingSpecPtr> ShardingUtil::GetOutputSharding(
@@ -596,36 +702,8 @@ runtime::ComputationClient::DataPtr ShardingUtil::CreateShardedData(
     const std::vector<at::Tensor>& local_shards,
     const std::vector<std::string>& devices,
     const XLATensor::ShardingSpecPtr& sharding_spec) {
-  XLA_CHECK(local_shards.size() == devices.size())
-      << "A device must be speficied for each shard";
-  std::vector<std::shared_ptr<const runtime::TensorSource>> source_tensors;
-  xla::Shape global_shape;
-  xla::OpSharding sharding;
-  if (sharding_spec == nullptr) {
-    // Unknown type is used to mark implicitly replicated data for
-    // auto-sharding.
-    // TODO(yeounoh) see if we can completely rely on Unknown without inference
-    // performance degradation.
-    sharding = ShardingUtil::GetAutoSharding()
-                   ? xla::HloSharding::Unknown().ToProto()
-                   : xla::HloSharding::Replicate().ToProto();
-    // if replicated, global_shape is shape of the tensor.
-    auto first_device = ParseDeviceString(devices[0]);
-    global_shape =
-        CreateComputationShapeFromTensor(local_shards[0], &first_device);
-  } else {
-    global_shape = sharding_spec->shape;
-    sharding = sharding_spec->sharding;
-  }
-  for (int64_t j = 0; j < devices.size(); ++j) {
-    auto shard_device = ParseDeviceString(devices[j]);
-    auto shard_shape =
-        CreateComputationShapeFromTensor(local_shards[j], &shard_device);
-    source_tensors.push_back(std::make_shared<runtime::AtenSource>(
-        local_shards[j], shard_shape, devices[j]));
-  }
-  return runtime::GetComputationClient()->TransferShardsToDevice(
-      source_tensors, GetVirtualDevice().toString(), global_shape, sharding);
+  return TransferShards(local_shards, devices, sharding_spec,
+                        /*staged=*/false);
 }
 
 std::vector<int64_t> ShardingUtil::GetAutoShardingMesh() {
@@ -83,13 +83,21 @@ class ShardingUtil {
   // the `tile_assignment`; the returned tensor shards vector is
   // indexed by the device IDs. There is no data duplication. Shards are not
   // padded in case the input tensor is not evenly partitionable, unless
-  // `padded` is set. The the returned tensors will be in 1:1 correspondence
+  // `padded` is set. Tiled shards are new contiguous tensors, written in
+  // parallel. The the returned tensors will be in 1:1 correspondence
   // with the `devices` vector, so the `i`th result will belong on the `i`th
   // device.
   static std::vector<at::Tensor> ShardTensor(
       const at::Tensor& tensor, const XLATensor::ShardingSpecPtr shardings,
       const std::vector<std::string>& devices, bool padded = true);
 
+  // Equivalent to CreateShardedData(ShardTensor(tensor, sharding_spec,
+  // devices), devices, sharding_spec), but each shard is written once on the
+  // host, straight from `tensor` into a staging buffer of the device type.
+  static runtime::ComputationClient::DataPtr ShardAndTransferTensor(
+      const at::Tensor& tensor, const XLATensor::ShardingSpecPtr& sharding_spec,
+      const std::vector<std::string>& devices);
+
   // Retrieve output sharding of a given XLA computation. ShardingSpec::shape
   // is always on virtual SPMD device.
   static std::vector<XLATensor::ShardingSpecPtr> GetOutputSharding(
@@ -46,6 +46,24 @@ def metric_data(name):
   return torch_xla._XLAC._xla_metric_data(name)
 
 
+def metric_lifetime_percentiles(name, quantiles):
+  """Returns the percentiles of all the samples ever posted to a metric.
+
+  Unlike the samples returned by `metric_data()`, which only cover the latest
+  samples, these come from a bounded memory histogram of all of them, with a 1%
+  relative error by default (`XLA_METRICS_HISTOGRAM_ACCURACY`).
+
+  Args:
+    name (string): The name of the metric.
+    quantiles (list): The quantiles to compute, in [0, 1].
+
+  Returns:
+    A tuple with the value at each quantile, or `None` if the metric does not
+    exist or does not track a lifetime histogram.
+  """
+  return torch_xla._XLAC._xla_metric_lifetime_percentiles(name, quantiles)
+
+
 def clear_metrics():
   """Clear the value of all metrics.
   """
@@ -64,6 +82,15 @@ def metrics_report():
   return torch_xla._XLAC._xla_metrics_report()
 
 
+def openmetrics_report():
+  """Retrieves the runtime metrics and counters in the OpenMetrics text format.
+
+  Setting `XLA_METRICS_EXPORT_FILE` instead writes this report to a file
+  periodically, without any call from the training code.
+  """
+  return torch_xla._XLAC._xla_openmetrics_report()
+
+
 def short_metrics_report(counter_names: list = None, metric_names: list = None):
   """Retrieves a string containing the full metrics and counters report.
 
@@ -81,6 +108,38 @@ def short_metrics_report(counter_names: list = None, metric_names: list = None):
   return torch_xla._XLAC._short_xla_metrics_report(counter_names, metric_names)
 
 
+def step_timeline():
+  """Returns the records of the latest graph executions, oldest first.
+
+  Each record is a dictionary with the `step_id`, `device`, `graph_hash`,
+  `node_count`, `parameter_count`, `parameter_bytes` and `cache_hit` of the
+  execution, its `start_ns` and `end_ns`, and `phases`, which maps the name of
+  each phase the execution went through (like `CollectSyncTensors`,
+  `TensorCollectionBarrier` or `ExecuteComputation`) to its (START_NS, END_NS).
+  A phase entered more than once, like `TensorCollectionBarrier`, spans from
+  its first start to its last end, and `phase_durations_ns` maps each phase to
+  the time actually spent in it.
+  The number of records retained is set by `XLA_STEP_TIMELINE_SIZE`.
+  """
+  return torch_xla._XLAC._xla_step_timeline()
+
+
+def save_step_timeline(path):
+  """Writes the step timeline to a Chrome trace JSON file.
+
+  Args:
+    path (string): The file to write, to be opened with chrome://tracing or
+      Perfetto.
+  """
+  with open(path, 'w') as f:
+    f.write(torch_xla._XLAC._xla_step_timeline_chrome_trace())
+
+
+def clear_step_timeline():
+  """Drops the records of the step timeline."""
+  return torch_xla._XLAC._clear_xla_step_timeline()
+
+
 def executed_fallback_ops():
   """Retrieves a list of operations that were run in fallback mode."""
   return torch_xla._XLAC._get_executed_fallback_ops()
@@ -279,13 +279,17 @@ def get_master_ip() -> str:
 
 
 @requires_pjrt
-def initialize_cache(path: str, readonly: bool = False):
+def initialize_cache(path: str,
+                     readonly: bool = False,
+                     max_size_bytes: Optional[int] = None):
   """Initializes the persistent compilation cache. This API must be called
   before any computations have been performed.
 
   Args:
     path: The path at which to store the persistent cache.
     readonly: Whether or not this worker should have write access to the cache.
+    max_size_bytes: If set, the least recently used entries are evicted once
+      the cache on disk exceeds this size.
   """
   assert not torch_xla._XLAC._xla_computation_cache_is_initialized(
   ), "Computation cache has already been initialized"
@@ -294,3 +298,5 @@ def initialize_cache(path: str, readonly: bool = False):
   # the cache.
   os.environ['XLA_PERSISTENT_CACHE_PATH'] = path
   os.environ['XLA_PERSISTENT_CACHE_READ_ONLY'] = '1' if readonly else '0'
+  if max_size_bytes is not None:
+    os.environ['XLA_PERSISTENT_CACHE_MAX_BYTES'] = str(max_size_bytes)
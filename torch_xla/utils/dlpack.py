@@ -1,4 +1,4 @@
-from typing import Any
+from typing import Any, List, Optional, Tuple
 import enum
 from torch.utils.dlpack import DLDeviceType
 import torch
@@ -6,23 +6,74 @@ import torch_xla
 import torch_xla.utils.utils as xu
 
 
-def to_dlpack(xla_tensor: Any):
+def to_dlpack(xla_tensor: Any, stream: Optional[int] = None):
+  """Exports an XLA tensor as a DLPack capsule.
+
+  The call blocks until the tensor is ready, so only the default `stream` of
+  None is supported. Use `to_dlpack_async()` to export without waiting for the
+  device, which also returns the event to synchronize on.
+  """
+  if stream is not None:
+    raise ValueError(
+        f'Unsupported stream {stream}, use to_dlpack_async() to export without '
+        'waiting for the device')
   return torch_xla._XLAC._to_dlpack(xla_tensor)
 
 
-def from_dlpack(ext_tensor: Any):
+def to_dlpack_batch(xla_tensors: List[Any]) -> List[Any]:
+  """Exports several XLA tensors as DLPack capsules, waiting for them once."""
+  return torch_xla._XLAC._to_dlpack_batch(xla_tensors)
+
+
+def to_dlpack_async(xla_tensors: List[Any]) -> Tuple[List[Any], Any]:
+  """Exports several XLA tensors without waiting for the device.
+
+  Returns the capsules and an event, with `done()` and `wait()` methods, which
+  becomes ready once all the exported buffers hold their values. The capsules
+  can be handed out right away, but their memory must not be read before the
+  event is ready.
+  """
+  return torch_xla._XLAC._to_dlpack_async(xla_tensors)
+
+
+def _to_capsule(ext_tensor: Any):
   if hasattr(ext_tensor, '__dlpack_device__') and hasattr(
       ext_tensor, '__dlpack__'):
     device_type, device_id = ext_tensor.__dlpack_device__()
     if device_type == DLDeviceType.kDLGPU:
       stream = torch_xla._XLAC._get_stream_for_cuda_device(device_id)
-      dlpack = ext_tensor.__dlpack__(stream=stream)
-    else:
-      dlpack = ext_tensor.__dlpack__()
-  else:
-    dlpack = ext_tensor
+      return ext_tensor.__dlpack__(stream=stream)
+    return ext_tensor.__dlpack__()
+  return ext_tensor
+
+
+def from_dlpack(ext_tensor: Any):
+  return torch_xla._XLAC._from_dlpack(_to_capsule(ext_tensor))
+
+
+def to_dlpack_shards(xla_tensor: Any) -> Tuple[List[Any], Any, List[int]]:
+  """Exports the local shards of a sharded XLA tensor without gathering them.
+
+  Returns the DLPack capsules of the shards, ordered as the addressable
+  devices, the `OpSharding` of the tensor and its global shape, which
+  `from_dlpack_shards` takes back. The shards include any padding added to
+  make them all the same shape.
+  """
+  shards = torch_xla._XLAC._to_dlpack_shards(xla_tensor)
+  sharding = torch_xla._XLAC._get_xla_op_sharding(xla_tensor)
+  return shards, sharding, list(xla_tensor.shape)
+
+
+def from_dlpack_shards(ext_shards: List[Any], sharding: Any,
+                       global_shape: List[int]):
+  """Creates a sharded XLA tensor viewing the memory of its local shards.
 
-  return torch_xla._XLAC._from_dlpack(dlpack)
+  The shards, capsules or objects implementing `__dlpack__`, must be ordered
+  as the addressable devices and live on them.
+  """
+  capsules = [_to_capsule(shard) for shard in ext_shards]
+  return torch_xla._XLAC._from_dlpack_shards(capsules, sharding,
+                                             list(global_shape))
 
 
 def from_xla_cuda_to_cuda(tensor):